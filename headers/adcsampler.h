@@ -0,0 +1,41 @@
+#ifndef ADCSAMPLER_H_
+#define ADCSAMPLER_H_
+
+#include <cstdint>
+
+// GPIO 26-29 are ADC inputs 0-3
+#define ADC_SAMPLER_FIRST_PIN 26
+#define ADC_SAMPLER_CHANNELS 4
+
+// Samples kept per enabled input, bounds how many can be averaged
+#define ADC_SAMPLER_DEPTH 16
+
+// Conversions per second across all enabled inputs in free-running mode
+#ifndef ADC_SAMPLER_SAMPLE_HZ
+#define ADC_SAMPLER_SAMPLE_HZ 100000
+#endif
+
+namespace AdcSampler {
+    // Registers an ADC input for free-running sampling, add-ons call this from setup()
+    void enableChannel(uint8_t channel);
+
+    // Starts round-robin sampling of the registered inputs into a DMA ring when enabled,
+    // must run after every add-on has been set up. averageSamples is clamped to ADC_SAMPLER_DEPTH / 2
+    void setup(bool enabled, uint32_t averageSamples);
+
+    // Returns true while the ADC is free running, adc_select_input() and adc_read() must not be used then
+    bool isActive();
+
+    // Inputs registered by the add-ons, one bit per ADC input
+    uint8_t getChannelMask();
+
+    // Returns the mean of the newest samples of the input without blocking while active,
+    // falls back to a blocking select and read otherwise
+    uint16_t read(uint8_t channel);
+
+    // Same as read() with an explicit sample count, clamped to ADC_SAMPLER_DEPTH / 2. Blocking reads
+    // take one conversion per sample when the sampler is not active
+    uint16_t read(uint8_t channel, uint32_t samples);
+}
+
+#endif
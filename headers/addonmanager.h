@@ -6,25 +6,69 @@
 #include <vector>
 #include <pico/mutex.h>
 
+#define ADDON_PROFILE_MAX 24
+#define ADDON_PROFILE_NAME_LENGTH 24
+#define ADDON_SCHEDULE_MAX_IDLE_MICRO 10000
+
 enum ADDON_PROCESS {
     CORE0_INPUT,
     CORE0_USBREPORT,
     CORE1_LOOP
 };
 
+// Cycle cost of one add-on pass, measured with the SysTick counter of the core running it
+struct AddonProfile {
+    uint32_t calls;
+    uint32_t worstCycles;
+    uint64_t totalCycles;
+};
+
+struct AddonProfileEntry {
+    char name[ADDON_PROFILE_NAME_LENGTH];
+    ADDON_PROCESS processType;
+    AddonProfile preprocess;
+    AddonProfile process;
+    uint32_t overruns;          // Scheduled runs that took longer than their budget
+    uint32_t deadlineMisses;    // Scheduled runs that finished after their deadline
+};
+
+struct AddonProfileTable {
+    uint32_t magic;
+    uint32_t clockHz;
+    uint32_t count;
+    AddonProfileEntry entries[ADDON_PROFILE_MAX];
+};
+
+// Timing an add-on declares for ScheduleAddons
+struct AddonSchedule {
+    uint32_t periodMicros = GAMEPAD_POLL_MICRO;
+    uint32_t budgetMicros = 0;      // Worst case cost, 0 leaves it unchecked
+    bool background = false;        // Only runs when no other add-on is due
+};
+
 struct AddonBlock {
     GPAddon * ptr;
     ADDON_PROCESS process;
+    AddonSchedule schedule;
+    uint64_t releaseTime;           // Earliest time the add-on runs again under ScheduleAddons
+    AddonProfileEntry * profile;    // nullptr when profiling is disabled
 };
 
 class AddonManager {
 public:
     AddonManager() {}
     ~AddonManager() {}
-    void LoadAddon(GPAddon*, ADDON_PROCESS);
+    void LoadAddon(GPAddon*, ADDON_PROCESS, const AddonSchedule & = AddonSchedule());
     void PreprocessAddons(ADDON_PROCESS);
     void ProcessAddons(ADDON_PROCESS);
+    // Runs the due add-on with the earliest deadline, returns when the next one is due
+    uint64_t ScheduleAddons(ADDON_PROCESS);
     GPAddon * GetAddon(std::string); // hack for NeoPicoLED
+
+    // Resets the shared profile table, must run before any add-on is loaded on either core
+    static void EnableProfiling();
+    // Profiles of the last gamepad session, survives a watchdog reboot into webconfig
+    static const AddonProfileTable * GetProfiles();
 private:
     std::vector<AddonBlock*> addons;    // addons currently loaded
 };
@@ -8,6 +8,7 @@
 #include "BoardConfig.h"
 
 #include "enums.pb.h"
+#include "config.pb.h"
 
 #ifndef ANALOG_INPUT_ENABLED
 #define ANALOG_INPUT_ENABLED 0
@@ -57,6 +58,43 @@
 #define AUTO_CALIBRATE_ENABLED 0
 #endif
 
+#ifndef RADIAL_DEADZONE_ENABLED
+#define RADIAL_DEADZONE_ENABLED 0
+#endif
+
+#ifndef ANALOG_ADC_1_FILTER
+#define ANALOG_ADC_1_FILTER ANALOG_FILTER_NONE
+#endif
+
+#ifndef ANALOG_ADC_2_FILTER
+#define ANALOG_ADC_2_FILTER ANALOG_FILTER_NONE
+#endif
+
+// Readings averaged by the oversampling filter, at most ADC_SAMPLER_DEPTH / 2
+#ifndef ANALOG_FILTER_SAMPLES
+#define ANALOG_FILTER_SAMPLES 4
+#endif
+
+// Weight of a new reading in percent for the moving average filter
+#ifndef ANALOG_FILTER_EMA_ALPHA
+#define ANALOG_FILTER_EMA_ALPHA 25
+#endif
+
+// One-euro filter cutoff at rest in tenths of a Hz
+#ifndef ANALOG_FILTER_MIN_CUTOFF
+#define ANALOG_FILTER_MIN_CUTOFF 50
+#endif
+
+// One-euro filter cutoff increase in mHz per full stick throw per second
+#ifndef ANALOG_FILTER_BETA
+#define ANALOG_FILTER_BETA 5000
+#endif
+
+// Smallest raw span accepted on each side of the center, rejects axes left untouched while calibrating
+#ifndef ANALOG_CALIBRATION_MIN_SPAN
+#define ANALOG_CALIBRATION_MIN_SPAN 512
+#endif
+
 // Analog Module Name
 #define AnalogName "Analog"
 
@@ -68,14 +106,47 @@ public:
 	virtual void preprocess() {}
     virtual std::string name() { return AnalogName; }
 private:
-	uint16_t adc_1_x_center = 0;
-	uint16_t adc_1_y_center = 0;
-	uint16_t adc_2_x_center = 0;
-	uint16_t adc_2_y_center = 0;
-
-	static float readPin(int pin, uint16_t center, bool autoCalibrate, float deadzone);
-	static uint16_t map(uint16_t x, uint16_t in_min, uint16_t in_max, uint16_t out_min, uint16_t out_max);
-	void adjustCircularity(float& x, float& y);
+	struct AnalogAxis {
+		int8_t channel;         // ADC input, -1 when no pin is assigned
+		bool invert;
+		bool calibrated;
+		uint16_t min;           // Raw ADC readings at both ends of the throw and at rest
+		uint16_t center;
+		uint16_t max;
+		uint32_t scaleLow;      // Q16 factors stretching each side of the center onto half of the ADC range
+		uint32_t scaleHigh;
+		uint16_t seenMin;       // Extremes recorded while calibration mode is on
+		uint16_t seenCenter;
+		uint16_t seenMax;
+		AnalogFilter filter;
+		bool primed;            // Filter state holds a reading
+		int32_t filtered;       // Filter output in 16-bit units with ANALOG_FILTER_FRACTION_BITS extra bits
+		int32_t speed;          // One-euro filtered rate of change in thousandths of a full throw per second
+	};
+
+	void setupAxis(AnalogAxis & axis, int32_t pin, bool invert, bool autoCalibrate, const AnalogCalibration & calibration, AnalogFilter filter);
+	static void calibrateAxis(AnalogAxis & axis, uint16_t min, uint16_t center, uint16_t max);
+	uint16_t readAxis(const AnalogAxis & axis) const;
+	uint16_t filterAxis(AnalogAxis & axis, uint16_t value, uint32_t elapsedMicros) const;
+	void applyDeadzone(uint16_t & x, uint16_t & y) const;
+	static void adjustCircularity(uint16_t & x, uint16_t & y);
+
+	static void startCalibration(AnalogAxis & axis);
+	static void recordCalibration(AnalogAxis & axis);
+	static bool finishCalibration(AnalogAxis & axis, AnalogCalibration & calibration);
+
+	AnalogAxis adc1X;
+	AnalogAxis adc1Y;
+	AnalogAxis adc2X;
+	AnalogAxis adc2Y;
+	uint32_t deadzone = 0;      // Distance from center in 16-bit output units
+	bool radialDeadzone = false;
+	bool calibrating = false;
+	uint32_t filterSamples = 1;
+	uint32_t emaAlpha = 0;          // Q8 weight of a new reading
+	uint32_t minCutoff = 0;         // mHz
+	uint32_t beta = 0;              // mHz per full throw per second
+	uint64_t lastFilterMicros = 0;
 };
 
 #endif  // _Analog_H_
\ No newline at end of file
@@ -16,6 +16,10 @@
 // BoardLed Module Name
 #define OnBoardLedName "OnBoardLed"
 
+// Core1 schedule (microseconds)
+#define BOARD_LED_PERIOD_MICRO 1000
+#define BOARD_LED_BUDGET_MICRO 100
+
 #define BOARD_LED_PIN 25
 #define BLINK_INTERVAL_USB_UNMOUNTED 200
 #define BLINK_INTERVAL_CONFIG_MODE 1000
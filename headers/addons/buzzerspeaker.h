@@ -20,6 +20,10 @@
 // Buzzer Speaker Module
 #define BuzzerSpeakerName "BuzzerSpeaker"
 
+// Core1 schedule (microseconds), one tick per note step
+#define BUZZER_PERIOD_MICRO 1000
+#define BUZZER_BUDGET_MICRO 100
+
 enum Tone {
 	B0 = 31,
 	C1 = 33,
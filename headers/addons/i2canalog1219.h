@@ -31,11 +31,17 @@
 #define I2C_ANALOG1219_ADDRESS 0x40
 #endif
 
+// ADS1219 DRDY output, -1 polls the STATUS register over I2C instead. With it set conversions
+// are read through the I2C transaction queue, which other devices on the block share
+#ifndef I2C_ANALOG1219_DRDY_PIN
+#define I2C_ANALOG1219_DRDY_PIN -1
+#endif
+
 // Analog Module Name
 #define I2CAnalog1219Name "I2CAnalog"
 
 typedef struct {
-	float A[4];
+	uint16_t A[4];
 } ADS_PINS;
 
 class I2CAnalog1219Input : public GPAddon {
@@ -46,8 +52,11 @@ public:
 	virtual void process();     // Analog Process
     virtual std::string name() { return I2CAnalog1219Name; }
 private:
+    void setupDataReady(i2c_inst_t * block, int32_t drdyPin, uint8_t address);
+
     ADS1219 * ads;
 	ADS_PINS pins;
+	bool dataReady;             // Conversions are read from the DRDY interrupt
 	int channelHop;
 	uint32_t uIntervalMS;       // ADS1219 Interval
 	uint32_t nextTimer;         // Turbo Timer
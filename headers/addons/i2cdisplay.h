@@ -133,6 +133,10 @@
 // i2c Display Module
 #define I2CDisplayName "I2CDisplay"
 
+// Core1 schedule (microseconds), a full 128x64 redraw at I2C_SPEED fits the budget
+#define I2C_DISPLAY_PERIOD_MICRO 33333
+#define I2C_DISPLAY_BUDGET_MICRO 20000
+
 // i2C OLED Display
 class I2CDisplayAddon : public GPAddon
 {
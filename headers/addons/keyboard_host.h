@@ -14,24 +14,13 @@
 
 // KeyboardHost Module Name
 #define KeyboardHostName "KeyboardHost"
+#define KeyboardHostServiceName "KeyboardHostService"
 
-struct KeyboardButtonMapping
-{
-	KeyboardButtonMapping(uint16_t bm) : 
-		buttonMask(bm)
-	{}
-
-	uint8_t key;
-	const uint16_t buttonMask;
-
-	inline void setKey(uint8_t p)
-	{
-		key = (p > HID_KEY_NONE && p <=HID_KEY_GUI_RIGHT) ? p : 0xff;
-	}
-
-	bool isAssigned() const { return key != 0xff; }
-};
+// Core1 schedule (microseconds), reports arrive at most once per USB frame
+#define KEYBOARD_HOST_PERIOD_MICRO 250
+#define KEYBOARD_HOST_BUDGET_MICRO 200
 
+// Merges the keyboard and gamepad inputs decoded on core1 into the core0 gamepad state
 class KeyboardHostAddon : public GPAddon {
 public:
 	virtual bool available();
@@ -42,4 +31,14 @@ public:
 private:	
 };
 
+// Runs the PIO-USB host stack on core1, its frame timer and report decoding never touch core0
+class KeyboardHostServiceAddon : public GPAddon {
+public:
+	virtual bool available();
+	virtual void setup();
+	virtual void process();
+	virtual void preprocess() {}
+	virtual std::string name() { return KeyboardHostServiceName; }
+};
+
 #endif  // _KeyboardHost_H_
\ No newline at end of file
@@ -0,0 +1,55 @@
+#ifndef _Macro_H
+#define _Macro_H
+
+#include "gpaddon.h"
+#include "gamepad.h"
+
+#ifndef MACRO_ENABLED
+#define MACRO_ENABLED 0
+#endif
+
+// Frame rate used by steps whose duration is given in frames
+#ifndef MACRO_FRAME_HZ
+#define MACRO_FRAME_HZ 60
+#endif
+
+// Step word layout, see Macro.steps in config.proto
+#define MACRO_STEP_INPUT_MASK     0x000FFFFF
+#define MACRO_STEP_DPAD_SHIFT     16
+#define MACRO_STEP_DURATION_SHIFT 20
+#define MACRO_STEP_DURATION_MASK  0x7FF
+#define MACRO_STEP_FRAMES         (1UL << 31)
+#define MACRO_STEP_UNIT_MICROS    10
+
+#define MACRO_MAX_COUNT (sizeof(MacroOptions::macros) / sizeof(Macro))
+
+// Macro Module Name
+#define MacroName "Macro"
+
+class MacroInput : public GPAddon {
+public:
+	virtual bool available();
+	virtual void setup();       // Macro Setup
+	virtual void process() {}
+	virtual void preprocess();  // Macro Process, runs ahead of SOCD and dpad mode handling
+	virtual std::string name() { return MacroName; }
+private:
+	struct Playback {
+		bool playing;
+		bool triggerHeld;
+		uint8_t step;
+		uint64_t startMicros;
+		uint32_t elapsedMicros;     // Summed durations in us up to and including the current step
+		uint32_t elapsedFrames;     // Summed durations in frames up to and including the current step
+		uint64_t stepEndMicros;     // Derived from the sums so rounding never accumulates
+	};
+
+	void start(const Macro & macro, Playback & playback, uint64_t now);
+	void startStep(const Macro & macro, Playback & playback);
+	uint32_t advance(const Macro & macro, Playback & playback, uint64_t reportMicros);
+
+	uint8_t macroCount;
+	Playback playbacks[MACRO_MAX_COUNT];
+};
+
+#endif  // _Macro_H
@@ -162,6 +162,10 @@ public:
 
 #define NeoPicoLEDName "NeoPicoLED"
 
+// Core1 schedule (microseconds), one animation frame per period
+#define NEOPICO_LED_PERIOD_MICRO 10000
+#define NEOPICO_LED_BUDGET_MICRO 5000
+
 // NeoPico LED Addon
 class NeoPicoLEDAddon : public GPAddon {
 public:
@@ -180,8 +184,6 @@ private:
 	std::vector<std::vector<Pixel>> generatedLEDWasdFBM(std::vector<std::vector<uint8_t>> *positions);
 	std::vector<std::vector<Pixel>> createLEDLayout(ButtonLayout layout, uint8_t ledsPerPixel, uint8_t ledButtonCount);
 	uint8_t setupButtonPositions();
-	const uint32_t intervalMS = 10;
-	absolute_time_t nextRunTime;
 	uint8_t ledCount;
 	PixelMatrix matrix;
 	NeoPico *neopico;
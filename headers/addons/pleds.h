@@ -30,6 +30,10 @@ public:
 // Player LED Module
 #define PLEDName "PLED"
 
+// Core1 schedule (microseconds)
+#define PLED_PERIOD_MICRO 10000
+#define PLED_BUDGET_MICRO 500
+
 // Player LED Module
 class PlayerLEDAddon : public GPAddon
 {
@@ -13,6 +13,9 @@
 // Turbo Module Name
 #define PS4ModeName "PS4Mode"
 
+// Core1 schedule (microseconds), nonce signing runs as background work
+#define PS4MODE_PERIOD_MICRO 1000
+
 class PS4ModeAddon : public GPAddon {
 public:
 	virtual bool available();
@@ -17,6 +17,14 @@
 #define TURBO_BUTTON_MASK (GAMEPAD_MASK_B1 | GAMEPAD_MASK_B2 | GAMEPAD_MASK_B3 | GAMEPAD_MASK_B4 | \
                             GAMEPAD_MASK_L1 | GAMEPAD_MASK_R1 | GAMEPAD_MASK_L2 | GAMEPAD_MASK_R2)
 
+// B1 through R2, TurboOptions.buttonShotCounts is indexed by their bit in TURBO_BUTTON_MASK
+#define TURBO_BUTTON_COUNT 8
+
+// Changed shot counts are persisted once every input has been released this long
+#ifndef TURBO_SAVE_IDLE_MS
+#define TURBO_SAVE_IDLE_MS 2000
+#endif
+
 // TURBO LED
 #ifndef TURBO_LED_PIN
 #define TURBO_LED_PIN   -1
@@ -97,6 +105,10 @@ private:
     void read(const TurboOptions&);                // Read TURBO Buttons and Dials
     void debounce();            // TURBO Button Debouncer
     void updateTurboShotCount(uint8_t turboShotCount);
+    void updateButtonShotCount(uint8_t button, uint8_t turboShotCount);
+    void toggleTurbo(uint16_t buttons, const TurboOptions& options);  // Flip turbo on the buttons, SHMUP always-on ones stay on
+    void restartFlicker(uint64_t now);  // Reload every button period and bring them back in phase
+    void advanceFlicker(uint64_t now);  // Apply the edges the timer has passed since the last poll
     bool bDebState;             // Debounce TURBO Button State
     uint32_t uDebTime;          // Debounce TURBO Button Time
     uint32_t debChargeState;    // Debounce Charge Button State
@@ -104,13 +116,16 @@ private:
     uint32_t debounceMS;        // Debounce MS from Gamepad
     uint16_t lastPressed;       // Last buttons pressed (for Turbo Enable)
     uint16_t lastDpad;          // Last d-pad pressed (for Turbo Change)
+    uint16_t toggleCandidates;  // Buttons pressed with TURBO that toggle on release
     uint16_t turboButtonsPressed;    // Turbo Buttons Enabled
     uint16_t alwaysEnabled;     // Turbo SHMUP Always Enabled
-    uint32_t uIntervalMS;       // Turbo Interval
     bool bTurboState;           // Turbo Buttons State
     uint32_t chargeState;       // Turbo Charge Button States
-    bool bTurboFlicker;         // Turbo Enable Buttons Toggle OFF Flag ??
-    uint32_t nextTimer;         // Turbo Timer
+    uint16_t flickerMask;       // Turbo buttons currently in their OFF phase
+    uint32_t halfPeriodMicros[TURBO_BUTTON_COUNT];  // Time between two flicker edges per button
+    uint64_t nextEdgeMicros[TURBO_BUTTON_COUNT];    // Next flicker edge per button, advanced by whole periods
+    bool savePending;           // Shot counts changed from the gamepad and not persisted yet
+    uint32_t saveIdleSince;     // Last time an input was held while a save is pending
     uint8_t adcShmupDial;       // Turbo ADC Dial Input
     uint16_t dialValue;         // Turbo Dial Value (Raw)
     uint16_t incrementValue;    // Turbo Dial Increment Value
@@ -48,6 +48,8 @@ private:
     WiiExtension * wii;
     uint32_t uIntervalMS;
     uint32_t nextTimer;
+    bool backgroundPoll = false;
+    int8_t extensionType = WII_EXTENSION_NONE;
 
     bool buttonC = false;
     bool buttonZ = false;
@@ -79,6 +81,7 @@ private:
     uint16_t rightX = 0;
     uint16_t rightY = 0;
 
+    void readState(const WiiExtensionState & latest);
     uint16_t map(uint16_t x, uint16_t in_min, uint16_t in_max, uint16_t out_min, uint16_t out_max);
 };
 
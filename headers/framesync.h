@@ -0,0 +1,43 @@
+#ifndef FRAMESYNC_H_
+#define FRAMESYNC_H_
+
+#include <cstdint>
+
+// Full speed USB start-of-frame period
+#define FRAME_SYNC_PERIOD_MICRO 1000
+
+// Time kept between the end of a synchronized poll and the next start-of-frame
+#ifndef FRAME_SYNC_GUARD_MICRO
+#define FRAME_SYNC_GUARD_MICRO 25
+#endif
+
+// Jitter histogram layout, report age at start-of-frame in FRAME_JITTER_BUCKET_MICRO steps
+#define FRAME_JITTER_BUCKETS 32
+#define FRAME_JITTER_BUCKET_MICRO 8
+
+namespace FrameSync {
+    struct JitterHistogram {
+        uint32_t magic;
+        uint32_t sofSync;       // Non-zero when captured with start-of-frame scheduling enabled
+        uint32_t frames;        // Start-of-frame events observed
+        uint32_t staleFrames;   // Frames where no new poll completed since the previous start-of-frame
+        uint32_t minAge;
+        uint32_t maxAge;
+        uint32_t buckets[FRAME_JITTER_BUCKETS];
+    };
+
+    // Starts listening for start-of-frame events and resets the jitter histogram
+    // Must be called after the USB driver has been initialized
+    void setup(bool sofSync);
+    // Returns true while start-of-frame events are arriving and polls are scheduled against them
+    bool locked();
+    // Records the completion of a poll whose inputs were sampled at pollStart
+    void pollComplete(uint64_t pollStart);
+    // Returns the time at which the next poll should start
+    uint64_t nextPollTime(uint64_t now, uint64_t fallback);
+
+    // Returns the histogram captured by the last gamepad session, survives a watchdog reboot into webconfig
+    const JitterHistogram* getJitterHistogram();
+}
+
+#endif
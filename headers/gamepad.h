@@ -6,6 +6,8 @@
 
 #include "enums.pb.h"
 #include "gamepad/GamepadDebouncer.h"
+#include "gamepad/GpioSampler.h"
+#include "gamepad/GamepadHotkeys.h"
 #include "gamepad/GamepadState.h"
 #include "gamepad/descriptors/HIDDescriptors.h"
 #include "gamepad/descriptors/SwitchDescriptors.h"
@@ -57,13 +59,18 @@ struct GamepadButtonMapping
 
 #define GAMEPAD_DIGITAL_INPUT_COUNT 18 // Total number of buttons, including D-pad
 
+// The GPIO word is gathered into dpad/buttons/aux one nibble at a time
+#define GAMEPAD_PIN_LOOKUP_NIBBLES 8
+
 class Gamepad {
 public:
 	Gamepad(int debounceMS = 5);
 
 	void setup();
+	void setupSampler();
 	void process();
 	void read();
+	void readPins(uint32_t values);
 	void save();
 	void debounce();
 	
@@ -112,21 +119,17 @@ public:
 	}
 
 	/**
-	 * @brief Check for a hotkey combination press. Checks aux, buttons, and dpad.
+	 * @brief Check for a GPIO held low at the last `read()`. Add-ons use this instead of `gpio_get()`
+	 * so every digital input of a poll is sampled at the same instant.
 	 */
-	inline bool __attribute__((always_inline)) pressedHotkey(const HotkeyEntry hotkey) {
-		return (hotkey.action != 0 && pressedButton(hotkey.buttonsMask) &&
-				pressedDpad(hotkey.dpadMask) && pressedAux(hotkey.auxMask));
+	inline bool __attribute__((always_inline)) pressedPin(const uint8_t pin) const {
+		return pin < NUM_BANK0_GPIOS && (pressedPins & (1U << pin)) != 0;
 	}
 
 	/**
-	 * @brief Remote hotkey bits from the state bitmask and provide pressed action.
+	 * @brief All GPIOs held low at the last `read()`, one bit per pin.
 	 */
-	inline GamepadHotkey __attribute__((always_inline)) selectHotkey(const HotkeyEntry hotkey) {
-		state.buttons &= ~(hotkey.buttonsMask);
-		state.dpad &= ~(hotkey.dpadMask);
-		return static_cast<GamepadHotkey>(hotkey.action);
-	}
+	inline uint32_t __attribute__((always_inline)) getPressedPins() const { return pressedPins; }
 
 	inline bool __attribute__((always_inline)) pressedUp()    { return pressedDpad(GAMEPAD_MASK_UP); }
 	inline bool __attribute__((always_inline)) pressedDown()  { return pressedDpad(GAMEPAD_MASK_DOWN); }
@@ -191,11 +194,21 @@ private:
 	uint8_t getModifier(uint8_t code);
 	uint8_t getMultimedia(uint8_t code);
 	void processHotkeyIfNewAction(GamepadHotkey action);
+	void buildPinLookup(int32_t pinButtonFn);
+	uint32_t gatherPins(uint32_t values) const;
+	void mapPins(uint32_t values, GamepadState & target);
+	uint8_t invertDpad(uint8_t dpad);
 
 	GamepadOptions& options;
 	const HotkeyOptions& hotkeyOptions;
 
 	GamepadHotkey lastAction = HOTKEY_NONE;
+	GamepadHotkeys hotkeys;
+	GpioSampler sampler;
+	uint32_t pressedPins = 0;
+
+	// Per nibble of the inverted GPIO word: buttons in bits 0-15, dpad in 16-23, Fn in 24
+	uint32_t pinLookup[GAMEPAD_PIN_LOOKUP_NIBBLES][16];
 };
 
 #endif
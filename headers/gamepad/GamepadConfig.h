@@ -17,6 +17,45 @@
 #define DEFAULT_INPUT_MODE INPUT_MODE_XINPUT
 #endif
 
+// Schedule polls just ahead of each USB start-of-frame instead of every GAMEPAD_POLL_MICRO
+#ifndef DEFAULT_USB_FRAME_SYNC
+#define DEFAULT_USB_FRAME_SYNC false
+#endif
+
+// Sample the buttons with a PIO state machine and replay every timestamped edge instead of reading once per poll
+#ifndef DEFAULT_PIO_SAMPLER
+#define DEFAULT_PIO_SAMPLER false
+#endif
+
+#ifndef DEFAULT_DEBOUNCE_MODE
+#define DEFAULT_DEBOUNCE_MODE DEBOUNCE_MODE_TIMED
+#endif
+
+// Consecutive polls that must agree before DEBOUNCE_MODE_INTEGRATOR toggles an input
+#ifndef DEFAULT_DEBOUNCE_SAMPLES
+#define DEFAULT_DEBOUNCE_SAMPLES 4
+#endif
+
+// Time an input is ignored after DEBOUNCE_MODE_EAGER reported a change on it
+#ifndef DEFAULT_DEBOUNCE_LOCKOUT_MICROS
+#define DEFAULT_DEBOUNCE_LOCKOUT_MICROS 2000
+#endif
+
+// Record every change of the raw input into RAM for download through webconfig
+#ifndef DEFAULT_INPUT_RECORDING
+#define DEFAULT_INPUT_RECORDING false
+#endif
+
+// Run the ADC round-robin into a DMA ring shared by the analog add-ons instead of blocking reads
+#ifndef DEFAULT_ADC_SAMPLER
+#define DEFAULT_ADC_SAMPLER false
+#endif
+
+// Newest samples per input averaged by the ADC sampler
+#ifndef DEFAULT_ADC_AVERAGE_SAMPLES
+#define DEFAULT_ADC_AVERAGE_SAMPLES 1
+#endif
+
 /* hotkeys */
 #ifndef HOTKEY_01_AUX_MASK
 #define HOTKEY_01_AUX_MASK 0
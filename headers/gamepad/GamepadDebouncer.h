@@ -12,16 +12,45 @@
 // Implement this wrapper function for your platform
 // TODO: Make this a pure virtual member instead.
 uint32_t getMillis();
+uint64_t getMicro();
+
+// Width of the per-bit sample counters of DEBOUNCE_MODE_INTEGRATOR
+#define DEBOUNCE_INTEGRATOR_BITS 4
+#define DEBOUNCE_INTEGRATOR_MAX_SAMPLES ((1 << DEBOUNCE_INTEGRATOR_BITS) - 1)
+
+// Buttons in bits 0-15 and dpad in 16-23 of the packed input word
+#define DEBOUNCE_PACKED_BITS 24
 
 class GamepadDebouncer
 {
 	public:
 		GamepadDebouncer(const uint8_t debounceMS = 5) : debounceMS(debounceMS) { }
 
+		void setMode(DebounceMode debounceMode, uint32_t samples, uint32_t lockoutMicros);
+		// True when the result depends on when a sample was taken rather than how many were taken
+		bool isTimeBased() const { return mode != DEBOUNCE_MODE_INTEGRATOR; }
+
 		void debounce(GamepadState *state);
+		// Debounces against an explicit time, used to replay timestamped edges in order
+		void debounce(GamepadState *state, uint64_t nowMicros);
 
 		const uint8_t debounceMS;
 		GamepadState debounceState;
 		uint32_t dpadTime[4];
 		uint32_t buttonTime[GAMEPAD_BUTTON_COUNT];
+
+	private:
+		void debounceTimed(GamepadState *state, uint32_t now);
+		void debounceIntegrator(GamepadState *state);
+		void debounceEager(GamepadState *state, uint64_t nowMicros);
+
+		DebounceMode mode = DEBOUNCE_MODE_TIMED;
+		uint32_t integratorSamples = 4;
+		uint32_t integratorState = 0;
+		// Bit-sliced counters, integratorCount[n] holds bit n of the counter of every input
+		uint32_t integratorCount[DEBOUNCE_INTEGRATOR_BITS] = { };
+
+		uint32_t eagerLockoutMicros = 2000;
+		uint32_t eagerState = 0;
+		uint64_t eagerLockedUntil[DEBOUNCE_PACKED_BITS] = { };
 };
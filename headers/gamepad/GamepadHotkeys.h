@@ -0,0 +1,57 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "GamepadState.h"
+#include "config.pb.h"
+
+// Fixed hotkey01-12 plus the repeated extraHotkeys list
+#define GAMEPAD_HOTKEY_FIXED_COUNT 12
+#define GAMEPAD_HOTKEY_MAX_COUNT (GAMEPAD_HOTKEY_FIXED_COUNT + (sizeof(HotkeyOptions::extraHotkeys) / sizeof(HotkeyEntry)))
+
+#define GAMEPAD_HOTKEY_DPAD_SHIFT 16
+
+// Fn, S1, S2, A1 and A2 select the candidate list of a poll
+#define GAMEPAD_HOTKEY_MODIFIER_BITS 5
+#define GAMEPAD_HOTKEY_MODIFIER_COMBOS (1 << GAMEPAD_HOTKEY_MODIFIER_BITS)
+
+struct GamepadHotkeyMatch
+{
+	uint32_t inputMask;	// Buttons in bits 0-15, dpad in 16-23
+	uint16_t auxMask;
+	GamepadHotkey action;
+
+	// Removes the hotkey bits from the state so they are not reported
+	void release(GamepadState & state) const {
+		state.buttons &= ~static_cast<uint16_t>(inputMask);
+		state.dpad &= ~static_cast<uint8_t>(inputMask >> GAMEPAD_HOTKEY_DPAD_SHIFT);
+	}
+};
+
+/**
+ * @brief Hotkey table compiled once at setup so a poll only looks at the hotkeys it can possibly match.
+ *
+ * Every hotkey is filed under each combination of held modifiers that contains its own modifiers, in
+ * configuration order. A poll turns the modifiers it holds into an index and walks only that list, so
+ * with no modifier held the lookup ends right away however many hotkeys are bound.
+ */
+class GamepadHotkeys
+{
+public:
+	void compile(const HotkeyOptions & hotkeyOptions);
+
+	/**
+	 * @brief Returns the first configured hotkey held in the state, nullptr if none is.
+	 */
+	const GamepadHotkeyMatch * match(const GamepadState & state) const;
+
+private:
+	void add(const HotkeyEntry & hotkey);
+	static uint8_t modifierIndex(uint16_t buttons, uint16_t aux);
+
+	GamepadHotkeyMatch hotkeys[GAMEPAD_HOTKEY_MAX_COUNT];
+	uint8_t hotkeyCount = 0;
+	// candidates[offsets[i]] to candidates[offsets[i + 1]] are the hotkeys reachable with modifier combination i
+	uint16_t offsets[GAMEPAD_HOTKEY_MODIFIER_COMBOS + 1] = { };
+	uint8_t candidates[GAMEPAD_HOTKEY_MODIFIER_COMBOS * GAMEPAD_HOTKEY_MAX_COUNT];
+};
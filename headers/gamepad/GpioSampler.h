@@ -0,0 +1,90 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "hardware/pio.h"
+
+// Edges kept in the DMA rings, the rings are aligned to their size so this has to stay small
+#define GPIO_SAMPLER_RING_BITS 8
+#define GPIO_SAMPLER_RING_SIZE (1 << GPIO_SAMPLER_RING_BITS)
+
+// Sample rate of the state machine, matches the 1us resolution of the edge timestamps
+#ifndef GPIO_SAMPLER_SAMPLE_HZ
+#define GPIO_SAMPLER_SAMPLE_HZ 1000000
+#endif
+
+struct GpioSamplerEdge
+{
+	uint32_t pins;       // Raw GPIO 0-31 levels right after the edge, pins outside the sampled range as of the last capture()
+	uint32_t timeMicros; // Lower 32 bits of the system timer when the edge was captured
+};
+
+/**
+ * @brief Continuously samples the button pins with a PIO state machine and timestamps every change.
+ *
+ * The state machine samples the contiguous range spanning the button pins, so LED data, I2C and
+ * PWM traffic elsewhere on the bank never takes up ring entries, and only pushes when it changes. One DMA channel moves each pushed value into
+ * a ring and chains to a second channel that copies the raw timer into a parallel ring, which in turn
+ * chains back to the first. The CPU never touches the hot path, it only drains the rings once per poll.
+ */
+class GpioSampler
+{
+public:
+	/**
+	 * @brief Claims a spare state machine and two DMA channels and starts sampling.
+	 *
+	 * @param pinMask GPIOs whose edges matter, the range from the lowest to the highest one is sampled
+	 * @return false if pinMask is empty or no state machine, instruction memory or DMA channel was free,
+	 * the sampler then stays inactive
+	 */
+	bool setup(uint32_t pinMask);
+
+	bool isActive() const { return active; }
+
+	/**
+	 * @brief Returns the current pin levels and closes the batch of edges returned by nextEdge().
+	 *
+	 * Pins outside the sampled range are read directly.
+	 */
+	uint32_t capture();
+
+	/**
+	 * @brief Pops the oldest edge captured before the last capture() that changed a pin of the mask.
+	 *
+	 * When the ring was lapped since the previous capture() the batch is dropped, the caller then
+	 * only sees the levels returned by capture().
+	 */
+	bool nextEdge(GpioSamplerEdge & edge);
+
+	/**
+	 * @brief Marks every edge up to the last capture() as handled, for callers that do not replay them.
+	 */
+	void skipEdges();
+
+	/**
+	 * @brief Number of times the ring was lapped between two captures and the edges were dropped.
+	 */
+	uint32_t getOverruns() const { return overruns; }
+
+private:
+	bool claimStateMachine(uint width);
+	uint32_t writeIndex() const;
+
+	bool active = false;
+	PIO pio = nullptr;
+	uint sm = 0;
+	uint offset = 0;
+	int valueChannel = -1;
+	int timeChannel = -1;
+	uint16_t program[PIO_INSTRUCTION_COUNT]; // Copy of the program with the sample width patched in
+	pio_program_t sampleProgram = {};
+	uint32_t pinMask = 0;
+	uint32_t sampledMask = 0;
+	uint pinBase = 0;
+	uint32_t readIndex = 0;
+	uint32_t captureIndex = 0;
+	uint32_t lastEdgeTime = 0;  // Time of the edge before readIndex, changes when the DMA laps the reader
+	uint32_t lastEdgePins = 0;  // Sampled range of the last edge handed out
+	uint32_t lastPins = 0;
+	uint32_t overruns = 0;
+};
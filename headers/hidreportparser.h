@@ -0,0 +1,100 @@
+#ifndef HIDREPORTPARSER_H_
+#define HIDREPORTPARSER_H_
+
+#include <stdint.h>
+
+#include "gamepad/GamepadState.h"
+
+// Input mask layout used by the key table and the plan, buttons in the low half
+#define HID_REPORT_DPAD_SHIFT 16
+
+// Keyboard usages 0x00-0xFF, indexes the key table handed to compile()
+#define HID_REPORT_KEY_COUNT 256
+
+#define HID_REPORT_MAX_FIELDS 48
+#define HID_REPORT_MAX_REPORTS 8
+#define HID_REPORT_MAX_USAGES 16
+
+// HidReportState::analog bits, set for every axis the device reports
+#define HID_REPORT_ANALOG_LX (1 << 0)
+#define HID_REPORT_ANALOG_LY (1 << 1)
+#define HID_REPORT_ANALOG_RX (1 << 2)
+#define HID_REPORT_ANALOG_RY (1 << 3)
+#define HID_REPORT_ANALOG_LT (1 << 4)
+#define HID_REPORT_ANALOG_RT (1 << 5)
+
+struct HidReportState
+{
+    GamepadState state;
+    uint8_t analog = 0;
+};
+
+/**
+ * @brief Turns a HID report descriptor into an extraction plan, then translates reports with it.
+ *
+ * compile() walks the descriptor once when a device is mounted and keeps only the input fields that
+ * end up somewhere: keys bound in the key table, gamepad buttons, the hat switch and the stick and
+ * trigger axes. Each one is stored with its bit offset, size and target, so translate() costs the
+ * same for every report of a device however large its descriptor is.
+ */
+class HidReportParser
+{
+public:
+    /**
+     * @brief Builds the plan for a report descriptor.
+     *
+     * @param keyMasks HID_REPORT_KEY_COUNT input masks indexed by keyboard usage, kept by reference
+     * @return false if the descriptor has no input this parser can map
+     */
+    bool compile(const uint8_t * descriptor, uint16_t length, const uint32_t * keyMasks);
+
+    /**
+     * @brief Builds the fixed plan of a keyboard running the boot protocol, its reports ignore the descriptor.
+     */
+    void compileBootKeyboard(const uint32_t * keyMasks);
+
+    /**
+     * @brief Updates the inputs the report carries, the ones other report IDs carry are left as they are.
+     */
+    void translate(const uint8_t * report, uint16_t length, HidReportState & state) const;
+
+private:
+    enum class FieldKind : uint8_t {
+        BIT,        // Any non-zero value sets mask
+        KEY_ARRAY,  // count elements holding keyboard usages
+        HAT,        // Eight-way hat switch onto the dpad
+        AXIS,       // Scaled onto the stick or trigger in target
+    };
+
+    struct Field {
+        FieldKind kind;
+        uint8_t reportId;
+        uint8_t bitSize;
+        uint8_t count;
+        uint16_t bitOffset;
+        uint8_t target;         // AXIS: HID_REPORT_ANALOG_* bit
+        uint32_t mask;          // BIT: input mask
+        int32_t logicalMin;     // AXIS, HAT and KEY_ARRAY: value that maps to the first position or usage
+        uint32_t range;         // AXIS: logicalMax - logicalMin
+    };
+
+    struct Report {
+        uint8_t id;
+        uint16_t bits;          // Input bits declared so far, the offset of the next field
+        uint32_t inputMask;     // Inputs this report controls, cleared before it is applied
+        uint8_t analog;
+    };
+
+    Report * report(uint8_t id);
+    void add(const Field & field);
+    void addVariable(uint32_t usage, uint8_t reportId, uint16_t bitOffset, uint8_t bitSize, int32_t logicalMin, int32_t logicalMax);
+
+    const uint32_t * keys = nullptr;
+    bool usesReportIds = false;
+    uint8_t fieldCount = 0;
+    uint8_t reportCount = 0;
+    Field fields[HID_REPORT_MAX_FIELDS];
+    Report reports[HID_REPORT_MAX_REPORTS];
+};
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef INPUTRECORDER_H_
+#define INPUTRECORDER_H_
+
+#include <cstdint>
+
+#include "adcsampler.h"
+
+class Gamepad;
+
+// Polls kept in the ring, only polls whose input changed are stored
+#ifndef INPUT_RECORDER_RECORDS
+#define INPUT_RECORDER_RECORDS 256
+#endif
+
+namespace InputRecorder {
+    struct Record {
+        uint32_t timeMicros;    // Lower 32 bits of the system timer at the start of the poll
+        uint32_t pins;          // Inverted GPIO word, one bit per pin held low
+        uint16_t adc[ADC_SAMPLER_CHANNELS];    // Raw 12-bit ADC readings, 0 for inputs no add-on uses
+    };
+
+    struct Recording {
+        uint32_t magic;
+        uint32_t count;         // Records written since setup, the ring holds the last INPUT_RECORDER_RECORDS
+        Record records[INPUT_RECORDER_RECORDS];
+    };
+
+    // Clears the ring and starts recording if enabled, gamepad mode only
+    void setup(bool enabled);
+    // Stores the raw input of the current poll, call right after Gamepad::read() so nothing has
+    // processed it yet. The ADC inputs are read once more, unfiltered, so a replay can feed them
+    // to the analog add-ons
+    void record(const Gamepad * gamepad, uint32_t timeMicros);
+
+    // Returns the recording of the last gamepad session, survives a watchdog reboot into webconfig
+    const Recording* getRecording();
+}
+
+#endif
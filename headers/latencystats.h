@@ -0,0 +1,55 @@
+#ifndef LATENCYSTATS_H_
+#define LATENCYSTATS_H_
+
+#include <cstdint>
+
+// Recent samples kept per stage for percentiles
+#define LATENCY_STATS_SAMPLES 256
+// Samples are stored as (cycles >> LATENCY_STATS_SAMPLE_SHIFT) to fit 16 bits
+#define LATENCY_STATS_SAMPLE_SHIFT 4
+
+enum LatencyStage {
+    LATENCY_STAGE_READ,
+    LATENCY_STAGE_DEBOUNCE,
+    LATENCY_STAGE_HOTKEY,
+    LATENCY_STAGE_PREPROCESS_ADDONS,
+    LATENCY_STAGE_PROCESS,
+    LATENCY_STAGE_PROCESS_ADDONS,
+    LATENCY_STAGE_REPORT_BUILD,
+    LATENCY_STAGE_SEND_REPORT,
+    LATENCY_STAGE_USB_REPORT,
+    LATENCY_STAGE_TUD_TASK,
+    LATENCY_STAGE_TOTAL,        // Start of read to end of send_report
+    LATENCY_STAGE_COUNT
+};
+
+namespace LatencyStats {
+    struct StageStats {
+        uint32_t minCycles;
+        uint32_t maxCycles;
+        uint64_t totalCycles;
+        uint16_t samples[LATENCY_STATS_SAMPLES];
+    };
+
+    struct Stats {
+        uint32_t magic;
+        uint32_t clockHz;
+        uint32_t polls;
+        StageStats stages[LATENCY_STAGE_COUNT];
+    };
+
+    // Resets the statistics, gamepad mode only and after the core0 cycle counter was started
+    void setup();
+    // Marks the start of a poll
+    void begin();
+    // Marks the end of a stage, its duration is the time since the previous mark
+    void mark(LatencyStage stage);
+    // Commits the stage durations of the current poll
+    void end();
+
+    const char* getStageName(LatencyStage stage);
+    // Returns the statistics of the last gamepad session, survives a watchdog reboot into webconfig
+    const Stats* getStats();
+}
+
+#endif
@@ -13,6 +13,7 @@
 #include "enums.h"
 #include "helper.h"
 #include "gamepad.h"
+#include "triplebuffer.h"
 
 #include "config.pb.h"
 
@@ -52,14 +53,23 @@ public:
 
 	void enqueueAnimationOptionsSave(const AnimationOptions& animationOptions);
 
+	void enqueueTurboOptionsSave(const TurboOptions& turboOptions); // core0 only
+
+	void enqueueAnalogOptionsSave(const AnalogOptions& analogOptions); // core0 only
+
 	void SetConfigMode(bool); 			// Config Mode (on-boot)
 	bool GetConfigMode();
 
+	void SetAnalogCalibrationMode(bool); // Analog stick calibration (hotkey)
+	bool GetAnalogCalibrationMode();
+
 	void SetGamepad(Gamepad *); 		// MPGS Gamepad Get/Set
 	Gamepad * GetGamepad();
 
 	void SetProcessedGamepad(Gamepad *); // MPGS Processed Gamepad Get/Set
 	Gamepad * GetProcessedGamepad();
+	void PublishProcessedGamepadState(const GamepadState &); // core0: hand off the processed state without blocking
+	void SyncProcessedGamepad();			// core1: refresh the processed gamepad with the latest coherent state
 
 	void SetFeatureData(uint8_t *); 	// USB Feature Data Get/Set
 	void ClearFeatureData();
@@ -70,8 +80,10 @@ public:
 private:
 	Storage();
 	bool CONFIG_MODE = false; 			// Config mode (boot)
+	bool analogCalibrationMode = false; // Analog add-on records stick extremes while set
 	Gamepad * gamepad = nullptr;    		// Gamepad data
 	Gamepad * processedGamepad = nullptr; // Gamepad with ONLY processed data
+	TripleBuffer<GamepadState> processedGamepadState; // Lock-free core0 to core1 state handoff
 	uint8_t featureData[32]; // USB X-Input Feature Data
 	DisplayOptions previewDisplayOptions;
 	Config config;
@@ -79,6 +91,10 @@ private:
 	critical_section_t animationOptionsCs;
 	uint32_t animationOptionsCrc = 0;
 	AnimationOptions animationOptionsToSave = {};
+	bool turboOptionsSavePending = false;
+	TurboOptions turboOptionsToSave = {};
+	bool analogOptionsSavePending = false;
+	AnalogOptions analogOptionsToSave = {};
 };
 
 #endif
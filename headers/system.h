@@ -15,6 +15,13 @@ namespace System {
     // Returns the about of heap memory currently allocated in bytes
     uint32_t getUsedHeap();
 
+    // Starts the SysTick timer of the calling core as a free running 24-bit cycle counter
+    void initCycleCounter();
+    // Returns the cycle counter of the calling core, wraps every 2^24 cycles
+    uint32_t getCycleCount();
+    // Returns the cycles between two getCycleCount() values, only valid for intervals shorter than one wrap
+    uint32_t getCyclesElapsed(uint32_t start, uint32_t end);
+
     enum class BootMode : uint32_t {
         DEFAULT = 0,
         GAMEPAD = 0x43d566cd,
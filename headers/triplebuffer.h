@@ -0,0 +1,75 @@
+#ifndef TRIPLEBUFFER_H_
+#define TRIPLEBUFFER_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include "hardware/sync.h"
+
+/**
+ * @brief Lock-free single producer / single consumer handoff of the latest T between the two cores.
+ *
+ * The producer never waits: it writes into a slot that is neither the latest one nor the one the
+ * consumer announced it is reading. Every slot carries a sequence counter that is odd while the
+ * slot is being written, which catches the short window where the consumer's announcement is not
+ * visible to the producer yet. The consumer then simply copies again.
+ */
+template <typename T>
+class TripleBuffer
+{
+public:
+	TripleBuffer() : latest(0), reading(0), published(0) {
+		for (uint8_t i = 0; i < SLOT_COUNT; i++)
+			sequences[i] = 0;
+	}
+
+	/**
+	 * @brief Publishes a new value. Producer core only.
+	 */
+	void write(const T & value) {
+		const uint8_t latestSlot = latest;
+		const uint8_t readingSlot = reading;
+		uint8_t slot = 0;
+		while (slot == latestSlot || slot == readingSlot)
+			slot++;
+
+		published++;
+		sequences[slot] = (published << 1) | 1;
+		__dmb();
+		memcpy(&slots[slot], &value, sizeof(T));
+		__dmb();
+		sequences[slot] = published << 1;
+		latest = slot;
+	}
+
+	/**
+	 * @brief Copies the latest published value. Consumer core only.
+	 *
+	 * @return The sequence number of the copied value, 0 if nothing was published yet
+	 */
+	uint32_t read(T & value) {
+		for (;;) {
+			const uint8_t slot = latest;
+			reading = slot;
+			__dmb();
+
+			const uint32_t before = sequences[slot];
+			__dmb();
+			memcpy(&value, &slots[slot], sizeof(T));
+			__dmb();
+			if ((before & 1) == 0 && before == sequences[slot])
+				return before >> 1;
+		}
+	}
+
+private:
+	static const uint8_t SLOT_COUNT = 3;
+
+	T slots[SLOT_COUNT];
+	volatile uint32_t sequences[SLOT_COUNT];
+	volatile uint8_t latest;
+	volatile uint8_t reading;
+	uint32_t published;
+};
+
+#endif
@@ -23,6 +23,7 @@
 #include "hardware/i2c.h"
 
 #include "BitBang_I2C.h"
+#include "I2CQueue.h"
 
 
 //
@@ -40,7 +41,7 @@ void I2CInit(BBI2C *pI2C, uint32_t iClock)
 	if (pI2C == NULL) return;
 	if ((pI2C->iSDA + 2 * i2c_hw_index(pI2C->picoI2C))%4 != 0) return ;
 	if ((pI2C->iSCL + 3 + 2 * i2c_hw_index(pI2C->picoI2C))%4 != 0) return ;
-      i2c_init(pI2C->picoI2C, iClock);
+      i2c_queue_init(pI2C->picoI2C, iClock); // leaves a block with a running queue alone
       gpio_set_function(pI2C->iSDA, GPIO_FUNC_I2C);
       gpio_set_function(pI2C->iSCL, GPIO_FUNC_I2C);
       gpio_pull_up(pI2C->iSDA);
@@ -55,7 +56,10 @@ uint8_t I2CTest(BBI2C *pI2C, uint8_t addr)
 {
 	int ret;
     uint8_t rxdata;
-    ret = i2c_read_blocking(pI2C->picoI2C, addr, &rxdata, 1, false);
+    if (i2c_queue_active(pI2C->picoI2C))
+      ret = i2c_queue_transfer_blocking(pI2C->picoI2C, addr, NULL, 0, &rxdata, 1);
+    else
+      ret = i2c_read_blocking(pI2C->picoI2C, addr, &rxdata, 1, false);
     return (ret >= 0);
 } /* I2CTest() */
 
@@ -88,7 +92,10 @@ int I2CWrite(BBI2C *pI2C, uint8_t iAddr, uint8_t *pData, int iLen)
 {
 	int rc = 0;
 
-    rc = i2c_write_blocking(pI2C->picoI2C, iAddr, pData, iLen, true); // true to keep master control of bus
+    if (i2c_queue_active(pI2C->picoI2C))
+      rc = i2c_queue_transfer_blocking(pI2C->picoI2C, iAddr, pData, iLen, NULL, 0); // queued behind the other devices on the block
+    else
+      rc = i2c_write_blocking(pI2C->picoI2C, iAddr, pData, iLen, true); // true to keep master control of bus
     return rc >= 0 ? iLen : 0;
 
 
@@ -101,6 +108,9 @@ int I2CReadRegister(BBI2C *pI2C, uint8_t iAddr, uint8_t u8Register, uint8_t *pDa
 {
 	int rc;
   
+    if (i2c_queue_active(pI2C->picoI2C))
+      return i2c_queue_transfer_blocking(pI2C->picoI2C, iAddr, &u8Register, 1, pData, iLen) >= 0;
+
     rc = i2c_write_blocking(pI2C->picoI2C, iAddr, &u8Register, 1, true); // true to keep master control of bus 
     if (rc >= 0) {
         rc = i2c_read_blocking(pI2C->picoI2C, iAddr, pData, iLen, false);
@@ -114,7 +124,10 @@ int I2CReadRegister(BBI2C *pI2C, uint8_t iAddr, uint8_t u8Register, uint8_t *pDa
 int I2CRead(BBI2C *pI2C, uint8_t iAddr, uint8_t *pData, int iLen)
 {
 	int rc;
-    rc = i2c_read_blocking(pI2C->picoI2C, iAddr, pData, iLen, false);
+    if (i2c_queue_active(pI2C->picoI2C))
+      rc = i2c_queue_transfer_blocking(pI2C->picoI2C, iAddr, NULL, 0, pData, iLen);
+    else
+      rc = i2c_read_blocking(pI2C->picoI2C, iAddr, pData, iLen, false);
     return (rc >= 0);
 	
 } /* I2CRead() */
@@ -0,0 +1,43 @@
+#ifndef _I2CBUS_H_
+#define _I2CBUS_H_
+
+#include <stdint.h>
+
+// Command halfwords in the IC_DATA_CMD layout, the data byte sits in the low 8 bits
+#define I2C_BUS_COMMAND_READ (1u << 8)
+#define I2C_BUS_COMMAND_STOP (1u << 9)
+#define I2C_BUS_COMMAND_RESTART (1u << 10)
+
+// Raised interrupts as interruptStatus() reports them
+#define I2C_BUS_INTERRUPT_STOP (1u << 0)
+#define I2C_BUS_INTERRUPT_ABORT (1u << 1)
+
+/**
+ * @brief The registers and DMA channels I2CQueue drives, one block each.
+ *
+ * I2CHardwareBus is the RP2040 block, the host tests swap in a mock that records every call.
+ */
+class I2CBus {
+public:
+    virtual ~I2CBus() {}
+
+    // Claims the DMA channels and routes the STOP_DET and TX_ABRT interrupts to the queue of the block
+    virtual bool claim() = 0;
+
+    // Only called between transactions, the block has to be disabled to change its target
+    virtual void setAddress(uint8_t address) = 0;
+
+    // Feeds the commands to the block and receives readLength bytes into readData
+    virtual void startTransfer(const uint16_t * commands, uint16_t count, uint8_t * readData, uint16_t readLength) = 0;
+    virtual void abortTransfer() = 0;
+
+    virtual uint32_t interruptStatus() = 0;
+    virtual void clearStop() = 0;
+    virtual void clearAbort() = 0;
+
+    virtual bool isActive() = 0;        // A master transfer is still on the wire
+    virtual bool isReceiving() = 0;     // Read bytes are still on their way into the buffer
+    virtual void flushReceive() = 0;    // Drops whatever is left in the receive FIFO
+};
+
+#endif
@@ -0,0 +1,110 @@
+#include "I2CHardwareBus.h"
+#include "I2CQueue.h"
+#include "PicoClaim.h"
+
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+static_assert(I2C_BUS_COMMAND_READ == I2C_IC_DATA_CMD_CMD_BITS, "read command bit");
+static_assert(I2C_BUS_COMMAND_STOP == I2C_IC_DATA_CMD_STOP_BITS, "stop command bit");
+static_assert(I2C_BUS_COMMAND_RESTART == I2C_IC_DATA_CMD_RESTART_BITS, "restart command bit");
+
+static I2CHardwareBus bus0(i2c0);
+static I2CHardwareBus bus1(i2c1);
+static I2CQueue queue0(bus0);
+static I2CQueue queue1(bus1);
+
+static void __not_in_flash_func(i2c0IRQ)() {
+    queue0.handleIRQ();
+}
+
+static void __not_in_flash_func(i2c1IRQ)() {
+    queue1.handleIRQ();
+}
+
+I2CQueue & I2CQueue::get(i2c_inst_t * i2c) {
+    return (i2c == i2c0) ? queue0 : queue1;
+}
+
+bool I2CHardwareBus::claim() {
+    txChannel = claimDmaChannel();
+    rxChannel = claimDmaChannel();
+    if (txChannel < 0 || rxChannel < 0) {
+        if (txChannel >= 0) {
+            dma_channel_unclaim(txChannel);
+        }
+        return false;
+    }
+
+    i2c_hw_t * hw = i2c_get_hw(i2c);
+    hw->dma_cr = I2C_IC_DMA_CR_TDMAE_BITS | I2C_IC_DMA_CR_RDMAE_BITS;
+    hw->intr_mask = I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+    (void)hw->clr_intr;
+
+    const uint irq = (i2c == i2c0) ? I2C0_IRQ : I2C1_IRQ;
+    irq_set_exclusive_handler(irq, (i2c == i2c0) ? i2c0IRQ : i2c1IRQ);
+    irq_set_enabled(irq, true);
+    return true;
+}
+
+void __not_in_flash_func(I2CHardwareBus::setAddress)(uint8_t address) {
+    i2c_hw_t * hw = i2c_get_hw(i2c);
+    hw->enable = 0;
+    hw->tar = address;
+    hw->enable = 1;
+}
+
+void __not_in_flash_func(I2CHardwareBus::startTransfer)(const uint16_t * commands, uint16_t count, uint8_t * readData, uint16_t readLength) {
+    i2c_hw_t * hw = i2c_get_hw(i2c);
+
+    if (readLength > 0) {
+        dma_channel_config rxConfig = dma_channel_get_default_config(rxChannel);
+        channel_config_set_transfer_data_size(&rxConfig, DMA_SIZE_8);
+        channel_config_set_read_increment(&rxConfig, false);
+        channel_config_set_write_increment(&rxConfig, true);
+        channel_config_set_dreq(&rxConfig, i2c_get_dreq(i2c, false));
+        dma_channel_configure(rxChannel, &rxConfig, readData, &hw->data_cmd, readLength, true);
+    }
+
+    // Halfword writes to the APB register are replicated, the upper half of IC_DATA_CMD is reserved
+    dma_channel_config txConfig = dma_channel_get_default_config(txChannel);
+    channel_config_set_transfer_data_size(&txConfig, DMA_SIZE_16);
+    channel_config_set_read_increment(&txConfig, true);
+    channel_config_set_write_increment(&txConfig, false);
+    channel_config_set_dreq(&txConfig, i2c_get_dreq(i2c, true));
+    dma_channel_configure(txChannel, &txConfig, &hw->data_cmd, commands, count, true);
+}
+
+void __not_in_flash_func(I2CHardwareBus::abortTransfer)() {
+    dma_channel_abort(txChannel);
+    dma_channel_abort(rxChannel);
+}
+
+uint32_t __not_in_flash_func(I2CHardwareBus::interruptStatus)() {
+    const uint32_t status = i2c_get_hw(i2c)->intr_stat;
+    return ((status & I2C_IC_INTR_STAT_R_STOP_DET_BITS) ? I2C_BUS_INTERRUPT_STOP : 0) |
+        ((status & I2C_IC_INTR_STAT_R_TX_ABRT_BITS) ? I2C_BUS_INTERRUPT_ABORT : 0);
+}
+
+void __not_in_flash_func(I2CHardwareBus::clearStop)() {
+    (void)i2c_get_hw(i2c)->clr_stop_det;
+}
+
+void __not_in_flash_func(I2CHardwareBus::clearAbort)() {
+    (void)i2c_get_hw(i2c)->clr_tx_abrt;
+}
+
+bool __not_in_flash_func(I2CHardwareBus::isActive)() {
+    return (i2c_get_hw(i2c)->status & I2C_IC_STATUS_MST_ACTIVITY_BITS) != 0;
+}
+
+bool __not_in_flash_func(I2CHardwareBus::isReceiving)() {
+    return dma_channel_is_busy(rxChannel);
+}
+
+void __not_in_flash_func(I2CHardwareBus::flushReceive)() {
+    i2c_hw_t * hw = i2c_get_hw(i2c);
+    while (hw->rxflr > 0) {
+        (void)hw->data_cmd;
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef _I2CHARDWAREBUS_H_
+#define _I2CHARDWAREBUS_H_
+
+#include "I2CBus.h"
+
+#include "hardware/i2c.h"
+
+// An RP2040 I2C block, the command halfwords go out and the read bytes come in over DMA
+class I2CHardwareBus : public I2CBus {
+public:
+    I2CHardwareBus(i2c_inst_t * i2c) : i2c(i2c) {}
+
+    virtual bool claim();
+    virtual void setAddress(uint8_t address);
+    virtual void startTransfer(const uint16_t * commands, uint16_t count, uint8_t * readData, uint16_t readLength);
+    virtual void abortTransfer();
+    virtual uint32_t interruptStatus();
+    virtual void clearStop();
+    virtual void clearAbort();
+    virtual bool isActive();
+    virtual bool isReceiving();
+    virtual void flushReceive();
+
+private:
+    i2c_inst_t * i2c;
+    int txChannel = -1;
+    int rxChannel = -1;
+};
+
+#endif
@@ -0,0 +1,159 @@
+#include "I2CQueue.h"
+
+#include "pico/time.h"
+
+bool I2CQueue::setup() {
+    if (active) {
+        return true;
+    }
+
+    if (!bus.claim()) {
+        return false;
+    }
+    lock = spin_lock_instance(spin_lock_claim_unused(true));
+
+    active = true;
+    return true;
+}
+
+bool I2CQueue::submit(I2CTransaction & transaction) {
+    if (!active || transaction.status == I2CTransactionStatus::PENDING ||
+        transaction.writeLength + transaction.readLength == 0 ||
+        transaction.writeLength + transaction.readLength > I2C_QUEUE_MAX_LENGTH) {
+        return false;
+    }
+
+    transaction.status = I2CTransactionStatus::PENDING;
+    transaction.next = nullptr;
+
+    const uint32_t save = spin_lock_blocking(lock);
+    const bool idle = (current == nullptr);
+    if (idle) {
+        current = &transaction;
+    } else if (tail == nullptr) {
+        head = tail = &transaction;
+    } else {
+        tail->next = &transaction;
+        tail = &transaction;
+    }
+    spin_unlock(lock, save);
+
+    if (idle) {
+        start(transaction);
+    }
+    return true;
+}
+
+int I2CQueue::transfer(uint8_t address, const uint8_t * writeData, size_t writeLength, uint8_t * readData, size_t readLength) {
+    I2CTransaction transaction = {
+        .address = address,
+        .writeData = writeData,
+        .writeLength = static_cast<uint16_t>(writeLength),
+        .readData = readData,
+        .readLength = static_cast<uint16_t>(readLength),
+        .callback = nullptr,
+        .context = nullptr,
+        .status = I2CTransactionStatus::IDLE,
+        .next = nullptr,
+    };
+    if (!submit(transaction)) {
+        return PICO_ERROR_GENERIC;
+    }
+
+    while (transaction.status == I2CTransactionStatus::PENDING) {
+        tight_loop_contents();
+    }
+    return (transaction.status == I2CTransactionStatus::DONE) ? static_cast<int>(writeLength + readLength) : PICO_ERROR_GENERIC;
+}
+
+void __not_in_flash_func(I2CQueue::start)(I2CTransaction & transaction) {
+    // The bus is idle between transactions, so the target can change here
+    bus.setAddress(transaction.address);
+
+    // One command per byte, reads turn the bus around with a repeated start and the last byte stops it
+    uint16_t count = 0;
+    for (uint16_t i = 0; i < transaction.writeLength; i++) {
+        const bool last = (i + 1 == transaction.writeLength) && transaction.readLength == 0;
+        commands[count++] = transaction.writeData[i] | (last ? I2C_BUS_COMMAND_STOP : 0);
+    }
+    for (uint16_t i = 0; i < transaction.readLength; i++) {
+        commands[count++] = I2C_BUS_COMMAND_READ |
+            ((i == 0 && transaction.writeLength > 0) ? I2C_BUS_COMMAND_RESTART : 0) |
+            ((i + 1 == transaction.readLength) ? I2C_BUS_COMMAND_STOP : 0);
+    }
+
+    bus.startTransfer(commands, count, transaction.readData, transaction.readLength);
+}
+
+void __not_in_flash_func(I2CQueue::finish)(bool success) {
+    I2CTransaction * done = current;
+
+    const uint32_t save = spin_lock_blocking(lock);
+    current = head;
+    if (head != nullptr) {
+        head = head->next;
+        if (head == nullptr) {
+            tail = nullptr;
+        }
+    }
+    spin_unlock(lock, save);
+
+    // The next transaction goes out before the callback so a slow callback doesn't hold the bus idle
+    if (current != nullptr) {
+        start(*current);
+    }
+
+    done->status = success ? I2CTransactionStatus::DONE : I2CTransactionStatus::FAILED;
+    if (done->callback != nullptr) {
+        done->callback(*done);
+    }
+}
+
+void __not_in_flash_func(I2CQueue::handleIRQ)() {
+    const uint32_t status = bus.interruptStatus();
+
+    if (status & I2C_BUS_INTERRUPT_ABORT) {
+        // NACK or lost arbitration, the block flushed its FIFO and sends a stop on its own
+        bus.abortTransfer();
+        const uint64_t deadline = time_us_64() + I2C_QUEUE_SETTLE_MICROS;
+        while (bus.isActive() && time_us_64() < deadline) {
+            tight_loop_contents();
+        }
+        bus.clearAbort();
+        bus.clearStop();
+        bus.flushReceive();
+        if (current != nullptr) {
+            finish(false);
+        }
+    } else if (status & I2C_BUS_INTERRUPT_STOP) {
+        bus.clearStop();
+        if (current == nullptr) {
+            return;
+        }
+        // The last byte is in the FIFO by the time the stop goes out, let the DMA drain it
+        const uint64_t deadline = time_us_64() + I2C_QUEUE_SETTLE_MICROS;
+        while (bus.isReceiving() && time_us_64() < deadline) {
+            tight_loop_contents();
+        }
+        const bool received = !bus.isReceiving();
+        if (!received) {
+            bus.abortTransfer();
+        }
+        finish(received);
+    }
+}
+
+extern "C" bool i2c_queue_active(i2c_inst_t * i2c) {
+    return I2CQueue::get(i2c).isActive();
+}
+
+// Resetting the block would clear the DMA and interrupt setup the running queue depends on
+extern "C" void i2c_queue_init(i2c_inst_t * i2c, uint baudrate) {
+    if (!i2c_queue_active(i2c)) {
+        i2c_init(i2c, baudrate);
+    }
+}
+
+extern "C" int i2c_queue_transfer_blocking(i2c_inst_t * i2c, uint8_t address, const uint8_t * writeData, size_t writeLength, uint8_t * readData, size_t readLength) {
+    return I2CQueue::get(i2c).transfer(address, writeData, writeLength, readData, readLength);
+}
@@ -0,0 +1,101 @@
+#ifndef _I2CQUEUE_H_
+#define _I2CQUEUE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hardware/i2c.h"
+#include "hardware/sync.h"
+
+#include "I2CBus.h"
+
+// Longest transaction, written plus read bytes, one command halfword each
+#ifndef I2C_QUEUE_MAX_LENGTH
+#define I2C_QUEUE_MAX_LENGTH 128
+#endif
+
+// Bounds the waits for the bus to go idle after an abort and for the last received byte to land
+#ifndef I2C_QUEUE_SETTLE_MICROS
+#define I2C_QUEUE_SETTLE_MICROS 200
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// True once a client has started the queue of the block, blocking users must then go through it
+bool i2c_queue_active(i2c_inst_t * i2c);
+
+// i2c_init() for clients that share a block, a block whose queue already runs is left as it is
+void i2c_queue_init(i2c_inst_t * i2c, uint baudrate);
+
+// Queues a transfer and waits for it, returns the bytes moved or PICO_ERROR_GENERIC.
+// Must not be called from a completion callback or with the queue interrupt masked
+int i2c_queue_transfer_blocking(i2c_inst_t * i2c, uint8_t address, const uint8_t * writeData, size_t writeLength, uint8_t * readData, size_t readLength);
+
+#ifdef __cplusplus
+}
+
+enum class I2CTransactionStatus : uint8_t {
+    IDLE,
+    PENDING,
+    DONE,
+    FAILED,
+};
+
+struct I2CTransaction {
+    uint8_t address;
+    const uint8_t * writeData;  // Sent first, the read follows behind a repeated start
+    uint16_t writeLength;
+    uint8_t * readData;
+    uint16_t readLength;
+    void (*callback)(I2CTransaction & transaction);  // Runs from the queue interrupt, may submit again
+    void * context;
+    volatile I2CTransactionStatus status;
+    I2CTransaction * next;
+};
+
+/**
+ * @brief Serializes transactions on one hardware I2C block and moves their bytes with DMA.
+ *
+ * Clients on either core submit transactions and get a callback from the queue interrupt once the
+ * stop condition has gone out, so a display and an input device can share a block without either
+ * one blocking on the bus. The block has to be initialised with its pins and speed before setup().
+ * Register and DMA access goes through an I2CBus, get() returns the queues on the hardware blocks.
+ */
+class I2CQueue {
+public:
+    I2CQueue(I2CBus & bus) : bus(bus) {}
+
+    static I2CQueue & get(i2c_inst_t * i2c);
+
+    // Claims the bus and a spinlock, the bus interrupt runs on the calling core. Returns false if it can't
+    bool setup();
+    bool isActive() const { return active; }
+
+    // Returns false if the queue is not running, the transaction is still queued or too long
+    bool submit(I2CTransaction & transaction);
+
+    // Submits and waits, see i2c_queue_transfer_blocking()
+    int transfer(uint8_t address, const uint8_t * writeData, size_t writeLength, uint8_t * readData, size_t readLength);
+
+    // STOP_DET and TX_ABRT handler, called by the bus
+    void handleIRQ();
+
+private:
+    void start(I2CTransaction & transaction);
+    void finish(bool success);
+
+    I2CBus & bus;
+    spin_lock_t * lock = nullptr;
+    I2CTransaction * current = nullptr;
+    I2CTransaction * head = nullptr;
+    I2CTransaction * tail = nullptr;
+    bool active = false;
+    uint16_t commands[I2C_QUEUE_MAX_LENGTH];
+};
+
+#endif
+
+#endif
@@ -0,0 +1,36 @@
+#include "PicoClaim.h"
+
+#include "hardware/dma.h"
+
+int claimDmaChannel() {
+    for (int channel = NUM_DMA_CHANNELS - 1; channel >= 0; channel--) {
+        if (!dma_channel_is_claimed(channel)) {
+            dma_channel_claim(channel);
+            return channel;
+        }
+    }
+    return -1;
+}
+
+bool claimPioStateMachine(const pio_program_t * program, PIO & pio, uint & sm, uint & offset) {
+    const PIO pios[] = { pio1, pio0 };
+    for (PIO candidate : pios) {
+        if (!pio_can_add_program(candidate, program)) {
+            continue;
+        }
+
+        for (int candidateSm = NUM_PIO_STATE_MACHINES - 1; candidateSm >= 0; candidateSm--) {
+            if (candidate == pio0 && candidateSm == 0) {
+                continue;
+            }
+            if (!pio_sm_is_claimed(candidate, candidateSm)) {
+                pio_sm_claim(candidate, candidateSm);
+                pio = candidate;
+                sm = candidateSm;
+                offset = pio_add_program(pio, program);
+                return true;
+            }
+        }
+    }
+    return false;
+}
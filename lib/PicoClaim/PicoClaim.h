@@ -0,0 +1,16 @@
+#ifndef _PICOCLAIM_H_
+#define _PICOCLAIM_H_
+
+#include "hardware/pio.h"
+
+// Hardware shared by the add-ons and drivers that set up DMA and PIO at runtime. Everything is
+// taken from the top down, PIO-USB and NeoPico start at the bottom without always claiming
+
+// Claims the highest numbered free DMA channel, -1 if there is none
+int claimDmaChannel();
+
+// Loads program on a free state machine, pio1 first. pio0 SM0 is never used, NeoPico drives it
+// without claiming it. Returns false if no PIO has both room for the program and a free state machine
+bool claimPioStateMachine(const pio_program_t * program, PIO & pio, uint & sm, uint & offset);
+
+#endif
@@ -31,8 +31,15 @@
 #else
     #include <cstring>
     #include <cstdio>
+
+    #include "snes_pad.pio.h"
+    #include "PicoClaim.h"
 #endif
 
+// Raw 16th bit of a pushed word, set when the state machine stopped after the pad bytes
+#define SNES_PIO_SHORT_PACKET   0x8000
+#define SNES_PIO_DISCONNECTED   0x80000000
+
 SNESpad::SNESpad(int clock, int latch, int data) {
     latchPin = latch;
     clockPin = clock;
@@ -46,6 +53,41 @@ void SNESpad::begin() {
 #endif
 }
 
+#ifndef ARDUINO
+bool SNESpad::beginPIO() {
+    if (!claimPioStateMachine(&snes_pad_program, pio, sm, offset)) {
+        return false;
+    }
+    snes_pad_program_init(pio, sm, offset, clockPin, latchPin, dataPin);
+
+    // one packet is always on its way, start() waits for this first one
+    request();
+#if SNES_PAD_DEBUG==true
+    printf("SNESpad::beginPIO\n");
+#endif
+    return true;
+}
+
+// pops the packet the state machine clocked in since the last request
+uint32_t SNESpad::receive(bool & disconnected) {
+    uint32_t packet = pio_sm_get_blocking(pio, sm);
+
+    if (packet & SNES_PIO_SHORT_PACKET) {
+        disconnected = (packet & SNES_PIO_DISCONNECTED);
+        packet &= 0xFFFF;
+    } else {
+        // the extra bytes were only clocked because something pulled the 16th bit low
+        disconnected = false;
+    }
+    return ~packet; // buttons are active low, so invert bits
+}
+
+// queue the next packet, the mouse speed step has to be decided before its latch
+void SNESpad::request() {
+    pio_sm_put(pio, sm, speedStep() ? 1 : 0);
+}
+#endif
+
 void SNESpad::start() {
     uint32_t packet;
 
@@ -96,6 +138,11 @@ void SNESpad::poll() {
     //printf("SNESpad::poll\n");
 #endif
 
+#ifndef ARDUINO
+    // the state machine is still clocking the requested packet, keep the last one
+    if (pio != nullptr && pio_sm_is_rx_fifo_empty(pio, sm)) return;
+#endif
+
     if (type != SNES_PAD_NONE) {
         state = read(); // polls current controller state
 
@@ -165,6 +212,10 @@ void SNESpad::poll() {
         } else {
             // device disconnected or invalid read
             type = SNES_PAD_NONE;
+#ifndef ARDUINO
+            // the next packet is still being clocked, a later poll identifies the device from it
+            if (pio == nullptr)
+#endif
             start();
         }
     } else {
@@ -196,14 +247,18 @@ void SNESpad::init() {
     return;
 }
 
+// default mouse to fastest speed
+bool SNESpad::speedStep()
+{
+    return type == SNES_PAD_MOUSE
+        && mouseSpeed != SNES_MOUSE_FAST
+        && mouseSpeedFails < SNES_MOUSE_THRESHOLD;
+}
+
 // signal mouse to go to next speed if not at desired speed
 void SNESpad::speed()
 {
-    // default mouse to fastest speed
-    if (type == SNES_PAD_MOUSE
-        && mouseSpeed != SNES_MOUSE_FAST
-        && mouseSpeedFails < SNES_MOUSE_THRESHOLD
-    ) {
+    if (speedStep()) {
 #ifdef ARDUINO
         digitalWrite(clockPin,LOW);
         delayMicroseconds(6);
@@ -268,13 +323,30 @@ void SNESpad::latch()
 }
 
 uint32_t SNESpad::read()
+{
+    uint32_t ret;
+    bool disconnected;
+
+#ifndef ARDUINO
+    if (pio != nullptr) {
+        ret = receive(disconnected);
+        ret = identify(ret, disconnected);
+        request();
+        return ret;
+    }
+#endif
+
+    ret = shiftIn(disconnected);
+    return identify(ret, disconnected);
+}
+
+uint32_t SNESpad::shiftIn(bool & disconnected)
 {
     uint32_t ret = 0;
     uint8_t i;
 
     /* A connected device will pull the data line low prior to latch.
        A disconnected pin is kept high by internal pull_up.*/
-    uint32_t disconnected = false;
 #ifdef ARDUINO
     disconnected = digitalRead(dataPin);
 #else
@@ -296,8 +368,11 @@ uint32_t SNESpad::read()
 #endif
         }
     }
-    ret = ~ret; // buttons are active low, so invert bits
+    return ~ret; // buttons are active low, so invert bits
+}
 
+uint32_t SNESpad::identify(uint32_t ret, bool disconnected)
+{
     // verify controller or mouse is connected
     if (disconnected && !(ret & 0xFFFF)) {
         type = SNES_PAD_NONE;
@@ -34,6 +34,7 @@
 #else
     // If we aren't compiling on Arduino, include the Pico SDK standard library
     #include "pico/stdlib.h"
+    #include "hardware/pio.h"
 #endif
 
 #define SNES_PAD_NONE   -1
@@ -102,6 +103,12 @@ class SNESpad {
 
     // Methods
     void begin();
+#ifndef ARDUINO
+    // Clocks packets with a PIO state machine instead of begin(), returns false if none is free.
+    // poll() then only decodes a packet the state machine finished and returns right away otherwise
+    bool beginPIO();
+    bool isPIO() const { return pio != nullptr; }
+#endif
     void start();
     void poll();
   private:
@@ -113,10 +120,22 @@ class SNESpad {
     uint8_t mouseSpeedFails = 0;
     uint32_t _lastRead;
 
+#ifndef ARDUINO
+    PIO pio = nullptr;
+    uint sm = 0;
+    uint offset = 0;
+
+    uint32_t receive(bool & disconnected);
+    void request();
+#endif
+
     void init();
+    bool speedStep();
     void speed();
     void latch();
     uint32_t read();
+    uint32_t shiftIn(bool & disconnected);
+    uint32_t identify(uint32_t ret, bool disconnected);
     uint32_t clock();
     uint8_t reverse(uint8_t c);
 };
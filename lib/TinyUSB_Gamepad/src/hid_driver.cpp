@@ -63,4 +63,4 @@ const usbd_class_driver_t hid_driver = {
 	.open = hidd_open,
 	.control_xfer_cb = hid_control_xfer_cb,
 	.xfer_cb = hidd_xfer_cb,
-	.sof = NULL};
\ No newline at end of file
+	.sof = usb_sof_cb};
\ No newline at end of file
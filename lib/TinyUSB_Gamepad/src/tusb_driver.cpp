@@ -21,6 +21,7 @@
 UsbMode usb_mode = USB_MODE_HID;
 InputMode input_mode = INPUT_MODE_XINPUT;
 bool usb_mounted = false;
+sof_callback_t sof_callback = nullptr;
 
 InputMode get_input_mode(void)
 {
@@ -79,6 +80,23 @@ void send_report(void *report, uint16_t report_size)
 	}
 }
 
+void set_sof_callback(sof_callback_t callback)
+{
+	sof_callback = callback;
+
+	// SOF interrupts are off by default, only pay for them when someone is listening
+	usbd_sof_enable(TUD_OPT_RHPORT, callback != nullptr);
+}
+
+// Class driver SOF hook, invoked from the USB IRQ once per frame
+void usb_sof_cb(uint8_t rhport, uint32_t frame_count)
+{
+	(void)rhport;
+
+	if (sof_callback != nullptr)
+		sof_callback(frame_count);
+}
+
 /* USB Driver Callback (Required for XInput) */
 
 const usbd_class_driver_t *usbd_app_driver_get_cb(uint8_t *driver_count)
@@ -14,9 +14,13 @@ typedef enum
 	USB_MODE_NET,
 } UsbMode;
 
+typedef void (*sof_callback_t)(uint32_t frame_count);
+
 InputMode get_input_mode(void);
 bool get_usb_mounted(void);
 void initialize_driver(InputMode mode);
 void receive_report(uint8_t *buffer);
 void send_report(void *report, uint16_t report_size);
+void set_sof_callback(sof_callback_t callback);
+void usb_sof_cb(uint8_t rhport, uint32_t frame_count);
 
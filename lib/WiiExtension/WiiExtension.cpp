@@ -333,314 +333,11 @@ void WiiExtension::poll() {
     if (!isReady) return;
 
     if (extensionType != WII_EXTENSION_NONE) {
-        switch (dataType) {
-            case WII_DATA_TYPE_1:
-                result = doI2CRead(regRead, 6);
-                break;
-            case WII_DATA_TYPE_2:
-                result = doI2CRead(regRead, 9);
-                break;
-            case WII_DATA_TYPE_3:
-                result = doI2CRead(regRead, 8);
-                break;
-            default:
-                // unknown. TBD
-                result = -1;
-#if WII_EXTENSION_DEBUG==true
-                printf("WiiExtension::poll Unknown data type: %1d\n", dataType);
-#endif
-                break;
-        }
+        const int length = readLength();
+        result = (length > 0) ? doI2CRead(regRead, length) : -1;
 
         if (result > 0) {
-            switch (extensionType) {
-                case WII_EXTENSION_NUNCHUCK:
-                    joy1X = (regRead[0] & 0xFF);
-                    joy1Y = (regRead[1] & 0xFF);
-
-                    accelX = (((regRead[2] << 2) | ((regRead[5] >> 2) & 0x03)));
-                    accelY = (((regRead[3] << 2) | ((regRead[5] >> 4) & 0x03)));
-                    accelZ = (((regRead[4] << 2) | ((regRead[5] >> 6) & 0x03)));
-                    buttonZ  = (!(regRead[5] & 0x01));
-                    buttonC  = (!(regRead[5] & 0x02));
-
-#if WII_EXTENSION_DEBUG==true
-                printf("Joy X=%4d Y=%4d   Acc X=%4d Y=%4d Z=%4d   Btn Z=%1d C=%1d\n", joy1X, joy1Y, accelX, accelY, accelZ, buttonZ, buttonC);
-#endif
-
-                    break;
-                case WII_EXTENSION_CLASSIC:
-                case WII_EXTENSION_CLASSIC_PRO:
-                    // write data format to return
-                    // see wiki for data types
-                    if (dataType == WII_DATA_TYPE_1) {
-                        joy1X =          (regRead[0] & 0x3F);
-                        joy1Y =          (regRead[1] & 0x3F);
-                        joy2X =          ((regRead[0] & 0xC0) >> 3) | ((regRead[1] & 0xC0) >> 5) | ((regRead[2] & 0x80) >> 7);
-                        joy2Y =          (regRead[2] & 0x1F);
-
-                        triggerLeft =    (((regRead[2] & 0x60) >> 2) | ((regRead[3] & 0xE0) >> 5));
-                        triggerRight =   ((regRead[3] & 0x1F) >> 0);
-
-                        directionRight = !((regRead[4] & 0x80) >> 7);
-                        directionDown =  !((regRead[4] & 0x40) >> 6);
-                        buttonLT =       !((regRead[4] & 0x20) >> 5);
-                        buttonMinus =    !((regRead[4] & 0x10) >> 4);
-                        buttonHome =     !((regRead[4] & 0x08) >> 3);
-                        buttonPlus =     !((regRead[4] & 0x04) >> 2);
-                        buttonRT =       !((regRead[4] & 0x02) >> 1);
-
-                        buttonZL =       !((regRead[5] & 0x80) >> 7);
-                        buttonB =        !((regRead[5] & 0x40) >> 6);
-                        buttonY =        !((regRead[5] & 0x20) >> 5);
-                        buttonA =        !((regRead[5] & 0x10) >> 4);
-                        buttonX =        !((regRead[5] & 0x08) >> 3);
-                        buttonZR =       !((regRead[5] & 0x04) >> 2);
-                        directionLeft =  !((regRead[5] & 0x02) >> 1);
-                        directionUp =    !((regRead[5] & 0x01) >> 0);
-                    } else if (dataType == WII_DATA_TYPE_2) {
-                        joy1X =          ((regRead[0] << 2) | ((regRead[4] & 0x03) >> 0));
-                        joy1Y =          ((regRead[2] << 2) | ((regRead[4] & 0x30) >> 4));
-                        joy2X =          ((regRead[1] << 2) | ((regRead[4] & 0x0C) >> 2));
-                        joy2Y =          ((regRead[3] << 2) | ((regRead[4] & 0xC0) >> 6));
-
-                        triggerLeft =    (regRead[5] & 0xFF);
-                        triggerRight =   (regRead[6] & 0xFF);
-
-                        directionRight = !((regRead[7] & 0x80) >> 7);
-                        directionDown =  !((regRead[7] & 0x40) >> 6);
-                        buttonLT =       !((regRead[7] & 0x20) >> 5);
-                        buttonMinus =    !((regRead[7] & 0x10) >> 4);
-                        buttonHome =     !((regRead[7] & 0x08) >> 3);
-                        buttonPlus =     !((regRead[7] & 0x04) >> 2);
-                        buttonRT =       !((regRead[7] & 0x02) >> 1);
-
-                        buttonZL =       !((regRead[8] & 0x80) >> 7);
-                        buttonB =        !((regRead[8] & 0x40) >> 6);
-                        buttonY =        !((regRead[8] & 0x20) >> 5);
-                        buttonA =        !((regRead[8] & 0x10) >> 4);
-                        buttonX =        !((regRead[8] & 0x08) >> 3);
-                        buttonZR =       !((regRead[8] & 0x04) >> 2);
-                        directionLeft =  !((regRead[8] & 0x02) >> 1);
-                        directionUp =    !((regRead[8] & 0x01) >> 0);
-                    } else if (dataType == WII_DATA_TYPE_3) {
-                        joy1X =          (regRead[0] & 0xFF);
-                        joy1Y =          (regRead[2] & 0xFF);
-                        joy2X =          (regRead[1] & 0xFF);
-                        joy2Y =          (regRead[3] & 0xFF);
-
-                        triggerLeft =    (regRead[4] & 0xFF);
-                        triggerRight =   (regRead[5] & 0xFF);
-
-                        directionRight = !((regRead[6] & 0x80) >> 7);
-                        directionDown =  !((regRead[6] & 0x40) >> 6);
-                        buttonLT =       !((regRead[6] & 0x20) >> 5);
-                        buttonMinus =    !((regRead[6] & 0x10) >> 4);
-                        buttonHome =     !((regRead[6] & 0x08) >> 3);
-                        buttonPlus =     !((regRead[6] & 0x04) >> 2);
-                        buttonRT =       !((regRead[6] & 0x02) >> 1);
-
-                        buttonZL =       !((regRead[7] & 0x80) >> 7);
-                        buttonB =        !((regRead[7] & 0x40) >> 6);
-                        buttonY =        !((regRead[7] & 0x20) >> 5);
-                        buttonA =        !((regRead[7] & 0x10) >> 4);
-                        buttonX =        !((regRead[7] & 0x08) >> 3);
-                        buttonZR =       !((regRead[7] & 0x04) >> 2);
-                        directionLeft =  !((regRead[7] & 0x02) >> 1);
-                        directionUp =    !((regRead[7] & 0x01) >> 0);
-                    } else {
-                        // unknown
-                    }
-
-#if WII_EXTENSION_DEBUG==true
-                //if ((_lastRead[0] != regRead[0]) || (_lastRead[1] != regRead[1]) || (_lastRead[2] != regRead[2]) || (_lastRead[3] != regRead[3])) {
-                    printf("Joy1 X=%4d Y=%4d  Joy2 X=%4d Y=%4d\n", joy1X, joy1Y, joy2X, joy2Y);
-                //}
-                //printf("Joy1 X=%4d Y=%4d  Joy2 X=%4d Y=%4d  U=%1d D=%1d L=%1d R=%1d TL=%4d TR=%4d\n", joy1X, joy1Y, joy2X, joy2Y, directionUp, directionDown, directionLeft, directionRight, triggerLeft, triggerRight);
-                //printf("A=%1d B=%1d X=%1d Y=%1d ZL=%1d ZR=%1d LT=%1d RT=%1d -=%1d H=%1d +=%1d\n", buttonA, buttonB, buttonX, buttonY, buttonZL, buttonZR, buttonLT, buttonRT, buttonMinus, buttonHome, buttonPlus);
-#endif
-
-                    break;
-                case WII_EXTENSION_GUITAR:
-                    // on first read, check the status of the guitar flag
-                    if (_guitarType == WII_GUITAR_UNSET) {
-                        if (((regRead[0] & 0x80) >> 7) == 0) {
-                            _guitarType = WII_GUITAR_GHWT;
-                        } else {
-                            _guitarType = WII_GUITAR_GH3;
-                        }
-                        // force the data type to 1 when a World Tour guitar is detected
-                        if ((_guitarType == WII_GUITAR_GHWT) && (dataType != WII_DATA_TYPE_1)) {
-                            dataType = WII_DATA_TYPE_1;
-                            _analogPrecision1From = WII_ANALOG_PRECISION_1;
-                            _analogPrecision1To = WII_ANALOG_PRECISION_3;
-                            _analogPrecision2From = WII_ANALOG_PRECISION_0;
-                            _analogPrecision2To = WII_ANALOG_PRECISION_3;
-                        }
-                    }
-                    if (_guitarType != WII_GUITAR_UNSET) {
-                        // as defined works for GH3 guitar
-                        if (dataType == WII_DATA_TYPE_1) {
-                            joy1X =          (regRead[0] & 0x3F);
-                            joy1Y =          (regRead[1] & 0x3F);
-
-                            touchBar =       ((_guitarType == WII_GUITAR_GHWT) ? (regRead[2] & 0x1F) : 0);
-
-                            whammyBar =      (regRead[3] & 0x1F);
-                            joy2X =          (regRead[3] & 0x1F);
-
-                            directionDown =  !((regRead[4] & 0x40) >> 6);
-                            buttonMinus =    !((regRead[4] & 0x10) >> 4);
-                            buttonPlus =     !((regRead[4] & 0x04) >> 2);
-
-                            fretOrange =     !((regRead[5] & 0x80) >> 7);
-                            fretRed =        !((regRead[5] & 0x40) >> 6);
-                            fretBlue =       !((regRead[5] & 0x20) >> 5);
-                            fretGreen =      !((regRead[5] & 0x10) >> 4);
-                            fretYellow =     !((regRead[5] & 0x08) >> 3);
-                            pedalButton =    !((regRead[5] & 0x04) >> 2);
-                            directionUp =    !((regRead[5] & 0x01) >> 0);
-
-                            isTouched        = (touchBar != WII_GUITAR_TOUCHPAD_NONE);
-
-                            // process the touch bar for button states
-                            // touch only seems to exist in GHWT, and GHWT always reports data type 1 format regardless of setting
-                            if (isTouched) {
-                                // touched
-                                fretGreen     = (TOUCH_BETWEEN_RANGE(touchBar,WII_GUITAR_TOUCHPAD_GREEN,WII_GUITAR_TOUCHPAD_RED));
-                                fretRed       = (TOUCH_BETWEEN_RANGE(touchBar,WII_GUITAR_TOUCHPAD_RED,WII_GUITAR_TOUCHPAD_YELLOW));
-                                fretYellow    = (TOUCH_BETWEEN_RANGE(touchBar,WII_GUITAR_TOUCHPAD_YELLOW,WII_GUITAR_TOUCHPAD_BLUE));
-                                fretBlue      = (TOUCH_BETWEEN_RANGE(touchBar,WII_GUITAR_TOUCHPAD_BLUE,WII_GUITAR_TOUCHPAD_ORANGE));
-                                fretOrange    = (TOUCH_BETWEEN_RANGE(touchBar,WII_GUITAR_TOUCHPAD_ORANGE,WII_GUITAR_TOUCHPAD_MAX));
-                                directionDown = isTouched;
-                            }
-                        } else if (dataType == WII_DATA_TYPE_2) {
-                            joy1X =          ((regRead[0] << 2) | ((regRead[4] & 0x03) >> 0));
-                            joy1Y =          ((regRead[2] << 2) | ((regRead[4] & 0x30) >> 4));
-
-                            touchBar =       0;
-
-                            whammyBar =      (regRead[6] & 0xFF);
-                            joy2X =          (regRead[6] & 0xFF);
-
-                            directionDown =  !((regRead[7] & 0x40) >> 6);
-                            buttonMinus =    !((regRead[7] & 0x10) >> 4);
-                            buttonPlus =     !((regRead[7] & 0x04) >> 2);
-
-                            fretOrange =     !((regRead[8] & 0x80) >> 7);
-                            fretRed =        !((regRead[8] & 0x40) >> 6);
-                            fretBlue =       !((regRead[8] & 0x20) >> 5);
-                            fretGreen =      !((regRead[8] & 0x10) >> 4);
-                            fretYellow =     !((regRead[8] & 0x08) >> 3);
-                            pedalButton =    !((regRead[8] & 0x04) >> 2);
-                            directionUp =    !((regRead[8] & 0x01) >> 0);
-                        } else if (dataType == WII_DATA_TYPE_3) {
-                            joy1X =          (regRead[0] & 0xFF);
-                            joy1Y =          (regRead[2] & 0xFF);
-
-                            touchBar =       0;
-
-                            whammyBar =      (regRead[5] & 0xFF);
-                            joy2X =          (regRead[5] & 0xFF);
-
-                            directionDown =  !((regRead[6] & 0x40) >> 6);
-                            buttonMinus =    !((regRead[6] & 0x10) >> 4);
-                            buttonPlus =     !((regRead[6] & 0x04) >> 2);
-
-                            fretOrange =     !((regRead[7] & 0x80) >> 7);
-                            fretRed =        !((regRead[7] & 0x40) >> 6);
-                            fretBlue =       !((regRead[7] & 0x20) >> 5);
-                            fretGreen =      !((regRead[7] & 0x10) >> 4);
-                            fretYellow =     !((regRead[7] & 0x08) >> 3);
-                            pedalButton =    !((regRead[7] & 0x04) >> 2);
-                            directionUp =    !((regRead[7] & 0x01) >> 0);
-                        }
-                    }
-#if WII_EXTENSION_DEBUG==true
-//                printf("Joy1 X=%4d Y=%4d  Whammy=%4d  U=%1d D=%1d -=%1d +=%1d\n", joy1X, joy1Y, whammyBar, directionUp, directionDown, buttonMinus, buttonPlus);
-//                printf("Joy1 X=%4d Y=%4d  Whammy=%4d  U=%1d D=%1d -=%1d +=%1d\n", joy1X, joy1Y, whammyBar, directionUp, directionDown, buttonMinus, buttonPlus);
-//                printf("O=%1d B=%1d Y=%1d R=%1d G=%1d\n", fretOrange, fretBlue, fretYellow, fretRed, fretGreen);
-#endif
-                    break;
-                case WII_EXTENSION_TAIKO:
-                    if (dataType == WII_DATA_TYPE_1) {
-                        drumLeft        = !((regRead[5] & 0x40) >> 6);
-                        rimLeft         = !((regRead[5] & 0x20) >> 5);
-                        drumRight       = !((regRead[5] & 0x10) >> 4);
-                        rimRight        = !((regRead[5] & 0x08) >> 3);
-                    } else if (dataType == WII_DATA_TYPE_2) {
-                        drumLeft        = !((regRead[8] & 0x40) >> 6);
-                        rimLeft         = !((regRead[8] & 0x20) >> 5);
-                        drumRight       = !((regRead[8] & 0x10) >> 4);
-                        rimRight        = !((regRead[8] & 0x08) >> 3);
-                    } else if (dataType == WII_DATA_TYPE_3) {
-                        drumLeft        = !((regRead[7] & 0x40) >> 6);
-                        rimLeft         = !((regRead[7] & 0x20) >> 5);
-                        drumRight       = !((regRead[7] & 0x10) >> 4);
-                        rimRight        = !((regRead[7] & 0x08) >> 3);
-                    }
-
-#if WII_EXTENSION_DEBUG==true
-                //if (_lastRead[0] != regRead[0]) printf("Byte0    " BYTE_TO_BINARY_PATTERN "\n", BYTE_TO_BINARY(regRead[0]));
-                //if (_lastRead[1] != regRead[1]) printf("Byte1    " BYTE_TO_BINARY_PATTERN "\n", BYTE_TO_BINARY(regRead[1]));
-                //if (_lastRead[2] != regRead[2]) printf("Byte2    " BYTE_TO_BINARY_PATTERN "\n", BYTE_TO_BINARY(regRead[2]));
-                //if (_lastRead[3] != regRead[3]) printf("Byte3    " BYTE_TO_BINARY_PATTERN "\n", BYTE_TO_BINARY(regRead[3]));
-                //if (_lastRead[4] != regRead[4]) printf("Byte4    " BYTE_TO_BINARY_PATTERN "\n", BYTE_TO_BINARY(regRead[4]));
-                //if (_lastRead[5] != regRead[5]) printf("Byte5    " BYTE_TO_BINARY_PATTERN "\n", BYTE_TO_BINARY(regRead[5]));
-                //
-                //if (_lastRead[7] != regRead[7]) {
-                //    printf("DL=%1d RL=%1d DR=%1d RR=%1d\n", drumLeft, rimLeft, drumRight, rimRight);
-                //}
-#endif
-
-                    break;
-            }
-
-            // calibrate and remap
-            joy1X   = map(
-                calibrate(joy1X, _minX1, _maxX1, _cenX1),
-                0+_minX1,
-                (_analogPrecision1From-_maxX1),
-                0,
-                (_analogPrecision1To-1)
-            );
-            joy1Y   = map(
-                calibrate(joy1Y, _minY1, _maxY1, _cenY1),
-                0+_minY1,
-                (_analogPrecision1From-_maxY1),
-                0,
-                (_analogPrecision1To-1)
-            );
-
-            joy2X   = map(
-                calibrate(joy2X, _minX2, _maxX2, _cenX2),
-                0+_minX2,
-                (_analogPrecision2From-_maxX2),
-                0,
-                (_analogPrecision2To-1)
-            );
-            joy2Y   = map(
-                calibrate(joy2Y, _minY2, _maxY2, _cenY2),
-                0+_minY2,
-                (_analogPrecision2From-_maxY2),
-                0,
-                (_analogPrecision2To-1)
-            );
-
-            triggerLeft  = map(
-                triggerLeft,
-                0,
-                (_triggerPrecision1From-1),
-                0,
-                (_triggerPrecision1To-1)
-            );
-            triggerRight = map(
-                triggerRight,
-                0,
-                (_triggerPrecision2From-1),
-                0,
-                (_triggerPrecision2To-1)
-            );
+            decode(regRead);
 
 #if WII_EXTENSION_DEBUG==true
             //if ((_lastRead[0] != regRead[0]) || (_lastRead[1] != regRead[1]) || (_lastRead[2] != regRead[2]) || (_lastRead[3] != regRead[3])) {
@@ -665,6 +362,415 @@ void WiiExtension::poll() {
         reset();
         start();
     }
+
+    publish();
+}
+
+int WiiExtension::readLength() {
+    switch (dataType) {
+        case WII_DATA_TYPE_1:
+            return 6;
+        case WII_DATA_TYPE_2:
+            return 9;
+        case WII_DATA_TYPE_3:
+            return 8;
+        default:
+            // unknown. TBD
+#if WII_EXTENSION_DEBUG==true
+            printf("WiiExtension::poll Unknown data type: %1d\n", dataType);
+#endif
+            return 0;
+    }
+}
+
+void WiiExtension::decode(const uint8_t *regRead) {
+    switch (extensionType) {
+        case WII_EXTENSION_NUNCHUCK:
+            joy1X = (regRead[0] & 0xFF);
+            joy1Y = (regRead[1] & 0xFF);
+
+            accelX = (((regRead[2] << 2) | ((regRead[5] >> 2) & 0x03)));
+            accelY = (((regRead[3] << 2) | ((regRead[5] >> 4) & 0x03)));
+            accelZ = (((regRead[4] << 2) | ((regRead[5] >> 6) & 0x03)));
+            buttonZ  = (!(regRead[5] & 0x01));
+            buttonC  = (!(regRead[5] & 0x02));
+
+#if WII_EXTENSION_DEBUG==true
+        printf("Joy X=%4d Y=%4d   Acc X=%4d Y=%4d Z=%4d   Btn Z=%1d C=%1d\n", joy1X, joy1Y, accelX, accelY, accelZ, buttonZ, buttonC);
+#endif
+
+            break;
+        case WII_EXTENSION_CLASSIC:
+        case WII_EXTENSION_CLASSIC_PRO:
+            // write data format to return
+            // see wiki for data types
+            if (dataType == WII_DATA_TYPE_1) {
+                joy1X =          (regRead[0] & 0x3F);
+                joy1Y =          (regRead[1] & 0x3F);
+                joy2X =          ((regRead[0] & 0xC0) >> 3) | ((regRead[1] & 0xC0) >> 5) | ((regRead[2] & 0x80) >> 7);
+                joy2Y =          (regRead[2] & 0x1F);
+
+                triggerLeft =    (((regRead[2] & 0x60) >> 2) | ((regRead[3] & 0xE0) >> 5));
+                triggerRight =   ((regRead[3] & 0x1F) >> 0);
+
+                directionRight = !((regRead[4] & 0x80) >> 7);
+                directionDown =  !((regRead[4] & 0x40) >> 6);
+                buttonLT =       !((regRead[4] & 0x20) >> 5);
+                buttonMinus =    !((regRead[4] & 0x10) >> 4);
+                buttonHome =     !((regRead[4] & 0x08) >> 3);
+                buttonPlus =     !((regRead[4] & 0x04) >> 2);
+                buttonRT =       !((regRead[4] & 0x02) >> 1);
+
+                buttonZL =       !((regRead[5] & 0x80) >> 7);
+                buttonB =        !((regRead[5] & 0x40) >> 6);
+                buttonY =        !((regRead[5] & 0x20) >> 5);
+                buttonA =        !((regRead[5] & 0x10) >> 4);
+                buttonX =        !((regRead[5] & 0x08) >> 3);
+                buttonZR =       !((regRead[5] & 0x04) >> 2);
+                directionLeft =  !((regRead[5] & 0x02) >> 1);
+                directionUp =    !((regRead[5] & 0x01) >> 0);
+            } else if (dataType == WII_DATA_TYPE_2) {
+                joy1X =          ((regRead[0] << 2) | ((regRead[4] & 0x03) >> 0));
+                joy1Y =          ((regRead[2] << 2) | ((regRead[4] & 0x30) >> 4));
+                joy2X =          ((regRead[1] << 2) | ((regRead[4] & 0x0C) >> 2));
+                joy2Y =          ((regRead[3] << 2) | ((regRead[4] & 0xC0) >> 6));
+
+                triggerLeft =    (regRead[5] & 0xFF);
+                triggerRight =   (regRead[6] & 0xFF);
+
+                directionRight = !((regRead[7] & 0x80) >> 7);
+                directionDown =  !((regRead[7] & 0x40) >> 6);
+                buttonLT =       !((regRead[7] & 0x20) >> 5);
+                buttonMinus =    !((regRead[7] & 0x10) >> 4);
+                buttonHome =     !((regRead[7] & 0x08) >> 3);
+                buttonPlus =     !((regRead[7] & 0x04) >> 2);
+                buttonRT =       !((regRead[7] & 0x02) >> 1);
+
+                buttonZL =       !((regRead[8] & 0x80) >> 7);
+                buttonB =        !((regRead[8] & 0x40) >> 6);
+                buttonY =        !((regRead[8] & 0x20) >> 5);
+                buttonA =        !((regRead[8] & 0x10) >> 4);
+                buttonX =        !((regRead[8] & 0x08) >> 3);
+                buttonZR =       !((regRead[8] & 0x04) >> 2);
+                directionLeft =  !((regRead[8] & 0x02) >> 1);
+                directionUp =    !((regRead[8] & 0x01) >> 0);
+            } else if (dataType == WII_DATA_TYPE_3) {
+                joy1X =          (regRead[0] & 0xFF);
+                joy1Y =          (regRead[2] & 0xFF);
+                joy2X =          (regRead[1] & 0xFF);
+                joy2Y =          (regRead[3] & 0xFF);
+
+                triggerLeft =    (regRead[4] & 0xFF);
+                triggerRight =   (regRead[5] & 0xFF);
+
+                directionRight = !((regRead[6] & 0x80) >> 7);
+                directionDown =  !((regRead[6] & 0x40) >> 6);
+                buttonLT =       !((regRead[6] & 0x20) >> 5);
+                buttonMinus =    !((regRead[6] & 0x10) >> 4);
+                buttonHome =     !((regRead[6] & 0x08) >> 3);
+                buttonPlus =     !((regRead[6] & 0x04) >> 2);
+                buttonRT =       !((regRead[6] & 0x02) >> 1);
+
+                buttonZL =       !((regRead[7] & 0x80) >> 7);
+                buttonB =        !((regRead[7] & 0x40) >> 6);
+                buttonY =        !((regRead[7] & 0x20) >> 5);
+                buttonA =        !((regRead[7] & 0x10) >> 4);
+                buttonX =        !((regRead[7] & 0x08) >> 3);
+                buttonZR =       !((regRead[7] & 0x04) >> 2);
+                directionLeft =  !((regRead[7] & 0x02) >> 1);
+                directionUp =    !((regRead[7] & 0x01) >> 0);
+            } else {
+                // unknown
+            }
+
+#if WII_EXTENSION_DEBUG==true
+        //if ((_lastRead[0] != regRead[0]) || (_lastRead[1] != regRead[1]) || (_lastRead[2] != regRead[2]) || (_lastRead[3] != regRead[3])) {
+            printf("Joy1 X=%4d Y=%4d  Joy2 X=%4d Y=%4d\n", joy1X, joy1Y, joy2X, joy2Y);
+        //}
+        //printf("Joy1 X=%4d Y=%4d  Joy2 X=%4d Y=%4d  U=%1d D=%1d L=%1d R=%1d TL=%4d TR=%4d\n", joy1X, joy1Y, joy2X, joy2Y, directionUp, directionDown, directionLeft, directionRight, triggerLeft, triggerRight);
+        //printf("A=%1d B=%1d X=%1d Y=%1d ZL=%1d ZR=%1d LT=%1d RT=%1d -=%1d H=%1d +=%1d\n", buttonA, buttonB, buttonX, buttonY, buttonZL, buttonZR, buttonLT, buttonRT, buttonMinus, buttonHome, buttonPlus);
+#endif
+
+            break;
+        case WII_EXTENSION_GUITAR:
+            // on first read, check the status of the guitar flag
+            if (_guitarType == WII_GUITAR_UNSET) {
+                if (((regRead[0] & 0x80) >> 7) == 0) {
+                    _guitarType = WII_GUITAR_GHWT;
+                } else {
+                    _guitarType = WII_GUITAR_GH3;
+                }
+                // force the data type to 1 when a World Tour guitar is detected
+                if ((_guitarType == WII_GUITAR_GHWT) && (dataType != WII_DATA_TYPE_1)) {
+                    dataType = WII_DATA_TYPE_1;
+                    _analogPrecision1From = WII_ANALOG_PRECISION_1;
+                    _analogPrecision1To = WII_ANALOG_PRECISION_3;
+                    _analogPrecision2From = WII_ANALOG_PRECISION_0;
+                    _analogPrecision2To = WII_ANALOG_PRECISION_3;
+                }
+            }
+            if (_guitarType != WII_GUITAR_UNSET) {
+                // as defined works for GH3 guitar
+                if (dataType == WII_DATA_TYPE_1) {
+                    joy1X =          (regRead[0] & 0x3F);
+                    joy1Y =          (regRead[1] & 0x3F);
+
+                    touchBar =       ((_guitarType == WII_GUITAR_GHWT) ? (regRead[2] & 0x1F) : 0);
+
+                    whammyBar =      (regRead[3] & 0x1F);
+                    joy2X =          (regRead[3] & 0x1F);
+
+                    directionDown =  !((regRead[4] & 0x40) >> 6);
+                    buttonMinus =    !((regRead[4] & 0x10) >> 4);
+                    buttonPlus =     !((regRead[4] & 0x04) >> 2);
+
+                    fretOrange =     !((regRead[5] & 0x80) >> 7);
+                    fretRed =        !((regRead[5] & 0x40) >> 6);
+                    fretBlue =       !((regRead[5] & 0x20) >> 5);
+                    fretGreen =      !((regRead[5] & 0x10) >> 4);
+                    fretYellow =     !((regRead[5] & 0x08) >> 3);
+                    pedalButton =    !((regRead[5] & 0x04) >> 2);
+                    directionUp =    !((regRead[5] & 0x01) >> 0);
+
+                    isTouched        = (touchBar != WII_GUITAR_TOUCHPAD_NONE);
+
+                    // process the touch bar for button states
+                    // touch only seems to exist in GHWT, and GHWT always reports data type 1 format regardless of setting
+                    if (isTouched) {
+                        // touched
+                        fretGreen     = (TOUCH_BETWEEN_RANGE(touchBar,WII_GUITAR_TOUCHPAD_GREEN,WII_GUITAR_TOUCHPAD_RED));
+                        fretRed       = (TOUCH_BETWEEN_RANGE(touchBar,WII_GUITAR_TOUCHPAD_RED,WII_GUITAR_TOUCHPAD_YELLOW));
+                        fretYellow    = (TOUCH_BETWEEN_RANGE(touchBar,WII_GUITAR_TOUCHPAD_YELLOW,WII_GUITAR_TOUCHPAD_BLUE));
+                        fretBlue      = (TOUCH_BETWEEN_RANGE(touchBar,WII_GUITAR_TOUCHPAD_BLUE,WII_GUITAR_TOUCHPAD_ORANGE));
+                        fretOrange    = (TOUCH_BETWEEN_RANGE(touchBar,WII_GUITAR_TOUCHPAD_ORANGE,WII_GUITAR_TOUCHPAD_MAX));
+                        directionDown = isTouched;
+                    }
+                } else if (dataType == WII_DATA_TYPE_2) {
+                    joy1X =          ((regRead[0] << 2) | ((regRead[4] & 0x03) >> 0));
+                    joy1Y =          ((regRead[2] << 2) | ((regRead[4] & 0x30) >> 4));
+
+                    touchBar =       0;
+
+                    whammyBar =      (regRead[6] & 0xFF);
+                    joy2X =          (regRead[6] & 0xFF);
+
+                    directionDown =  !((regRead[7] & 0x40) >> 6);
+                    buttonMinus =    !((regRead[7] & 0x10) >> 4);
+                    buttonPlus =     !((regRead[7] & 0x04) >> 2);
+
+                    fretOrange =     !((regRead[8] & 0x80) >> 7);
+                    fretRed =        !((regRead[8] & 0x40) >> 6);
+                    fretBlue =       !((regRead[8] & 0x20) >> 5);
+                    fretGreen =      !((regRead[8] & 0x10) >> 4);
+                    fretYellow =     !((regRead[8] & 0x08) >> 3);
+                    pedalButton =    !((regRead[8] & 0x04) >> 2);
+                    directionUp =    !((regRead[8] & 0x01) >> 0);
+                } else if (dataType == WII_DATA_TYPE_3) {
+                    joy1X =          (regRead[0] & 0xFF);
+                    joy1Y =          (regRead[2] & 0xFF);
+
+                    touchBar =       0;
+
+                    whammyBar =      (regRead[5] & 0xFF);
+                    joy2X =          (regRead[5] & 0xFF);
+
+                    directionDown =  !((regRead[6] & 0x40) >> 6);
+                    buttonMinus =    !((regRead[6] & 0x10) >> 4);
+                    buttonPlus =     !((regRead[6] & 0x04) >> 2);
+
+                    fretOrange =     !((regRead[7] & 0x80) >> 7);
+                    fretRed =        !((regRead[7] & 0x40) >> 6);
+                    fretBlue =       !((regRead[7] & 0x20) >> 5);
+                    fretGreen =      !((regRead[7] & 0x10) >> 4);
+                    fretYellow =     !((regRead[7] & 0x08) >> 3);
+                    pedalButton =    !((regRead[7] & 0x04) >> 2);
+                    directionUp =    !((regRead[7] & 0x01) >> 0);
+                }
+            }
+#if WII_EXTENSION_DEBUG==true
+//                printf("Joy1 X=%4d Y=%4d  Whammy=%4d  U=%1d D=%1d -=%1d +=%1d\n", joy1X, joy1Y, whammyBar, directionUp, directionDown, buttonMinus, buttonPlus);
+//                printf("Joy1 X=%4d Y=%4d  Whammy=%4d  U=%1d D=%1d -=%1d +=%1d\n", joy1X, joy1Y, whammyBar, directionUp, directionDown, buttonMinus, buttonPlus);
+//                printf("O=%1d B=%1d Y=%1d R=%1d G=%1d\n", fretOrange, fretBlue, fretYellow, fretRed, fretGreen);
+#endif
+            break;
+        case WII_EXTENSION_TAIKO:
+            if (dataType == WII_DATA_TYPE_1) {
+                drumLeft        = !((regRead[5] & 0x40) >> 6);
+                rimLeft         = !((regRead[5] & 0x20) >> 5);
+                drumRight       = !((regRead[5] & 0x10) >> 4);
+                rimRight        = !((regRead[5] & 0x08) >> 3);
+            } else if (dataType == WII_DATA_TYPE_2) {
+                drumLeft        = !((regRead[8] & 0x40) >> 6);
+                rimLeft         = !((regRead[8] & 0x20) >> 5);
+                drumRight       = !((regRead[8] & 0x10) >> 4);
+                rimRight        = !((regRead[8] & 0x08) >> 3);
+            } else if (dataType == WII_DATA_TYPE_3) {
+                drumLeft        = !((regRead[7] & 0x40) >> 6);
+                rimLeft         = !((regRead[7] & 0x20) >> 5);
+                drumRight       = !((regRead[7] & 0x10) >> 4);
+                rimRight        = !((regRead[7] & 0x08) >> 3);
+            }
+
+#if WII_EXTENSION_DEBUG==true
+        //if (_lastRead[0] != regRead[0]) printf("Byte0    " BYTE_TO_BINARY_PATTERN "\n", BYTE_TO_BINARY(regRead[0]));
+        //if (_lastRead[1] != regRead[1]) printf("Byte1    " BYTE_TO_BINARY_PATTERN "\n", BYTE_TO_BINARY(regRead[1]));
+        //if (_lastRead[2] != regRead[2]) printf("Byte2    " BYTE_TO_BINARY_PATTERN "\n", BYTE_TO_BINARY(regRead[2]));
+        //if (_lastRead[3] != regRead[3]) printf("Byte3    " BYTE_TO_BINARY_PATTERN "\n", BYTE_TO_BINARY(regRead[3]));
+        //if (_lastRead[4] != regRead[4]) printf("Byte4    " BYTE_TO_BINARY_PATTERN "\n", BYTE_TO_BINARY(regRead[4]));
+        //if (_lastRead[5] != regRead[5]) printf("Byte5    " BYTE_TO_BINARY_PATTERN "\n", BYTE_TO_BINARY(regRead[5]));
+        //
+        //if (_lastRead[7] != regRead[7]) {
+        //    printf("DL=%1d RL=%1d DR=%1d RR=%1d\n", drumLeft, rimLeft, drumRight, rimRight);
+        //}
+#endif
+
+            break;
+    }
+
+    // calibrate and remap
+    joy1X   = map(
+        calibrate(joy1X, _minX1, _maxX1, _cenX1),
+        0+_minX1,
+        (_analogPrecision1From-_maxX1),
+        0,
+        (_analogPrecision1To-1)
+    );
+    joy1Y   = map(
+        calibrate(joy1Y, _minY1, _maxY1, _cenY1),
+        0+_minY1,
+        (_analogPrecision1From-_maxY1),
+        0,
+        (_analogPrecision1To-1)
+    );
+
+    joy2X   = map(
+        calibrate(joy2X, _minX2, _maxX2, _cenX2),
+        0+_minX2,
+        (_analogPrecision2From-_maxX2),
+        0,
+        (_analogPrecision2To-1)
+    );
+    joy2Y   = map(
+        calibrate(joy2Y, _minY2, _maxY2, _cenY2),
+        0+_minY2,
+        (_analogPrecision2From-_maxY2),
+        0,
+        (_analogPrecision2To-1)
+    );
+
+    triggerLeft  = map(
+        triggerLeft,
+        0,
+        (_triggerPrecision1From-1),
+        0,
+        (_triggerPrecision1To-1)
+    );
+    triggerRight = map(
+        triggerRight,
+        0,
+        (_triggerPrecision2From-1),
+        0,
+        (_triggerPrecision2To-1)
+    );
+}
+
+bool WiiExtension::beginBackground() {
+    // Every transfer on the block goes through the queue from here on, blocking ones included
+    pollQueue = &I2CQueue::get(picoI2C);
+    if (!pollQueue->setup()) {
+        pollQueue = nullptr;
+        return false;
+    }
+
+    pollRead = {
+        .address = address,
+        .readData = pollData,
+        .callback = pollReadDone,
+        .context = this,
+    };
+    pollPointer = {
+        .address = address,
+        .writeData = pollPointerData,
+        .writeLength = sizeof(pollPointerData),
+        .callback = pollPointerDone,
+        .context = this,
+    };
+
+    publish();
+    if (extensionType != WII_EXTENSION_NONE) {
+        startBackground();
+    }
+    return true;
+}
+
+void WiiExtension::update() {
+    if (polling) return;
+
+    // the extension stopped answering or was never there, identify it again the same way poll() does
+    extensionType = WII_EXTENSION_NONE;
+    reset();
+    start();
+    publish();
+
+    if (extensionType != WII_EXTENSION_NONE) {
+        startBackground();
+    }
+}
+
+void WiiExtension::publish() {
+    const uint8_t back = stateFront ^ 1;
+    states[back] = static_cast<const WiiExtensionState &>(*this);
+    __compiler_memory_barrier();
+    stateFront = back;
+}
+
+void WiiExtension::startBackground() {
+    // start() left the register pointer at 0x00, the first read can go out right away
+    polling = true;
+    pollRead.readLength = readLength();
+    if (!pollQueue->submit(pollRead)) {
+        polling = false;
+    }
+}
+
+void WiiExtension::schedule(I2CTransaction & transaction) {
+    pollNext = &transaction;
+    if (add_alarm_in_us(WII_EXTENSION_DELAY, pollAlarm, this, true) < 0) {
+        polling = false;
+    }
+}
+
+int64_t WiiExtension::pollAlarm(alarm_id_t id, void *user_data) {
+    WiiExtension *wii = static_cast<WiiExtension *>(user_data);
+    if (!wii->pollQueue->submit(*wii->pollNext)) {
+        wii->polling = false;
+    }
+    return 0;
+}
+
+void WiiExtension::pollReadDone(I2CTransaction & transaction) {
+    WiiExtension *wii = static_cast<WiiExtension *>(transaction.context);
+    if (transaction.status != I2CTransactionStatus::DONE) {
+        // update() picks the extension up again from the main loop
+        wii->polling = false;
+        return;
+    }
+
+    wii->decode(wii->pollData);
+    wii->publish();
+    wii->schedule(wii->pollPointer);
+}
+
+void WiiExtension::pollPointerDone(I2CTransaction & transaction) {
+    WiiExtension *wii = static_cast<WiiExtension *>(transaction.context);
+    if (transaction.status != I2CTransactionStatus::DONE) {
+        wii->polling = false;
+        return;
+    }
+
+    // decoding a guitar can change the data type, size the next read from it
+    wii->pollRead.readLength = wii->readLength();
+    wii->schedule(wii->pollRead);
 }
 
 uint16_t WiiExtension::map(uint16_t x, uint16_t in_min, uint16_t in_max, uint16_t out_min, uint16_t out_max) {
@@ -694,13 +800,17 @@ uint16_t WiiExtension::calibrate(uint16_t pos, uint16_t min, uint16_t max, uint1
 }
 
 int WiiExtension::doI2CWrite(uint8_t *pData, int iLen) {
-    int result = i2c_write_blocking(picoI2C, address, pData, iLen, false);
+    int result = i2c_queue_active(picoI2C) ?
+        i2c_queue_transfer_blocking(picoI2C, address, pData, iLen, nullptr, 0) :
+        i2c_write_blocking(picoI2C, address, pData, iLen, false);
     waitUntil_us(WII_EXTENSION_DELAY);
     return result;
 }
 
 int WiiExtension::doI2CRead(uint8_t *pData, int iLen) {
-    int result = i2c_read_blocking(picoI2C, address, pData, iLen, false);
+    int result = i2c_queue_active(picoI2C) ?
+        i2c_queue_transfer_blocking(picoI2C, address, nullptr, 0, pData, iLen) :
+        i2c_read_blocking(picoI2C, address, pData, iLen, false);
     waitUntil_us(WII_EXTENSION_DELAY);
     return result;
 }
@@ -716,7 +826,8 @@ void WiiExtension::doI2CInit() {
 	if ((iSDA + 2 * i2c_hw_index(picoI2C))%4 != 0) return;
 	if ((iSCL + 3 + 2 * i2c_hw_index(picoI2C))%4 != 0) return;
 
-    i2c_init(picoI2C, iSpeed);
+    // Another add-on may already run the queue on this block, a reset would stall it
+    i2c_queue_init(picoI2C, iSpeed);
     gpio_set_function(iSDA, GPIO_FUNC_I2C);
     gpio_set_function(iSCL, GPIO_FUNC_I2C);
     gpio_pull_up(iSDA);
@@ -7,6 +7,8 @@
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
 
+#include "I2CQueue.h"
+
 #define WII_EXTENSION_NONE          -1
 #define WII_EXTENSION_NUNCHUCK      0
 #define WII_EXTENSION_CLASSIC       1
@@ -82,12 +84,9 @@ static volatile bool WiiExtension_alarmFired;
 
 #define TOUCH_BETWEEN_RANGE(val,beg,end) (((val) >= ((beg)-WII_GUITAR_TOUCHPAD_OVERLAP)) && ((val) < (end)))
 
-class WiiExtension {
-  protected:
-	uint8_t address;
-  public:
+// Decoded input of the attached extension, a copy of it is handed to the reader after every poll
+struct WiiExtensionState {
     int8_t extensionType = WII_EXTENSION_NONE;
-    int8_t dataType = WII_DATA_TYPE_0;
 
     uint16_t joy1X        = 0;
     uint16_t joy1Y        = 0;
@@ -134,6 +133,13 @@ class WiiExtension {
     bool rimRight        = false;
     bool drumLeft        = false;
     bool drumRight       = false;
+};
+
+class WiiExtension : public WiiExtensionState {
+  protected:
+	uint8_t address;
+  public:
+    int8_t dataType = WII_DATA_TYPE_0;
 
     bool isReady         = false;
 
@@ -145,6 +151,14 @@ class WiiExtension {
 	void reset();
   	void start();
   	void poll();
+
+    // Polls from the I2C queue interrupt and an alarm instead of the caller, the read and the pointer
+    // write each still wait WII_EXTENSION_DELAY. Returns false if the queue can't run, poll() is left then
+    bool beginBackground();
+    // Identifies the extension again once background polling dropped it, blocks only while nothing answers
+    void update();
+    // Latest decoded state, copy it before use
+    const WiiExtensionState & getState() const { return states[stateFront]; }
   private:
 	
     uint8_t iSDA;
@@ -196,6 +210,26 @@ class WiiExtension {
 
     uint8_t _guitarType   = WII_GUITAR_UNSET;
 
+    WiiExtensionState states[2];
+    volatile uint8_t stateFront = 0;
+
+    I2CQueue *pollQueue = nullptr;
+    I2CTransaction pollRead;
+    I2CTransaction pollPointer;
+    I2CTransaction *pollNext = nullptr;
+    uint8_t pollData[16];
+    uint8_t pollPointerData[1] = { 0x00 };
+    volatile bool polling = false;
+
+    int readLength();
+    void decode(const uint8_t *regRead);
+    void publish();
+    void startBackground();
+    void schedule(I2CTransaction & transaction);
+    static int64_t pollAlarm(alarm_id_t id, void *user_data);
+    static void pollReadDone(I2CTransaction & transaction);
+    static void pollPointerDone(I2CTransaction & transaction);
+
     uint16_t map(uint16_t x, uint16_t in_min, uint16_t in_max, uint16_t out_min, uint16_t out_max);
     uint16_t calibrate(uint16_t pos, uint16_t min, uint16_t max, uint16_t center);
 
@@ -0,0 +1,126 @@
+#include "adcsampler.h"
+
+#include <algorithm>
+
+#include "hardware/adc.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "pico/time.h"
+
+#include "PicoClaim.h"
+
+// Written by DMA only, one round-robin pass after another
+static volatile uint16_t ring[ADC_SAMPLER_CHANNELS * ADC_SAMPLER_DEPTH];
+// Source of the control channel, rewinds the data channel at the end of the ring
+static volatile uint16_t * ringStart = ring;
+
+static uint8_t channelMask = 0;
+static uint8_t channelSlot[ADC_SAMPLER_CHANNELS];
+static uint32_t slotCount = 0;
+static uint32_t ringLength = 0;
+static uint32_t averageCount = 1;
+static int dataChannel = -1;
+static int controlChannel = -1;
+static bool active = false;
+
+void AdcSampler::enableChannel(uint8_t channel) {
+    if (channel < ADC_SAMPLER_CHANNELS) {
+        channelMask |= (1 << channel);
+    }
+}
+
+void AdcSampler::setup(bool enabled, uint32_t averageSamples) {
+    if (!enabled || active || channelMask == 0) {
+        return;
+    }
+
+    dataChannel = claimDmaChannel();
+    controlChannel = claimDmaChannel();
+    if (dataChannel < 0 || controlChannel < 0) {
+        if (dataChannel >= 0) {
+            dma_channel_unclaim(dataChannel);
+        }
+        return;
+    }
+
+    // The ring holds whole passes so every input keeps the same slot when it wraps
+    slotCount = 0;
+    for (uint8_t channel = 0; channel < ADC_SAMPLER_CHANNELS; channel++) {
+        if (channelMask & (1 << channel)) {
+            channelSlot[channel] = slotCount++;
+        }
+    }
+    ringLength = slotCount * ADC_SAMPLER_DEPTH;
+    averageCount = std::clamp<uint32_t>(averageSamples, 1, ADC_SAMPLER_DEPTH / 2);
+
+    adc_run(false);
+    adc_fifo_drain();
+    adc_fifo_setup(true, true, 1, false, false);
+    adc_set_clkdiv((float)clock_get_hz(clk_adc) / ADC_SAMPLER_SAMPLE_HZ - 1);
+    // Round robin starts at the selected input and moves on after every conversion
+    adc_select_input(__builtin_ctz(channelMask));
+    adc_set_round_robin(channelMask);
+
+    // ADC FIFO -> ring, paced by the ADC
+    dma_channel_config dataConfig = dma_channel_get_default_config(dataChannel);
+    channel_config_set_transfer_data_size(&dataConfig, DMA_SIZE_16);
+    channel_config_set_read_increment(&dataConfig, false);
+    channel_config_set_write_increment(&dataConfig, true);
+    channel_config_set_dreq(&dataConfig, DREQ_ADC);
+    channel_config_set_chain_to(&dataConfig, controlChannel);
+    dma_channel_configure(dataChannel, &dataConfig, ring, &adc_hw->fifo, ringLength, false);
+
+    // Rewinds and retriggers the data channel, the ADC FIFO covers the gap
+    dma_channel_config controlConfig = dma_channel_get_default_config(controlChannel);
+    channel_config_set_transfer_data_size(&controlConfig, DMA_SIZE_32);
+    channel_config_set_read_increment(&controlConfig, false);
+    channel_config_set_write_increment(&controlConfig, false);
+    dma_channel_configure(controlChannel, &controlConfig, &dma_hw->ch[dataChannel].al2_write_addr_trig, &ringStart, 1, false);
+
+    dma_channel_start(dataChannel);
+    adc_run(true);
+
+    // Let one full ring land so the first reads are real samples
+    busy_wait_us(ringLength * 1000000 / ADC_SAMPLER_SAMPLE_HZ + 1);
+    active = true;
+}
+
+bool AdcSampler::isActive() {
+    return active;
+}
+
+uint8_t AdcSampler::getChannelMask() {
+    return channelMask;
+}
+
+uint16_t AdcSampler::read(uint8_t channel) {
+    return read(channel, averageCount);
+}
+
+uint16_t AdcSampler::read(uint8_t channel, uint32_t samples) {
+    samples = std::clamp<uint32_t>(samples, 1, ADC_SAMPLER_DEPTH / 2);
+
+    uint32_t sum = 0;
+    if (!active) {
+        adc_select_input(channel);
+        for (uint32_t i = 0; i < samples; i++) {
+            sum += adc_read();
+        }
+        return sum / samples;
+    }
+
+    if (channel >= ADC_SAMPLER_CHANNELS || !(channelMask & (1 << channel))) {
+        return 0;
+    }
+
+    // Newest completed sample of the input, taken from the previous pass when the current one has not reached it yet
+    const uint32_t written = (dma_hw->ch[dataChannel].write_addr - reinterpret_cast<uint32_t>(ring)) / sizeof(uint16_t);
+    const uint32_t slot = channelSlot[channel];
+    uint32_t index = ((written + ringLength - 1 - slot) / slotCount * slotCount + slot) % ringLength;
+
+    for (uint32_t i = 0; i < samples; i++) {
+        sum += ring[index];
+        index = (index >= slotCount) ? index - slotCount : index + ringLength - slotCount;
+    }
+    return sum / samples;
+}
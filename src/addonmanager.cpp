@@ -1,11 +1,41 @@
 #include "addonmanager.h"
+#include "system.h"
 
-void AddonManager::LoadAddon(GPAddon* addon, ADDON_PROCESS processAt) {
+#include <cstring>
+
+#include "pico/platform.h"
+#include "hardware/clocks.h"
+
+#define ADDON_PROFILE_MAGIC 0x41505246
+
+// Kept out of .bss so the numbers from a gamepad session can still be read after rebooting into webconfig
+static AddonProfileTable __uninitialized_ram(profileTable);
+static bool profilingEnabled = false;
+
+static void recordProfile(AddonProfile & profile, uint32_t startCycles) {
+    const uint32_t cycles = System::getCyclesElapsed(startCycles, System::getCycleCount());
+    profile.calls++;
+    profile.totalCycles += cycles;
+    if (cycles > profile.worstCycles)
+        profile.worstCycles = cycles;
+}
+
+void AddonManager::LoadAddon(GPAddon* addon, ADDON_PROCESS processAt, const AddonSchedule & schedule) {
     if (addon->available()) {
         AddonBlock * block = new AddonBlock;
 		addon->setup();
         block->ptr = addon;
         block->process = processAt;
+        block->schedule = schedule;
+        if (block->schedule.periodMicros == 0)
+            block->schedule.periodMicros = GAMEPAD_POLL_MICRO;
+        block->releaseTime = getMicro();
+        block->profile = nullptr;
+        if (profilingEnabled && profileTable.count < ADDON_PROFILE_MAX) {
+            block->profile = &profileTable.entries[profileTable.count++];
+            strncpy(block->profile->name, addon->name().c_str(), ADDON_PROFILE_NAME_LENGTH - 1);
+            block->profile->processType = processAt;
+        }
         addons.push_back(block);
 	} else {
         delete addon; // Don't use the memory if we don't have to
@@ -16,19 +46,72 @@ void AddonManager::LoadAddon(GPAddon* addon, ADDON_PROCESS processAt) {
 void AddonManager::PreprocessAddons(ADDON_PROCESS processType) {
     // Loop through all addons and process any that match our type
     for (std::vector<AddonBlock*>::iterator it = addons.begin(); it != addons.end(); it++) {
-        if ( (*it)->process == processType )
+        if ( (*it)->process == processType ) {
+            const uint32_t start = System::getCycleCount();
             (*it)->ptr->preprocess();
+            if ( (*it)->profile != nullptr )
+                recordProfile((*it)->profile->preprocess, start);
+        }
     }
 }
 
 void AddonManager::ProcessAddons(ADDON_PROCESS processType) {
     // Loop through all addons and process any that match our type
     for (std::vector<AddonBlock*>::iterator it = addons.begin(); it != addons.end(); it++) {
-        if ( (*it)->process == processType )
+        if ( (*it)->process == processType ) {
+            const uint32_t start = System::getCycleCount();
             (*it)->ptr->process();
+            if ( (*it)->profile != nullptr )
+                recordProfile((*it)->profile->process, start);
+        }
     }
 }
 
+uint64_t AddonManager::ScheduleAddons(ADDON_PROCESS processType) {
+    // Earliest deadline first among the due add-ons, background add-ons only when nothing else is due
+    const uint64_t now = getMicro();
+    AddonBlock * next = nullptr;
+    for (std::vector<AddonBlock*>::iterator it = addons.begin(); it != addons.end(); it++) {
+        if ( (*it)->process != processType || (*it)->releaseTime > now )
+            continue;
+        if ( next == nullptr
+            || (next->schedule.background && !(*it)->schedule.background)
+            || (next->schedule.background == (*it)->schedule.background
+                && (*it)->releaseTime + (*it)->schedule.periodMicros < next->releaseTime + next->schedule.periodMicros) )
+            next = *it;
+    }
+
+    if (next != nullptr) {
+        const uint32_t startCycles = System::getCycleCount();
+        const uint64_t start = getMicro();
+        next->ptr->process();
+        const uint64_t end = getMicro();
+
+        const uint32_t period = next->schedule.periodMicros;
+        const uint64_t deadline = next->releaseTime + period;
+        if (next->profile != nullptr) {
+            recordProfile(next->profile->process, startCycles);
+            if (next->schedule.budgetMicros > 0 && end - start > next->schedule.budgetMicros)
+                next->profile->overruns++;
+            if (!next->schedule.background && end > deadline)
+                next->profile->deadlineMisses++;
+        }
+
+        // Drop the periods we missed instead of running back to back to catch up
+        next->releaseTime = deadline;
+        if (next->releaseTime <= end)
+            next->releaseTime += ((end - next->releaseTime) / period + 1) * period;
+    }
+
+    // Wake up at least every ADDON_SCHEDULE_MAX_IDLE_MICRO even with nothing scheduled
+    uint64_t nextRelease = getMicro() + ADDON_SCHEDULE_MAX_IDLE_MICRO;
+    for (std::vector<AddonBlock*>::iterator it = addons.begin(); it != addons.end(); it++) {
+        if ( (*it)->process == processType && (*it)->releaseTime < nextRelease )
+            nextRelease = (*it)->releaseTime;
+    }
+    return nextRelease;
+}
+
 // HACK : change this for NeoPicoLED
 GPAddon * AddonManager::GetAddon(std::string name) { // hack for NeoPicoLED
     for (std::vector<AddonBlock*>::iterator it = addons.begin(); it != addons.end(); it++) {
@@ -37,3 +120,14 @@ GPAddon * AddonManager::GetAddon(std::string name) { // hack for NeoPicoLED
     }
     return nullptr;
 }
+
+void AddonManager::EnableProfiling() {
+    memset(&profileTable, 0, sizeof(profileTable));
+    profileTable.clockHz = clock_get_hz(clk_sys);
+    profileTable.magic = ADDON_PROFILE_MAGIC;
+    profilingEnabled = true;
+}
+
+const AddonProfileTable * AddonManager::GetProfiles() {
+    return profileTable.magic == ADDON_PROFILE_MAGIC ? &profileTable : nullptr;
+}
@@ -1,168 +1,309 @@
 #include "addons/analog.h"
 #include "storagemanager.h"
 #include "helper.h"
+#include "adcsampler.h"
 #include "config.pb.h"
 
 #include "enums.pb.h"
 
 #include "hardware/adc.h"
 
-#include <math.h>
+#include <algorithm>
+#include <cstdlib>
 
 #define ADC_MAX ((1 << 12) - 1)
-#define ANALOG_CENTER 0.5f // 0.5f is center
-#define ANALOG_MAX 1.0f    // 1.0f is max
+#define ANALOG_MAX 0xFFFF
+#define ANALOG_RADIUS 0x7FFF
+#define ANALOG_ORIGIN 0x8000   // Signed offsets are taken from here so squares stay within 32 bits
+
+#define ANALOG_FILTER_FRACTION_BITS 6
+#define ANALOG_FILTER_MAX_STEP_MICROS 50000     // Longer gaps count as this, keeps the Q16 factor math within 32 bits
+#define ANALOG_FILTER_SPEED_CUTOFF 1000         // mHz, fixed cutoff of the one-euro speed estimate
+#define ANALOG_FILTER_MAX_CUTOFF 1000000        // mHz, past this the one-euro filter passes readings straight through
+#define ANALOG_FILTER_TAU_SCALE 159154943       // 1e9 / (2 * pi), turns a cutoff in mHz into a time constant in us
+#define ANALOG_THROW_SPEED_SCALE 15259          // 1e9 / ANALOG_MAX, 16-bit units per us to thousandths of a throw per second
+
+// Bit by bit integer square root, 16 iterations for any 32-bit input
+static uint32_t isqrt(uint32_t value) {
+    uint32_t root = 0;
+    uint32_t bit = 1UL << 30;
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
 
 bool AnalogInput::available() {
     return Storage::getInstance().getAddonOptions().analogOptions.enabled;
 }
 
+// Q16 weight of a new reading for a first order low-pass at the cutoff
+static uint32_t smoothingFactor(uint32_t cutoffMilliHz, uint32_t elapsedMicros) {
+    const uint32_t tau = ANALOG_FILTER_TAU_SCALE / std::max<uint32_t>(cutoffMilliHz, 1);
+    return (elapsedMicros << 16) / (elapsedMicros + tau);
+}
+
+static bool isValidCalibration(uint32_t min, uint32_t center, uint32_t max) {
+    return max <= ADC_MAX &&
+        center >= min + ANALOG_CALIBRATION_MIN_SPAN &&
+        max >= center + ANALOG_CALIBRATION_MIN_SPAN;
+}
+
 void AnalogInput::setup() {
     const AnalogOptions& analogOptions = Storage::getInstance().getAddonOptions().analogOptions;
 
-    // Make sure GPIO is high-impedance, no pullups etc
-    if ( isValidPin(analogOptions.analogAdc1PinX) ) {
-        adc_gpio_init(analogOptions.analogAdc1PinX);
-    }
-    if ( isValidPin(analogOptions.analogAdc1PinY) ) {
-        adc_gpio_init(analogOptions.analogAdc1PinY);
-    }
-    if ( isValidPin(analogOptions.analogAdc2PinX) ) {
-        adc_gpio_init(analogOptions.analogAdc2PinX);
-    }
-    if ( isValidPin(analogOptions.analogAdc2PinY) ) {
-        adc_gpio_init(analogOptions.analogAdc2PinY);
-    }
-	
-	// Read pins deviation from center for calibration
-	if (analogOptions.auto_calibrate) {
-		if ( isValidPin(analogOptions.analogAdc1PinX) ) {
-			adc_select_input(analogOptions.analogAdc1PinX-26); // ANALOG1-X
-			adc_1_x_center = adc_read();
-		}
-		if ( isValidPin(analogOptions.analogAdc1PinY) ) {
-			adc_select_input(analogOptions.analogAdc1PinY-26); // ANALOG1-Y
-			adc_1_y_center = adc_read();
-		}
-		if ( isValidPin(analogOptions.analogAdc2PinX) ) {
-			adc_select_input(analogOptions.analogAdc2PinX-26); // ANALOG2-X
-			adc_2_x_center = adc_read();
-		}
-		if ( isValidPin(analogOptions.analogAdc2PinY) ) {
-			adc_select_input(analogOptions.analogAdc2PinY-26); // ANALOG2-Y
-			adc_2_y_center = adc_read();
-		}
-	}
+    setupAxis(adc1X, analogOptions.analogAdc1PinX,
+        analogOptions.analogAdc1Invert == InvertMode::INVERT_X || analogOptions.analogAdc1Invert == InvertMode::INVERT_XY,
+        analogOptions.auto_calibrate, analogOptions.adc1XCalibration, analogOptions.analogAdc1Filter);
+    setupAxis(adc1Y, analogOptions.analogAdc1PinY,
+        analogOptions.analogAdc1Invert == InvertMode::INVERT_Y || analogOptions.analogAdc1Invert == InvertMode::INVERT_XY,
+        analogOptions.auto_calibrate, analogOptions.adc1YCalibration, analogOptions.analogAdc1Filter);
+    setupAxis(adc2X, analogOptions.analogAdc2PinX,
+        analogOptions.analogAdc2Invert == InvertMode::INVERT_X || analogOptions.analogAdc2Invert == InvertMode::INVERT_XY,
+        analogOptions.auto_calibrate, analogOptions.adc2XCalibration, analogOptions.analogAdc2Filter);
+    setupAxis(adc2Y, analogOptions.analogAdc2PinY,
+        analogOptions.analogAdc2Invert == InvertMode::INVERT_Y || analogOptions.analogAdc2Invert == InvertMode::INVERT_XY,
+        analogOptions.auto_calibrate, analogOptions.adc2YCalibration, analogOptions.analogAdc2Filter);
+
+    // Percent of the full throw, split across both sides of the center
+    deadzone = analogOptions.analog_deadzone * ANALOG_MAX / 200;
+    radialDeadzone = analogOptions.radial_deadzone;
+
+    filterSamples = std::clamp<uint32_t>(analogOptions.analogFilterSamples, 1, ADC_SAMPLER_DEPTH / 2);
+    emaAlpha = std::clamp<uint32_t>(analogOptions.analogFilterEmaAlpha, 1, 100) * 256 / 100;
+    minCutoff = analogOptions.analogFilterMinCutoff * 100;
+    beta = analogOptions.analogFilterBeta;
+    lastFilterMicros = getMicro();
 }
 
-void AnalogInput::process()
-{
-    const AnalogOptions& analogOptions = Storage::getInstance().getAddonOptions().analogOptions;
-    Gamepad * gamepad = Storage::getInstance().GetGamepad();
-    float adc_1_x = ANALOG_CENTER;
-    float adc_1_y = ANALOG_CENTER;
-    float adc_2_x = ANALOG_CENTER;
-    float adc_2_y = ANALOG_CENTER;
-    float adc_deadzone = analogOptions.analog_deadzone / 200.0f;
-
-    if ( isValidPin(analogOptions.analogAdc1PinX) ) {
-        adc_1_x = readPin(analogOptions.analogAdc1PinX, adc_1_x_center, analogOptions.auto_calibrate, adc_deadzone);
-        
-        if ( analogOptions.analogAdc1Invert == InvertMode::INVERT_X ||
-            analogOptions.analogAdc1Invert == InvertMode::INVERT_XY) {
-            adc_1_x = ANALOG_MAX - adc_1_x;
+void AnalogInput::setupAxis(AnalogAxis & axis, int32_t pin, bool invert, bool autoCalibrate, const AnalogCalibration & calibration, AnalogFilter filter) {
+    axis.channel = -1;
+    axis.invert = invert;
+    axis.calibrated = false;
+    axis.filter = filter;
+    axis.primed = false;
+    if ( !isValidPin(pin) ) {
+        return;
+    }
+
+    // Make sure GPIO is high-impedance, no pullups etc
+    adc_gpio_init(pin);
+    axis.channel = pin - ADC_SAMPLER_FIRST_PIN;
+    AdcSampler::enableChannel(axis.channel);
+
+    // A stored calibration covers the real throw of the stick and needs no read at boot
+    if (isValidCalibration(calibration.min, calibration.center, calibration.max)) {
+        calibrateAxis(axis, calibration.min, calibration.center, calibration.max);
+    } else if (autoCalibrate) {
+        // Read pin deviation from center for calibration
+        const uint16_t center = AdcSampler::read(axis.channel);
+        if (center > 0 && center < ADC_MAX) {
+            calibrateAxis(axis, 0, center, ADC_MAX);
         }
     }
-    if ( isValidPin(analogOptions.analogAdc1PinY) ) {
-        adc_1_y = readPin(analogOptions.analogAdc1PinY, adc_1_y_center, analogOptions.auto_calibrate, adc_deadzone);
-        
-        if ( analogOptions.analogAdc1Invert == InvertMode::INVERT_Y ||
-            analogOptions.analogAdc1Invert == InvertMode::INVERT_XY) {
-            adc_1_y = ANALOG_MAX - adc_1_y;
+}
+
+void AnalogInput::calibrateAxis(AnalogAxis & axis, uint16_t min, uint16_t center, uint16_t max) {
+    axis.min = min;
+    axis.center = center;
+    axis.max = max;
+    // Rounded up so both ends of the throw still reach 0 and ADC_MAX
+    axis.scaleLow = (((ADC_MAX / 2) << 16) + (center - min) - 1) / (center - min);
+    axis.scaleHigh = (((ADC_MAX - ADC_MAX / 2) << 16) + (max - center) - 1) / (max - center);
+    axis.calibrated = true;
+}
+
+uint16_t AnalogInput::readAxis(const AnalogAxis & axis) const {
+    if (axis.channel < 0) {
+        return GAMEPAD_JOYSTICK_MID;
+    }
+
+    uint32_t value = (axis.filter == ANALOG_FILTER_OVERSAMPLE) ?
+        AdcSampler::read(axis.channel, filterSamples) : AdcSampler::read(axis.channel);
+
+    // Calibrate axis based on off-center, readings past the recorded ends saturate
+    if (axis.calibrated) {
+        if (value > axis.center) {
+            value = ADC_MAX / 2 + (((std::min<uint32_t>(value, axis.max) - axis.center) * axis.scaleHigh) >> 16);
+        } else {
+            value = ((std::max<uint32_t>(value, axis.min) - axis.min) * axis.scaleLow) >> 16;
         }
     }
-    if ( isValidPin(analogOptions.analogAdc2PinX) ) {
-        adc_2_x = readPin(analogOptions.analogAdc2PinX, adc_2_x_center, analogOptions.auto_calibrate, adc_deadzone);
-        
-        if ( analogOptions.analogAdc2Invert == InvertMode::INVERT_X ||
-            analogOptions.analogAdc2Invert == InvertMode::INVERT_XY) {
-            adc_2_x = ANALOG_MAX - adc_2_x;
+
+    // Repeat the top bits so 0..ADC_MAX spans exactly 0..ANALOG_MAX
+    uint16_t result = (value << 4) | (value >> 8);
+    return axis.invert ? ANALOG_MAX - result : result;
+}
+
+uint16_t AnalogInput::filterAxis(AnalogAxis & axis, uint16_t value, uint32_t elapsedMicros) const {
+    // Oversampling is done on the raw readings in readAxis
+    if (axis.filter != ANALOG_FILTER_EMA && axis.filter != ANALOG_FILTER_ONE_EURO) {
+        return value;
+    }
+
+    const int32_t input = static_cast<int32_t>(value) << ANALOG_FILTER_FRACTION_BITS;
+    if (!axis.primed) {
+        axis.filtered = input;
+        axis.speed = 0;
+        axis.primed = true;
+        return value;
+    }
+
+    if (axis.filter == ANALOG_FILTER_EMA) {
+        axis.filtered += ((input - axis.filtered) * static_cast<int32_t>(emaAlpha)) >> 8;
+    } else {
+        // Rate of change against the previous output, smoothed at a fixed cutoff. Both Q16 steps round,
+        // a truncating step leaves the speed stuck low and the cutoff with it
+        const int32_t delta = (input - axis.filtered) >> ANALOG_FILTER_FRACTION_BITS;
+        const int32_t speed = delta * ANALOG_THROW_SPEED_SCALE / static_cast<int32_t>(elapsedMicros);
+        axis.speed += ((static_cast<int64_t>(speed) - axis.speed) * smoothingFactor(ANALOG_FILTER_SPEED_CUTOFF, elapsedMicros) + (1 << 15)) >> 16;
+
+        // Faster motion raises the cutoff, trading smoothing for latency
+        const uint32_t cutoff = std::min<uint64_t>(minCutoff + static_cast<uint64_t>(beta) * abs(axis.speed) / 1000, ANALOG_FILTER_MAX_CUTOFF);
+        axis.filtered += (static_cast<int64_t>(input - axis.filtered) * smoothingFactor(cutoff, elapsedMicros) + (1 << 15)) >> 16;
+    }
+
+    return (axis.filtered + (1 << (ANALOG_FILTER_FRACTION_BITS - 1))) >> ANALOG_FILTER_FRACTION_BITS;
+}
+
+void AnalogInput::startCalibration(AnalogAxis & axis) {
+    if (axis.channel < 0) {
+        return;
+    }
+
+    // The stick is expected to rest while the calibration hotkey is pressed
+    axis.seenCenter = AdcSampler::read(axis.channel);
+    axis.seenMin = axis.seenCenter;
+    axis.seenMax = axis.seenCenter;
+}
+
+void AnalogInput::recordCalibration(AnalogAxis & axis) {
+    if (axis.channel < 0) {
+        return;
+    }
+
+    const uint16_t value = AdcSampler::read(axis.channel);
+    axis.seenMin = std::min(axis.seenMin, value);
+    axis.seenMax = std::max(axis.seenMax, value);
+}
+
+bool AnalogInput::finishCalibration(AnalogAxis & axis, AnalogCalibration & calibration) {
+    // Axes that were not moved through their throw keep their previous calibration
+    if (axis.channel < 0 || !isValidCalibration(axis.seenMin, axis.seenCenter, axis.seenMax)) {
+        return false;
+    }
+
+    calibration.min = axis.seenMin;
+    calibration.center = axis.seenCenter;
+    calibration.max = axis.seenMax;
+    calibrateAxis(axis, axis.seenMin, axis.seenCenter, axis.seenMax);
+    return true;
+}
+
+void AnalogInput::applyDeadzone(uint16_t & x, uint16_t & y) const {
+    if (radialDeadzone) {
+        const int32_t dx = x - ANALOG_ORIGIN;
+        const int32_t dy = y - ANALOG_ORIGIN;
+        if (static_cast<uint32_t>(dx * dx) + static_cast<uint32_t>(dy * dy) < deadzone * deadzone) {
+            x = GAMEPAD_JOYSTICK_MID;
+            y = GAMEPAD_JOYSTICK_MID;
+        }
+    } else {
+        // Doubled so the comparison is against the true center between two codes
+        if (static_cast<uint32_t>(abs(2 * x - ANALOG_MAX)) < 2 * deadzone) {
+            x = GAMEPAD_JOYSTICK_MID;
+        }
+        if (static_cast<uint32_t>(abs(2 * y - ANALOG_MAX)) < 2 * deadzone) {
+            y = GAMEPAD_JOYSTICK_MID;
         }
     }
-    if ( isValidPin(analogOptions.analogAdc2PinY) ) {
-        adc_2_y = readPin(analogOptions.analogAdc2PinY, adc_2_y_center, analogOptions.auto_calibrate, adc_deadzone);
+}
 
-        if ( analogOptions.analogAdc2Invert == InvertMode::INVERT_Y ||
-            analogOptions.analogAdc2Invert == InvertMode::INVERT_XY) {
-            adc_2_y = ANALOG_MAX - adc_2_y;
+void AnalogInput::process()
+{
+    AnalogOptions& analogOptions = Storage::getInstance().getAddonOptions().analogOptions;
+    Gamepad * gamepad = Storage::getInstance().GetGamepad();
+
+    // Calibration is toggled by hotkey, record the extremes in between and store them once it ends.
+    // The flash write stalls both cores, it is left to the next loop instead of this poll
+    const bool calibrationMode = Storage::getInstance().GetAnalogCalibrationMode();
+    if (calibrationMode != calibrating) {
+        calibrating = calibrationMode;
+        if (calibrating) {
+            startCalibration(adc1X);
+            startCalibration(adc1Y);
+            startCalibration(adc2X);
+            startCalibration(adc2Y);
+        } else {
+            bool stored = finishCalibration(adc1X, analogOptions.adc1XCalibration);
+            stored |= finishCalibration(adc1Y, analogOptions.adc1YCalibration);
+            stored |= finishCalibration(adc2X, analogOptions.adc2XCalibration);
+            stored |= finishCalibration(adc2Y, analogOptions.adc2YCalibration);
+            if (stored) {
+                Storage::getInstance().enqueueAnalogOptionsSave(analogOptions);
+            }
         }
+    } else if (calibrating) {
+        recordCalibration(adc1X);
+        recordCalibration(adc1Y);
+        recordCalibration(adc2X);
+        recordCalibration(adc2Y);
     }
-    
+
+    // Filters run on the time between polls, process() may be scheduled at a slower rate
+    const uint64_t now = getMicro();
+    const uint32_t elapsedMicros = std::clamp<uint64_t>(now - lastFilterMicros, 1, ANALOG_FILTER_MAX_STEP_MICROS);
+    lastFilterMicros = now;
+
+    uint16_t adc_1_x = filterAxis(adc1X, readAxis(adc1X), elapsedMicros);
+    uint16_t adc_1_y = filterAxis(adc1Y, readAxis(adc1Y), elapsedMicros);
+    uint16_t adc_2_x = filterAxis(adc2X, readAxis(adc2X), elapsedMicros);
+    uint16_t adc_2_y = filterAxis(adc2Y, readAxis(adc2Y), elapsedMicros);
+
+    if (deadzone > 0) {
+        applyDeadzone(adc_1_x, adc_1_y);
+        applyDeadzone(adc_2_x, adc_2_y);
+    }
+
     // Alter coordinates to force perfect circularity
     if (analogOptions.forced_circularity) {
         adjustCircularity(adc_1_x, adc_1_y);
         adjustCircularity(adc_2_x, adc_2_y);
     }
 
-    // Convert to 16-bit value
     if ( analogOptions.analogAdc1Mode == DpadMode::DPAD_MODE_LEFT_ANALOG) {
-        gamepad->state.lx = (uint16_t)(65535.0f*adc_1_x);
-        gamepad->state.ly = (uint16_t)(65535.0f*adc_1_y);
+        gamepad->state.lx = adc_1_x;
+        gamepad->state.ly = adc_1_y;
     } else if ( analogOptions.analogAdc1Mode == DpadMode::DPAD_MODE_RIGHT_ANALOG) {
-        gamepad->state.rx = (uint16_t)(65535.0f*adc_1_x);
-        gamepad->state.ry = (uint16_t)(65535.0f*adc_1_y);
+        gamepad->state.rx = adc_1_x;
+        gamepad->state.ry = adc_1_y;
     }
     if ( analogOptions.analogAdc2Mode == DpadMode::DPAD_MODE_LEFT_ANALOG) {
-        gamepad->state.lx = (uint16_t)(65535.0f*adc_2_x);
-        gamepad->state.ly = (uint16_t)(65535.0f*adc_2_y);
+        gamepad->state.lx = adc_2_x;
+        gamepad->state.ly = adc_2_y;
     } else if ( analogOptions.analogAdc2Mode == DpadMode::DPAD_MODE_RIGHT_ANALOG) {
-        gamepad->state.rx = (uint16_t)(65535.0f*adc_2_x);
-        gamepad->state.ry = (uint16_t)(65535.0f*adc_2_y);
+        gamepad->state.rx = adc_2_x;
+        gamepad->state.ry = adc_2_y;
     }
 }
 
-float AnalogInput::readPin(int pin, uint16_t center, bool autoCalibrate, float deadzone) {
-	adc_select_input(pin - 26);
-	uint16_t adc_hold = adc_read();
-
-	// Calibrate axis based on off-center
-	uint16_t adc_calibrated;
-
-	if (autoCalibrate) {
-		if (adc_hold > center) {
-			adc_calibrated = map(adc_hold, center, ADC_MAX, ADC_MAX / 2, ADC_MAX);
-		}
-		else if (adc_hold == center) {
-			adc_calibrated = ADC_MAX / 2;
-		}
-		else {
-			adc_calibrated = map(adc_hold, 0, center, 0, ADC_MAX / 2);
-		}
-	}
-	else {
-		adc_calibrated = adc_hold;
-	}
-
-	float adc_value = ((float)adc_calibrated) / ADC_MAX;
-
-	if (abs(adc_value - ANALOG_CENTER) < deadzone) { // deadzones
-		adc_value = ANALOG_CENTER;
-	}
-
-	return adc_value;
-}
-
-uint16_t AnalogInput::map(uint16_t x, uint16_t in_min, uint16_t in_max, uint16_t out_min, uint16_t out_max) {
-    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
-}
-
-void AnalogInput::adjustCircularity(float& x, float& y) {
-    float x_magnitude = x - ANALOG_CENTER;
-    float y_magnitude = y - ANALOG_CENTER;
-    float magnitude = sqrt((x_magnitude * x_magnitude) + (y_magnitude * y_magnitude));
+void AnalogInput::adjustCircularity(uint16_t & x, uint16_t & y) {
+    const int32_t dx = x - ANALOG_ORIGIN;
+    const int32_t dy = y - ANALOG_ORIGIN;
+    const uint32_t magnitudeSquared = static_cast<uint32_t>(dx * dx) + static_cast<uint32_t>(dy * dy);
 
-    if (magnitude > ANALOG_CENTER) {
-        x = ((x_magnitude / magnitude) * ANALOG_CENTER + ANALOG_CENTER);
-        y = ((y_magnitude / magnitude) * ANALOG_CENTER + ANALOG_CENTER);
+    if (magnitudeSquared > static_cast<uint32_t>(ANALOG_RADIUS * ANALOG_RADIUS)) {
+        const int32_t magnitude = isqrt(magnitudeSquared);
+        x = ANALOG_ORIGIN + dx * ANALOG_RADIUS / magnitude;
+        y = ANALOG_ORIGIN + dy * ANALOG_RADIUS / magnitude;
     }
-}
\ No newline at end of file
+}
@@ -70,16 +70,16 @@ void DualDirectionalInput::preprocess()
  	// Need to invert since we're using pullups
     dualState = 0;
     if ( pinDualDirUp != (uint8_t)-1 ) {
-        dualState |= (!gpio_get(pinDualDirUp) ? gamepad->mapDpadUp->buttonMask : 0);
+        dualState |= (gamepad->pressedPin(pinDualDirUp) ? gamepad->mapDpadUp->buttonMask : 0);
     }
     if ( pinDualDirDown != (uint8_t)-1 ) {
-        dualState |= (!gpio_get(pinDualDirDown) ? gamepad->mapDpadDown->buttonMask : 0);
+        dualState |= (gamepad->pressedPin(pinDualDirDown) ? gamepad->mapDpadDown->buttonMask : 0);
     }
     if ( pinDualDirLeft != (uint8_t)-1 ) {
-        dualState |= (!gpio_get(pinDualDirLeft) ? gamepad->mapDpadLeft->buttonMask  : 0);
+        dualState |= (gamepad->pressedPin(pinDualDirLeft) ? gamepad->mapDpadLeft->buttonMask  : 0);
     }
     if ( pinDualDirRight != (uint8_t)-1 ) {
-        dualState |= (!gpio_get(pinDualDirRight) ? gamepad->mapDpadRight->buttonMask : 0);
+        dualState |= (gamepad->pressedPin(pinDualDirRight) ? gamepad->mapDpadRight->buttonMask : 0);
     }
 
     // Debounce our directional pins
@@ -245,7 +245,7 @@ uint8_t DualDirectionalInput::SOCDCombine(SOCDMode mode, uint8_t gamepadState) {
             if ( mode == SOCD_MODE_NEUTRAL )
                 outState ^= (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN);
             else if ( mode == SOCD_MODE_UP_PRIORITY )
-                outState = GAMEPAD_MASK_UP;
+                outState ^= GAMEPAD_MASK_DOWN; // Keep Left/Right
             break;
         default:
             break;
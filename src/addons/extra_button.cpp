@@ -21,7 +21,7 @@ void ExtraButtonAddon::setup() {
 
 void ExtraButtonAddon::preprocess() {
 	Gamepad * gamepad = Storage::getInstance().GetGamepad();
-	if (!gpio_get(extraButtonPin)) {
+	if (gamepad->pressedPin(extraButtonPin)) {
 		if (extraButtonMap > (GAMEPAD_MASK_A2)) {
 			switch (extraButtonMap) {
 				case (GAMEPAD_MASK_DU):
@@ -20,7 +20,7 @@ void FocusModeAddon::setup() {
 
 void FocusModeAddon::process() {
 	Gamepad * gamepad = Storage::getInstance().GetGamepad();
-	if (!gpio_get(focusModePin)) {
+	if (gamepad->pressedPin(focusModePin)) {
 			if (buttonLockMask & GAMEPAD_MASK_DU) {
 				gamepad->state.dpad &= ~GAMEPAD_MASK_UP;
 			}
@@ -3,8 +3,86 @@
 #include "helper.h"
 #include "config.pb.h"
 
-#define ADS_MAX (float)((1 << 23) - 1)
-#define VREF_VOLTAGE 2.048f
+#include <cstring>
+
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+
+#include "I2CQueue.h"
+
+#define ADS_SIGN_BIT 0x800000
+#define ADS_TO_AXIS_SHIFT 7             // 23 magnitude bits down to 16
+#define ADS_CHANNELS 4
+#define ADS_RDATA 0x10
+#define ADS_WREG CONFIG_REGISTER_ADDRESS
+#define ADS_MUX_STEP (MUX_SINGLE_1 - MUX_SINGLE_0)
+
+// Configuration written by setup(), the input mux bits are added per channel
+#define ADS_CONFIG (MODE_CONTINUOUS | GAIN_ONE | DATA_RATE_1000 | VREF_INTERNAL)
+
+// DRDY readout state, owned by the interrupt and queue callbacks once setup has finished
+static I2CQueue * drdyQueue = nullptr;
+static uint drdyGpio = 0;
+static volatile uint8_t drdyChannel = 0;        // Input of the conversion in progress
+static volatile bool drdyResync = false;        // A mux write failed, it has to be sent again
+static const uint8_t drdyReadCommand[] = { ADS_RDATA };
+static uint8_t drdyResult[3];
+static uint8_t drdyMuxCommand[] = { ADS_WREG, 0 };
+static I2CTransaction drdyRead;
+static I2CTransaction drdyHop;
+static uint16_t drdySweep[ADS_CHANNELS];
+static uint16_t drdyBuffers[2][ADS_CHANNELS];   // Completed sweeps, process() reads drdyBuffers[drdyFront]
+static volatile uint8_t drdyFront = 0;
+
+// Single-ended inputs never go negative, readings below ground are noise
+static uint16_t toAxis(uint32_t raw) {
+    return (raw & ADS_SIGN_BIT) ? 0 : (raw & (ADS_SIGN_BIT - 1)) >> ADS_TO_AXIS_SHIFT;
+}
+
+// WREG restarts the conversion on the next input, nothing to wait for until its DRDY
+static void __not_in_flash_func(drdySelectChannel)(uint8_t channel) {
+    drdyMuxCommand[1] = ADS_CONFIG | (MUX_SINGLE_0 + channel * ADS_MUX_STEP);
+    drdyQueue->submit(drdyHop);
+}
+
+static void __not_in_flash_func(drdyHopDone)(I2CTransaction & transaction) {
+    if (transaction.status == I2CTransactionStatus::FAILED) {
+        drdyResync = true;
+    }
+}
+
+static void __not_in_flash_func(drdyReadDone)(I2CTransaction & transaction) {
+    // A failed read leaves the mux alone, the same input is read again on the next DRDY
+    if (transaction.status == I2CTransactionStatus::FAILED) {
+        return;
+    }
+
+    drdySweep[drdyChannel] = toAxis((drdyResult[0] << 16) | (drdyResult[1] << 8) | drdyResult[2]);
+    drdyChannel = (drdyChannel + 1) % ADS_CHANNELS;
+    if (drdyChannel == 0) {
+        const uint8_t back = drdyFront ^ 1;
+        memcpy(drdyBuffers[back], drdySweep, sizeof(drdySweep));
+        drdyFront = back;
+    }
+
+    drdySelectChannel(drdyChannel);
+}
+
+static void __not_in_flash_func(drdyIRQ)() {
+    if (!(gpio_get_irq_event_mask(drdyGpio) & GPIO_IRQ_EDGE_FALL)) {
+        return;
+    }
+    gpio_acknowledge_irq(drdyGpio, GPIO_IRQ_EDGE_FALL);
+
+    if (drdyResync) {
+        drdyResync = false;
+        drdySelectChannel(drdyChannel);
+        return;
+    }
+
+    // Skipped while the previous read is still queued behind other devices on the block
+    drdyQueue->submit(drdyRead);
+}
 
 bool I2CAnalog1219Input::available() {
     const AnalogADS1219Options& options = Storage::getInstance().getAddonOptions().analogADS1219Options;
@@ -16,6 +94,7 @@ void I2CAnalog1219Input::setup() {
 
     memset(&pins, 0, sizeof(ADS_PINS));
     channelHop = 0;
+    dataReady = false;
 
     uIntervalMS = 1;
     nextTimer = getMillis();
@@ -34,27 +113,66 @@ void I2CAnalog1219Input::setup() {
     ads->setDataRate(1000);                     // 1mhz (1.1ms delay)
     ads->setVoltageReference(REF_INTERNAL);     // Use internal VREF for now
     ads->start();                               // START/SYNC command
+
+    if (isValidPin(options.drdyPin)) {
+        setupDataReady(options.i2cBlock == 0 ? i2c0 : i2c1, options.drdyPin, options.i2cAddress);
+    }
+}
+
+void I2CAnalog1219Input::setupDataReady(i2c_inst_t * block, int32_t drdyPin, uint8_t address) {
+    // The library set the block up, from here on every transfer on it goes through the queue
+    drdyQueue = &I2CQueue::get(block);
+    if (!drdyQueue->setup()) {
+        return;
+    }
+
+    drdyGpio = drdyPin;
+    drdyChannel = 0;
+    drdyResync = false;
+    memset(drdyBuffers, 0, sizeof(drdyBuffers));
+    drdyRead = {
+        .address = address,
+        .writeData = drdyReadCommand,
+        .writeLength = sizeof(drdyReadCommand),
+        .readData = drdyResult,
+        .readLength = sizeof(drdyResult),
+        .callback = drdyReadDone,
+    };
+    drdyHop = {
+        .address = address,
+        .writeData = drdyMuxCommand,
+        .writeLength = sizeof(drdyMuxCommand),
+        .callback = drdyHopDone,
+    };
+
+    // DRDY drops low when a conversion result is ready
+    gpio_init(drdyGpio);
+    gpio_set_dir(drdyGpio, GPIO_IN);
+    gpio_pull_up(drdyGpio);
+    gpio_add_raw_irq_handler(drdyGpio, drdyIRQ);
+    gpio_set_irq_enabled(drdyGpio, GPIO_IRQ_EDGE_FALL, true);
+    irq_set_enabled(IO_IRQ_BANK0, true);
+
+    dataReady = true;
 }
 
 void I2CAnalog1219Input::process()
 {
-    if (nextTimer < getMillis()) {
-        float result;
-        uint32_t readValue;
+    if (dataReady) {
+        // Always the last complete sweep, the interrupt only ever writes the other buffer
+        memcpy(pins.A, drdyBuffers[drdyFront], sizeof(pins.A));
+    } else if (nextTimer < getMillis()) {
         if ( ads->readRegister(STATUS) & REGISTER_STATUS_DRDY ) {
-            readValue = ads->readConversionResult();
-            result = readValue / float(ADS_MAX); // gives us 0.0f to 1.0f (actual voltage is times voltage)
-            pins.A[channelHop] = result;
-            channelHop = (channelHop+1) % 4; // Loop 0-3
+            pins.A[channelHop] = toAxis(ads->readConversionResult());
+            channelHop = (channelHop+1) % ADS_CHANNELS; // Loop 0-3
             ads->setChannel(channelHop);
             nextTimer = getMillis() + uIntervalMS; // interval for read (we can't be too fast)
         }
     }
 
     Gamepad * gamepad = Storage::getInstance().GetGamepad();
-    gamepad->state.lx = (uint16_t)(65535.f*pins.A[0]);
-    gamepad->state.ly = (uint16_t)(65535.f*pins.A[1]);
-    gamepad->state.rx = (uint16_t)(65535.f*pins.A[2]);
-    gamepad->state.ry = (uint16_t)(65535.f*pins.A[3]);
-
+    gamepad->state.lx = pins.A[0];
+    gamepad->state.ly = pins.A[1];
+    gamepad->state.rx = pins.A[2];
+    gamepad->state.ry = pins.A[3];
 }
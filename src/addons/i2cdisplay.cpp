@@ -64,7 +64,7 @@ bool I2CDisplayAddon::isDisplayPowerOff()
 
 	float diffTime = getMillis() - prevMillis;
 	displaySaverTimer -= diffTime;
-	if (!!displaySaverTimeout && (gamepad->state.buttons || gamepad->state.dpad) && !focusModePrevState) {
+	if (!!displaySaverTimeout && (pGamepad->state.buttons || pGamepad->state.dpad) && !focusModePrevState) {
 		displaySaverTimer = displaySaverTimeout;
 		setDisplayPower(1);
 	} else if (!!displaySaverTimeout && displaySaverTimer <= 0) {
@@ -32,10 +32,11 @@ void JSliderInput::setup()
 
 DpadMode JSliderInput::read() {
     const SliderOptions& options = Storage::getInstance().getAddonOptions().sliderOptions;
-    if ( isValidPin(options.pinLS) && !gpio_get(options.pinLS)) {
+    Gamepad * gamepad = Storage::getInstance().GetGamepad();
+    if ( isValidPin(options.pinLS) && gamepad->pressedPin(options.pinLS)) {
         return DPAD_MODE_LEFT_ANALOG;
     }
-    if ( isValidPin(options.pinRS) && !gpio_get(options.pinRS)) {
+    if ( isValidPin(options.pinRS) && gamepad->pressedPin(options.pinRS)) {
         return DPAD_MODE_RIGHT_ANALOG;
     }
     return  DPAD_MODE_DIGITAL;
@@ -1,29 +1,27 @@
 #include "addons/keyboard_host.h"
 #include "storagemanager.h"
+#include "hidreportparser.h"
+#include "triplebuffer.h"
 
 #include "pio_usb.h"
 
-static bool host_device_mounted = false;
-static GamepadState _keyboard_host_state;
-
-static KeyboardButtonMapping _keyboard_host_mapDpadUp    = KeyboardButtonMapping(GAMEPAD_MASK_UP);
-static KeyboardButtonMapping _keyboard_host_mapDpadDown  = KeyboardButtonMapping(GAMEPAD_MASK_DOWN);
-static KeyboardButtonMapping _keyboard_host_mapDpadLeft  = KeyboardButtonMapping(GAMEPAD_MASK_LEFT);
-static KeyboardButtonMapping _keyboard_host_mapDpadRight = KeyboardButtonMapping(GAMEPAD_MASK_RIGHT);
-static KeyboardButtonMapping _keyboard_host_mapButtonB1  = KeyboardButtonMapping(GAMEPAD_MASK_B1);
-static KeyboardButtonMapping _keyboard_host_mapButtonB2  = KeyboardButtonMapping(GAMEPAD_MASK_B2);
-static KeyboardButtonMapping _keyboard_host_mapButtonB3  = KeyboardButtonMapping(GAMEPAD_MASK_R2);
-static KeyboardButtonMapping _keyboard_host_mapButtonB4  = KeyboardButtonMapping(GAMEPAD_MASK_L2);
-static KeyboardButtonMapping _keyboard_host_mapButtonL1  = KeyboardButtonMapping(GAMEPAD_MASK_B3);
-static KeyboardButtonMapping _keyboard_host_mapButtonR1  = KeyboardButtonMapping(GAMEPAD_MASK_B4);
-static KeyboardButtonMapping _keyboard_host_mapButtonL2  = KeyboardButtonMapping(GAMEPAD_MASK_R1);
-static KeyboardButtonMapping _keyboard_host_mapButtonR2  = KeyboardButtonMapping(GAMEPAD_MASK_L1);
-static KeyboardButtonMapping _keyboard_host_mapButtonS1  = KeyboardButtonMapping(GAMEPAD_MASK_S1);
-static KeyboardButtonMapping _keyboard_host_mapButtonS2  = KeyboardButtonMapping(GAMEPAD_MASK_S2);
-static KeyboardButtonMapping _keyboard_host_mapButtonL3  = KeyboardButtonMapping(GAMEPAD_MASK_L3);
-static KeyboardButtonMapping _keyboard_host_mapButtonR3  = KeyboardButtonMapping(GAMEPAD_MASK_R3);
-static KeyboardButtonMapping _keyboard_host_mapButtonA1  = KeyboardButtonMapping(GAMEPAD_MASK_A1);
-static KeyboardButtonMapping _keyboard_host_mapButtonA2  = KeyboardButtonMapping(GAMEPAD_MASK_A2);
+// Input mask for every keyboard usage, filled on core0 before core1 starts and read-only after
+static uint32_t _keyboard_host_keys[HID_REPORT_KEY_COUNT];
+
+// One plan and its last translated state per mounted HID interface, only touched on core1
+struct KeyboardHostDevice
+{
+  bool used;
+  uint8_t devAddr;
+  uint8_t instance;
+  HidReportParser parser;
+  HidReportState state;
+};
+
+static KeyboardHostDevice _keyboard_host_devices[CFG_TUH_HID];
+
+// Every device merged into one state, published by core1 and read by core0 preprocess()
+static TripleBuffer<HidReportState> _keyboard_host_state;
 
 bool KeyboardHostAddon::available() {
   const KeyboardHostOptions& keyboardHostOptions = Storage::getInstance().getAddonOptions().keyboardHostOptions;
@@ -31,179 +29,188 @@ bool KeyboardHostAddon::available() {
 }
 
 void KeyboardHostAddon::setup() {
-  set_sys_clock_khz(120000, true); // Set Clock to 120MHz to avoid potential USB timing issues
+  // GP2040::setup() has already switched to the 120MHz PIO USB needs
   const KeyboardHostOptions& keyboardHostOptions = Storage::getInstance().getAddonOptions().keyboardHostOptions;
   const KeyboardMapping& keyboardMapping = keyboardHostOptions.mapping;
+
+  const GamepadOptions& gamepadOptions = Storage::getInstance().getGamepadOptions();
+
+  const struct { uint32_t key; uint32_t mask; } bindings[] = {
+    { keyboardMapping.keyDpadUp,    static_cast<uint32_t>(gamepadOptions.invertYAxis ? GAMEPAD_MASK_DOWN : GAMEPAD_MASK_UP) << HID_REPORT_DPAD_SHIFT },
+    { keyboardMapping.keyDpadDown,  static_cast<uint32_t>(gamepadOptions.invertYAxis ? GAMEPAD_MASK_UP : GAMEPAD_MASK_DOWN) << HID_REPORT_DPAD_SHIFT },
+    { keyboardMapping.keyDpadLeft,  static_cast<uint32_t>(GAMEPAD_MASK_LEFT) << HID_REPORT_DPAD_SHIFT },
+    { keyboardMapping.keyDpadRight, static_cast<uint32_t>(GAMEPAD_MASK_RIGHT) << HID_REPORT_DPAD_SHIFT },
+    { keyboardMapping.keyButtonB1,  GAMEPAD_MASK_B1 },
+    { keyboardMapping.keyButtonB2,  GAMEPAD_MASK_B2 },
+    // Same pairing as the original per-key mappings
+    { keyboardMapping.keyButtonB3,  GAMEPAD_MASK_R2 },
+    { keyboardMapping.keyButtonB4,  GAMEPAD_MASK_L2 },
+    { keyboardMapping.keyButtonL1,  GAMEPAD_MASK_B3 },
+    { keyboardMapping.keyButtonR1,  GAMEPAD_MASK_B4 },
+    { keyboardMapping.keyButtonL2,  GAMEPAD_MASK_R1 },
+    { keyboardMapping.keyButtonR2,  GAMEPAD_MASK_L1 },
+    { keyboardMapping.keyButtonS1,  GAMEPAD_MASK_S1 },
+    { keyboardMapping.keyButtonS2,  GAMEPAD_MASK_S2 },
+    { keyboardMapping.keyButtonL3,  GAMEPAD_MASK_L3 },
+    { keyboardMapping.keyButtonR3,  GAMEPAD_MASK_R3 },
+    { keyboardMapping.keyButtonA1,  GAMEPAD_MASK_A1 },
+    { keyboardMapping.keyButtonA2,  GAMEPAD_MASK_A2 },
+  };
+
+  // Several inputs may share a key, usage 0 is never reported as pressed
+  for (const auto & binding : bindings) {
+    if (binding.key > HID_KEY_NONE && binding.key <= HID_KEY_GUI_RIGHT)
+      _keyboard_host_keys[binding.key] |= binding.mask;
+  }
+}
+
+void KeyboardHostAddon::preprocess() {
+  HidReportState host;
+  if (_keyboard_host_state.read(host) == 0)
+    return;
+
+  // Digital inputs add to the local ones, an axis is only taken over while a device reports it
+  Gamepad *gamepad = Storage::getInstance().GetGamepad();
+  gamepad->state.dpad     |= host.state.dpad;
+  gamepad->state.buttons  |= host.state.buttons;
+  if (host.analog & HID_REPORT_ANALOG_LX) gamepad->state.lx = host.state.lx;
+  if (host.analog & HID_REPORT_ANALOG_LY) gamepad->state.ly = host.state.ly;
+  if (host.analog & HID_REPORT_ANALOG_RX) gamepad->state.rx = host.state.rx;
+  if (host.analog & HID_REPORT_ANALOG_RY) gamepad->state.ry = host.state.ry;
+  if (host.analog & HID_REPORT_ANALOG_LT) gamepad->state.lt = host.state.lt;
+  if (host.analog & HID_REPORT_ANALOG_RT) gamepad->state.rt = host.state.rt;
+}
+
+bool KeyboardHostServiceAddon::available() {
+  const KeyboardHostOptions& keyboardHostOptions = Storage::getInstance().getAddonOptions().keyboardHostOptions;
+	return keyboardHostOptions.enabled && isValidPin(keyboardHostOptions.pinDplus);
+}
+
+void KeyboardHostServiceAddon::setup() {
+  const KeyboardHostOptions& keyboardHostOptions = Storage::getInstance().getAddonOptions().keyboardHostOptions;
 	// board_init();
   // board_init() should be doing what the two lines below are doing but doesn't work
   // needs tinyusb_board library linked
 	pio_usb_configuration_t pio_cfg = PIO_USB_DEFAULT_CONFIG;
   pio_cfg.pin_dp = keyboardHostOptions.pinDplus;
   tuh_configure(1, TUH_CFGID_RPI_PIO_USB_CONFIGURATION, &pio_cfg);
+  // The frame timer is armed on the calling core, enumeration then completes from process()
 	tuh_init(BOARD_TUH_RHPORT);
+}
 
-  while((to_ms_since_boot(get_absolute_time()) < 250)) {
-    if (host_device_mounted) break;
-    tuh_task();
-  }
-
-  _keyboard_host_mapDpadUp.setKey(keyboardMapping.keyDpadUp);
-  _keyboard_host_mapDpadDown.setKey(keyboardMapping.keyDpadDown);
-  _keyboard_host_mapDpadLeft.setKey(keyboardMapping.keyDpadLeft);
-  _keyboard_host_mapDpadRight.setKey(keyboardMapping.keyDpadRight);
-  _keyboard_host_mapButtonB1.setKey(keyboardMapping.keyButtonB1);
-  _keyboard_host_mapButtonB2.setKey(keyboardMapping.keyButtonB2);
-  _keyboard_host_mapButtonR2.setKey(keyboardMapping.keyButtonR2);
-  _keyboard_host_mapButtonL2.setKey(keyboardMapping.keyButtonL2);
-  _keyboard_host_mapButtonB3.setKey(keyboardMapping.keyButtonB3);
-  _keyboard_host_mapButtonB4.setKey(keyboardMapping.keyButtonB4);
-  _keyboard_host_mapButtonR1.setKey(keyboardMapping.keyButtonR1);
-  _keyboard_host_mapButtonL1.setKey(keyboardMapping.keyButtonL1);
-  _keyboard_host_mapButtonS1.setKey(keyboardMapping.keyButtonS1);
-  _keyboard_host_mapButtonS2.setKey(keyboardMapping.keyButtonS2);
-  _keyboard_host_mapButtonL3.setKey(keyboardMapping.keyButtonL3);
-  _keyboard_host_mapButtonR3.setKey(keyboardMapping.keyButtonR3);
-  _keyboard_host_mapButtonA1.setKey(keyboardMapping.keyButtonA1);
-  _keyboard_host_mapButtonA2.setKey(keyboardMapping.keyButtonA2);
+void KeyboardHostServiceAddon::process() {
+  tuh_task();
 }
 
-void KeyboardHostAddon::preprocess() {
-  Gamepad *gamepad = Storage::getInstance().GetGamepad();
-  gamepad->state.dpad     |= _keyboard_host_state.dpad;
-  gamepad->state.buttons  |= _keyboard_host_state.buttons;
-  gamepad->state.lx       |= _keyboard_host_state.lx;
-  gamepad->state.ly       |= _keyboard_host_state.ly;
-  gamepad->state.rx       |= _keyboard_host_state.rx;
-  gamepad->state.ry       |= _keyboard_host_state.ry;
-  gamepad->state.lt       |= _keyboard_host_state.lt;
-  gamepad->state.rt       |= _keyboard_host_state.rt;
+static KeyboardHostDevice * findDevice(uint8_t dev_addr, uint8_t instance)
+{
+  for (KeyboardHostDevice & device : _keyboard_host_devices) {
+    if (device.used && device.devAddr == dev_addr && device.instance == instance)
+      return &device;
+  }
+  return nullptr;
+}
 
-  tuh_task();
+// Merges every device and hands the result to core0, for each axis the first device reporting it wins
+static void publishState()
+{
+  HidReportState merged;
+  for (const KeyboardHostDevice & device : _keyboard_host_devices) {
+    if (!device.used)
+      continue;
+
+    merged.state.dpad    |= device.state.state.dpad;
+    merged.state.buttons |= device.state.state.buttons;
+    const uint8_t axes = device.state.analog & ~merged.analog;
+    if (axes & HID_REPORT_ANALOG_LX) merged.state.lx = device.state.state.lx;
+    if (axes & HID_REPORT_ANALOG_LY) merged.state.ly = device.state.state.ly;
+    if (axes & HID_REPORT_ANALOG_RX) merged.state.rx = device.state.state.rx;
+    if (axes & HID_REPORT_ANALOG_RY) merged.state.ry = device.state.state.ry;
+    if (axes & HID_REPORT_ANALOG_LT) merged.state.lt = device.state.state.lt;
+    if (axes & HID_REPORT_ANALOG_RT) merged.state.rt = device.state.state.rt;
+    merged.analog |= axes;
+  }
+  _keyboard_host_state.write(merged);
 }
 
 // Invoked when device with hid interface is mounted
-// Report descriptor is also available for use. tuh_hid_parse_report_descriptor()
-// can be used to parse common/simple enough descriptor.
+// The report descriptor is compiled into an extraction plan once here, reports are then
+// translated with it whatever the device is.
 // Note: if report descriptor length > CFG_TUH_ENUMERATION_BUFSIZE, it will be skipped
 // therefore report_desc = NULL, desc_len = 0
 void tuh_hid_mount_cb(uint8_t dev_addr, uint8_t instance, uint8_t const* desc_report, uint16_t desc_len)
 {
-  (void)desc_report;
-  (void)desc_len;
-
-  host_device_mounted = true;
+  KeyboardHostDevice *device = nullptr;
+  for (KeyboardHostDevice & candidate : _keyboard_host_devices) {
+    if (!candidate.used) {
+      device = &candidate;
+      break;
+    }
+  }
+  if (device == nullptr)
+    return;
 
   // Interface protocol (hid_interface_protocol_enum_t)
   uint8_t const itf_protocol = tuh_hid_interface_protocol(dev_addr, instance);
+  bool mapped;
+
+  // A mouse's movement and clicks would land on the stick and face buttons
+  if (itf_protocol == HID_ITF_PROTOCOL_MOUSE)
+    return;
 
-  uint16_t vid, pid;
-  tuh_vid_pid_get(dev_addr, &vid, &pid);
+  // A keyboard left in the boot protocol sends the fixed boot report whatever its descriptor says
+  if (itf_protocol == HID_ITF_PROTOCOL_KEYBOARD &&
+      (desc_len == 0 || tuh_hid_get_protocol(dev_addr, instance) == HID_PROTOCOL_BOOT))
+  {
+    device->parser.compileBootKeyboard(_keyboard_host_keys);
+    mapped = true;
+  }
+  else
+  {
+    mapped = device->parser.compile(desc_report, desc_len, _keyboard_host_keys);
+  }
+
+  if (!mapped)
+    return;
+
+  device->used = true;
+  device->devAddr = dev_addr;
+  device->instance = instance;
+  device->state = HidReportState();
 
   // tuh_hid_report_received_cb() will be invoked when report is available
-  if (itf_protocol == HID_ITF_PROTOCOL_KEYBOARD)
+  if ( !tuh_hid_receive_report(dev_addr, instance) )
   {
-    if ( !tuh_hid_receive_report(dev_addr, instance) )
-    {
-      // Error: cannot request report
-    }
+    // Error: cannot request report
+    device->used = false;
   }
 }
 
 // Invoked when device with hid interface is un-mounted
 void tuh_hid_umount_cb(uint8_t dev_addr, uint8_t instance)
 {
-  (void) dev_addr;
-  (void) instance;
-}
+  KeyboardHostDevice *device = findDevice(dev_addr, instance);
+  if (device == nullptr)
+    return;
 
-uint8_t getKeycodeFromModifier(uint8_t modifier) {
-	switch (modifier) {
-	  case KEYBOARD_MODIFIER_LEFTCTRL   : return HID_KEY_CONTROL_LEFT ;
-	  case KEYBOARD_MODIFIER_LEFTSHIFT  : return HID_KEY_SHIFT_LEFT   ;
-	  case KEYBOARD_MODIFIER_LEFTALT    : return HID_KEY_ALT_LEFT     ;
-	  case KEYBOARD_MODIFIER_LEFTGUI    : return HID_KEY_GUI_LEFT     ;
-	  case KEYBOARD_MODIFIER_RIGHTCTRL  : return HID_KEY_CONTROL_RIGHT;
-	  case KEYBOARD_MODIFIER_RIGHTSHIFT : return HID_KEY_SHIFT_RIGHT  ;
-	  case KEYBOARD_MODIFIER_RIGHTALT   : return HID_KEY_ALT_RIGHT    ;
-	  case KEYBOARD_MODIFIER_RIGHTGUI   : return HID_KEY_GUI_RIGHT    ;
-	}
-
-	return 0;
-}
-
-// convert hid keycode to ascii and print via usb device CDC (ignore non-printable)
-void process_kbd_report(uint8_t dev_addr, hid_keyboard_report_t const *report)
-{
-  (void) dev_addr;
-
-  _keyboard_host_state.dpad = 0;
-  _keyboard_host_state.buttons = 0;
-  _keyboard_host_state.lx = GAMEPAD_JOYSTICK_MID;
-  _keyboard_host_state.ly = GAMEPAD_JOYSTICK_MID;
-  _keyboard_host_state.rx = GAMEPAD_JOYSTICK_MID;
-  _keyboard_host_state.ry = GAMEPAD_JOYSTICK_MID;
-  _keyboard_host_state.lt = 0;
-  _keyboard_host_state.rt = 0;
-
-  for(uint8_t i=0; i<7; i++)
-  {
-    uint8_t keycode = (i < 6) ? report->keycode[i] : getKeycodeFromModifier(report->modifier);
-    if ( keycode )
-    {
-      const GamepadOptions& gamepadOptions = Storage::getInstance().getGamepadOptions();
-
-      _keyboard_host_state.dpad |=
-            ((keycode == _keyboard_host_mapDpadUp.key)    ? (gamepadOptions.invertYAxis ? _keyboard_host_mapDpadDown.buttonMask : _keyboard_host_mapDpadUp.buttonMask) : _keyboard_host_state.dpad)
-          | ((keycode == _keyboard_host_mapDpadDown.key)  ? (gamepadOptions.invertYAxis ? _keyboard_host_mapDpadUp.buttonMask : _keyboard_host_mapDpadDown.buttonMask) : _keyboard_host_state.dpad)
-          | ((keycode == _keyboard_host_mapDpadLeft.key)  ? _keyboard_host_mapDpadLeft.buttonMask  : _keyboard_host_state.dpad)
-          | ((keycode == _keyboard_host_mapDpadRight.key) ? _keyboard_host_mapDpadRight.buttonMask : _keyboard_host_state.dpad)
-        ;
-
-        _keyboard_host_state.buttons |=
-            ((keycode == _keyboard_host_mapButtonB1.key)  ? _keyboard_host_mapButtonB1.buttonMask  : _keyboard_host_state.buttons)
-          | ((keycode == _keyboard_host_mapButtonB2.key)  ? _keyboard_host_mapButtonB2.buttonMask  : _keyboard_host_state.buttons)
-          | ((keycode == _keyboard_host_mapButtonB3.key)  ? _keyboard_host_mapButtonB3.buttonMask  : _keyboard_host_state.buttons)
-          | ((keycode == _keyboard_host_mapButtonB4.key)  ? _keyboard_host_mapButtonB4.buttonMask  : _keyboard_host_state.buttons)
-          | ((keycode == _keyboard_host_mapButtonL1.key)  ? _keyboard_host_mapButtonL1.buttonMask  : _keyboard_host_state.buttons)
-          | ((keycode == _keyboard_host_mapButtonR1.key)  ? _keyboard_host_mapButtonR1.buttonMask  : _keyboard_host_state.buttons)
-          | ((keycode == _keyboard_host_mapButtonL2.key)  ? _keyboard_host_mapButtonL2.buttonMask  : _keyboard_host_state.buttons)
-          | ((keycode == _keyboard_host_mapButtonR2.key)  ? _keyboard_host_mapButtonR2.buttonMask  : _keyboard_host_state.buttons)
-          | ((keycode == _keyboard_host_mapButtonS1.key)  ? _keyboard_host_mapButtonS1.buttonMask  : _keyboard_host_state.buttons)
-          | ((keycode == _keyboard_host_mapButtonS2.key)  ? _keyboard_host_mapButtonS2.buttonMask  : _keyboard_host_state.buttons)
-          | ((keycode == _keyboard_host_mapButtonL3.key)  ? _keyboard_host_mapButtonL3.buttonMask  : _keyboard_host_state.buttons)
-          | ((keycode == _keyboard_host_mapButtonR3.key)  ? _keyboard_host_mapButtonR3.buttonMask  : _keyboard_host_state.buttons)
-          | ((keycode == _keyboard_host_mapButtonA1.key)  ? _keyboard_host_mapButtonA1.buttonMask  : _keyboard_host_state.buttons)
-          | ((keycode == _keyboard_host_mapButtonA2.key)  ? _keyboard_host_mapButtonA2.buttonMask  : _keyboard_host_state.buttons)
-        ;
-
-        _keyboard_host_state.lx = GAMEPAD_JOYSTICK_MID;
-        _keyboard_host_state.ly = GAMEPAD_JOYSTICK_MID;
-        _keyboard_host_state.rx = GAMEPAD_JOYSTICK_MID;
-        _keyboard_host_state.ry = GAMEPAD_JOYSTICK_MID;
-        _keyboard_host_state.lt = 0;
-        _keyboard_host_state.rt = 0;
-    }
-  }
+  // Release whatever was held when the device went away
+  device->used = false;
+  publishState();
 }
 
 // Invoked when received report from device via interrupt endpoint
 void tuh_hid_report_received_cb(uint8_t dev_addr, uint8_t instance, uint8_t const* report, uint16_t len)
 {
-  (void) len;
-  uint8_t const itf_protocol = tuh_hid_interface_protocol(dev_addr, instance);
-
-  switch(itf_protocol)
-  {
-    case HID_ITF_PROTOCOL_KEYBOARD:
-      process_kbd_report(dev_addr, (hid_keyboard_report_t const*) report );
-    break;
+  KeyboardHostDevice *device = findDevice(dev_addr, instance);
+  if (device == nullptr)
+    return;
 
-    default: break;
-  }
+  device->parser.translate(report, len, device->state);
+  publishState();
 
   // continue to request to receive report
   if ( !tuh_hid_receive_report(dev_addr, instance) )
   {
     //Error: cannot request report
   }
-}
\ No newline at end of file
+}
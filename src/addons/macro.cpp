@@ -0,0 +1,99 @@
+#include "addons/macro.h"
+#include "storagemanager.h"
+#include "framesync.h"
+#include "hardware/gpio.h"
+#include "helper.h"
+#include "config.pb.h"
+
+#include <cstring>
+
+bool MacroInput::available() {
+	const MacroOptions& options = Storage::getInstance().getAddonOptions().macroOptions;
+	return options.enabled && options.macros_count > 0;
+}
+
+void MacroInput::setup() {
+	const MacroOptions& options = Storage::getInstance().getAddonOptions().macroOptions;
+	macroCount = options.macros_count;
+	memset(playbacks, 0, sizeof(playbacks));
+
+	for (uint8_t i = 0; i < macroCount; i++) {
+		const int32_t triggerPin = options.macros[i].triggerPin;
+		if (isValidPin(triggerPin)) {
+			gpio_init(triggerPin);             // Initialize pin
+			gpio_set_dir(triggerPin, GPIO_IN); // Set as INPUT
+			gpio_pull_up(triggerPin);          // Set as PULLUP
+		}
+	}
+}
+
+void MacroInput::start(const Macro & macro, Playback & playback, uint64_t now) {
+	playback.playing = true;
+	playback.step = 0;
+	playback.startMicros = now;
+	playback.elapsedMicros = 0;
+	playback.elapsedFrames = 0;
+	startStep(macro, playback);
+}
+
+void MacroInput::startStep(const Macro & macro, Playback & playback) {
+	const uint32_t step = macro.steps[playback.step];
+	const uint32_t duration = (step >> MACRO_STEP_DURATION_SHIFT) & MACRO_STEP_DURATION_MASK;
+	if (step & MACRO_STEP_FRAMES)
+		playback.elapsedFrames += duration;
+	else
+		playback.elapsedMicros += duration * MACRO_STEP_UNIT_MICROS;
+
+	playback.stepEndMicros = playback.startMicros + playback.elapsedMicros +
+		(static_cast<uint64_t>(playback.elapsedFrames) * 1000000) / MACRO_FRAME_HZ;
+}
+
+uint32_t MacroInput::advance(const Macro & macro, Playback & playback, uint64_t reportMicros) {
+	// Every step is visited at most once per poll, a program of short steps skips ahead instead of stalling the loop
+	for (pb_size_t visited = 0; reportMicros >= playback.stepEndMicros && visited < macro.steps_count; visited++) {
+		if (++playback.step < macro.steps_count) {
+			startStep(macro, playback);
+		} else if (macro.repeatWhileHeld && playback.triggerHeld) {
+			start(macro, playback, playback.stepEndMicros);
+		} else {
+			playback.playing = false;
+			return 0;
+		}
+	}
+	return macro.steps[playback.step] & MACRO_STEP_INPUT_MASK;
+}
+
+void MacroInput::preprocess() {
+	Gamepad * gamepad = Storage::getInstance().GetGamepad();
+	const MacroOptions& options = Storage::getInstance().getAddonOptions().macroOptions;
+
+	// Step changes snap to the report closest to their time rather than the first one after it
+	const uint32_t reportPeriod = FrameSync::locked() ? FRAME_SYNC_PERIOD_MICRO : GAMEPAD_POLL_MICRO;
+	const uint64_t now = getMicro();
+	const uint64_t reportMicros = now + reportPeriod / 2;
+
+	const uint32_t input = gamepad->state.buttons | (gamepad->state.dpad << MACRO_STEP_DPAD_SHIFT);
+	uint32_t triggerBits = 0;
+	uint32_t overlay = 0;
+	for (uint8_t i = 0; i < macroCount; i++) {
+		const Macro& macro = options.macros[i];
+		Playback& playback = playbacks[i];
+
+		const bool maskHeld = macro.triggerMask != 0 && (input & macro.triggerMask) == macro.triggerMask;
+		const bool held = maskHeld || (isValidPin(macro.triggerPin) && gamepad->pressedPin(macro.triggerPin));
+		if (maskHeld)
+			triggerBits |= macro.triggerMask;
+
+		if (held && !playback.triggerHeld && !playback.playing && macro.steps_count > 0)
+			start(macro, playback, now);
+		playback.triggerHeld = held;
+
+		if (playback.playing)
+			overlay |= advance(macro, playback, reportMicros);
+	}
+
+	// The trigger combination is consumed, the program output goes on top of everything else that is held
+	const uint32_t result = (input & ~triggerBits) | overlay;
+	gamepad->state.buttons = static_cast<uint16_t>(result);
+	gamepad->state.dpad = static_cast<uint8_t>((result >> MACRO_STEP_DPAD_SHIFT) & GAMEPAD_MASK_DPAD);
+}
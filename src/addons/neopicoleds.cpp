@@ -121,7 +121,6 @@ void NeoPicoLEDAddon::setup()
 	neopico = new NeoPico(-1, 0);
 	configureLEDs();
 
-	nextRunTime = make_timeout_time_ms(0); // Reset timeout
 	const FocusModeOptions& focusModeOptions = Storage::getInstance().getAddonOptions().focusModeOptions;
 	isFocusModeEnabled = focusModeOptions.enabled && focusModeOptions.rgbLockEnabled &&
 		isValidPin(focusModeOptions.pin);
@@ -130,7 +129,7 @@ void NeoPicoLEDAddon::setup()
 void NeoPicoLEDAddon::process()
 {
 	const LEDOptions& ledOptions = Storage::getInstance().getLedOptions();
-	if (!isValidPin(ledOptions.dataPin) || !time_reached(this->nextRunTime))
+	if (!isValidPin(ledOptions.dataPin))
 		return;
 
 	Gamepad * gamepad = Storage::getInstance().GetProcessedGamepad();
@@ -203,8 +202,6 @@ void NeoPicoLEDAddon::process()
 	neopico->SetFrame(frame);
 	neopico->Show();
 	AnimationStore.save();
-
-	this->nextRunTime = make_timeout_time_ms(NeoPicoLEDAddon::intervalMS);
 }
 
 std::vector<uint8_t> * NeoPicoLEDAddon::getLEDPositions(string button, std::vector<std::vector<uint8_t>> *positions)
@@ -45,7 +45,8 @@ void ReverseInput::setup()
 }
 
 void ReverseInput::update() {
-    state = !gpio_get(pinButtonReverse);
+    Gamepad * gamepad = Storage::getInstance().GetGamepad();
+    state = gamepad->pressedPin(pinButtonReverse);
 }
 
 uint8_t ReverseInput::input(uint8_t valueMask, uint16_t buttonMask, uint16_t buttonMaskReverse, uint8_t action, bool invertAxis) {
@@ -61,8 +62,8 @@ void ReverseInput::process()
     // Update Reverse State
     update();
 
-    uint32_t values = ~gpio_get_all();
     Gamepad * gamepad = Storage::getInstance().GetGamepad();
+    uint32_t values = gamepad->getPressedPins();
 
     gamepad->state.dpad = 0
         | input(values & mapDpadUp->pinMask,    mapDpadUp->buttonMask,      mapDpadDown->buttonMask,    actionUp,       invertYAxis)
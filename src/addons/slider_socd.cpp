@@ -31,10 +31,11 @@ void SliderSOCDInput::setup()
 }
 
 SOCDMode SliderSOCDInput::read() {
+    Gamepad * gamepad = Storage::getInstance().GetGamepad();
     if ( pinSliderSOCDOne != (uint8_t)-1 && pinSliderSOCDTwo != (uint8_t)-1) {
-        if ( !gpio_get(pinSliderSOCDOne)) {
+        if ( gamepad->pressedPin(pinSliderSOCDOne)) {
             return sliderSOCDModeOne;
-        } else if ( !gpio_get(pinSliderSOCDTwo)) {
+        } else if ( gamepad->pressedPin(pinSliderSOCDTwo)) {
             return sliderSOCDModeTwo;
         }
     }
@@ -26,12 +26,18 @@ void SNESpadInput::setup() {
         snesOptions.clockPin,
         snesOptions.latchPin,
         snesOptions.dataPin);
-    snes->begin();
+
+    // PIO-USB loads its programs into both PIO blocks, leave them to the keyboard host
+    const KeyboardHostOptions& keyboardHostOptions = Storage::getInstance().getAddonOptions().keyboardHostOptions;
+    if (keyboardHostOptions.enabled || !snes->beginPIO()) {
+        snes->begin();
+    }
     snes->start();
 }
 
 void SNESpadInput::process() {
-    if (nextTimer < getMillis()) {
+    // A PIO packet is decoded as soon as it is in, poll() returns right away while the next one is clocked
+    if (snes->isPIO() || nextTimer < getMillis()) {
         snes->poll();
 
         leftX = GAMEPAD_JOYSTICK_MID;
@@ -111,30 +111,30 @@ void TiltInput::preprocess()
 	// Need to invert since we're using pullups
 	tiltLeftState = 0;
 	if (pinTiltLeftAnalogUp != (uint8_t)-1) {
-		tiltLeftState |= (!gpio_get(pinTiltLeftAnalogUp) ? gamepad->mapDpadUp->buttonMask : 0);
+		tiltLeftState |= (gamepad->pressedPin(pinTiltLeftAnalogUp) ? gamepad->mapDpadUp->buttonMask : 0);
 	}
 	if (pinTiltLeftAnalogDown != (uint8_t)-1) {
-		tiltLeftState |= (!gpio_get(pinTiltLeftAnalogDown) ? gamepad->mapDpadDown->buttonMask : 0);
+		tiltLeftState |= (gamepad->pressedPin(pinTiltLeftAnalogDown) ? gamepad->mapDpadDown->buttonMask : 0);
 	}
 	if (pinTiltLeftAnalogLeft != (uint8_t)-1) {
-		tiltLeftState |= (!gpio_get(pinTiltLeftAnalogLeft) ? gamepad->mapDpadLeft->buttonMask : 0);
+		tiltLeftState |= (gamepad->pressedPin(pinTiltLeftAnalogLeft) ? gamepad->mapDpadLeft->buttonMask : 0);
 	}
 	if (pinTiltLeftAnalogRight != (uint8_t)-1) {
-		tiltLeftState |= (!gpio_get(pinTiltLeftAnalogRight) ? gamepad->mapDpadRight->buttonMask : 0);
+		tiltLeftState |= (gamepad->pressedPin(pinTiltLeftAnalogRight) ? gamepad->mapDpadRight->buttonMask : 0);
 	}
 
 	tiltRightState = 0;
 	if (pinTiltRightAnalogUp != (uint8_t)-1) {
-		tiltRightState |= (!gpio_get(pinTiltRightAnalogUp) ? gamepad->mapDpadUp->buttonMask : 0);
+		tiltRightState |= (gamepad->pressedPin(pinTiltRightAnalogUp) ? gamepad->mapDpadUp->buttonMask : 0);
 	}
 	if (pinTiltRightAnalogDown != (uint8_t)-1) {
-		tiltRightState |= (!gpio_get(pinTiltRightAnalogDown) ? gamepad->mapDpadDown->buttonMask : 0);
+		tiltRightState |= (gamepad->pressedPin(pinTiltRightAnalogDown) ? gamepad->mapDpadDown->buttonMask : 0);
 	}
 	if (pinTiltRightAnalogLeft != (uint8_t)-1) {
-		tiltRightState |= (!gpio_get(pinTiltRightAnalogLeft) ? gamepad->mapDpadLeft->buttonMask : 0);
+		tiltRightState |= (gamepad->pressedPin(pinTiltRightAnalogLeft) ? gamepad->mapDpadLeft->buttonMask : 0);
 	}
 	if (pinTiltRightAnalogRight != (uint8_t)-1) {
-		tiltRightState |= (!gpio_get(pinTiltRightAnalogRight) ? gamepad->mapDpadRight->buttonMask : 0);
+		tiltRightState |= (gamepad->pressedPin(pinTiltRightAnalogRight) ? gamepad->mapDpadRight->buttonMask : 0);
 	}
 
 	// Debounce our directional pins
@@ -166,8 +166,8 @@ void TiltInput::process()
 //Since this is an auxiliary function for appeals and such,
 //pressing Tilt1 and Tilt2 at the same time will cause the light analog stick to correspond to each of the DPad methods.
 void TiltInput::OverrideGamepad(Gamepad* gamepad, uint8_t dpad1, uint8_t dpad2) {
-	bool pinTilt1Pressed = pinTilt1 != (uint8_t)-1 && !gpio_get(pinTilt1);
-	bool pinTilt2Pressed = pinTilt2 != (uint8_t)-1 && !gpio_get(pinTilt2);
+	bool pinTilt1Pressed = pinTilt1 != (uint8_t)-1 && gamepad->pressedPin(pinTilt1);
+	bool pinTilt2Pressed = pinTilt2 != (uint8_t)-1 && gamepad->pressedPin(pinTilt2);
 
 	if (pinTilt1Pressed) {
 		gamepad->state.lx = dpadToAnalogX(dpad1) + (GAMEPAD_JOYSTICK_MID - dpadToAnalogX(dpad1)) * TILT1_FACTOR_LEFT_X;
@@ -4,6 +4,7 @@
 
 #include "storagemanager.h"
 #include "helper.h"
+#include "adcsampler.h"
 #include "config.pb.h"
 
 #include <algorithm>
@@ -17,7 +18,7 @@ bool TurboInput::available() {
 
 void TurboInput::setup()
 {
-    const TurboOptions& options = Storage::getInstance().getAddonOptions().turboOptions;
+    TurboOptions& options = Storage::getInstance().getAddonOptions().turboOptions;
     Gamepad * gamepad = Storage::getInstance().GetGamepad();
     uint32_t now = getMillis();
 
@@ -29,16 +30,17 @@ void TurboInput::setup()
     }
 
     // Turbo Dial
-    uint8_t shotCount = std::clamp<uint8_t>(options.shotCount, TURBO_SHOT_MIN, TURBO_SHOT_MAX);
+    turboDialIncrements = 0xFFF / (TURBO_SHOT_MAX - TURBO_SHOT_MIN); // 12-bit ADC
     if ( isValidPin(options.shmupDialPin) ) {
         adc_gpio_init(options.shmupDialPin);
-        adcShmupDial = 26 - options.shmupDialPin;
-        adc_select_input(adcShmupDial);
-        dialValue = adc_read(); // setup initial Dial + Turbo Speed
-        shotCount = (dialValue / turboDialIncrements) + TURBO_SHOT_MIN;
+        adcShmupDial = options.shmupDialPin - ADC_SAMPLER_FIRST_PIN;
+        AdcSampler::enableChannel(adcShmupDial);
+        dialValue = AdcSampler::read(adcShmupDial); // setup initial Dial + Turbo Speed
+        options.shotCount = (dialValue / turboDialIncrements) + TURBO_SHOT_MIN;
     } else {
         dialValue = 0;
     }
+    options.shotCount = std::clamp<uint32_t>(options.shotCount, TURBO_SHOT_MIN, TURBO_SHOT_MAX);
 
     // Setup Turbo LED if available
     if ( isValidPin(options.ledPin) ) {
@@ -80,30 +82,32 @@ void TurboInput::setup()
         debChargeTime[i] = now;
     }
     debounceMS = gamepad->debounceMS;
-    turboDialIncrements = 0xFFF / (TURBO_SHOT_MAX - TURBO_SHOT_MIN); // 12-bit ADC
     incrementValue = 0;
     lastPressed = 0;
     lastDpad = 0;
-    uIntervalMS = (uint32_t)(1000.0 / shotCount);
+    toggleCandidates = 0;
     bTurboState = false;
-    bTurboFlicker = false;
-    nextTimer = getMillis();
+    savePending = false;
+    saveIdleSince = now;
+    restartFlicker(getMicro());
 }
 
 void TurboInput::read(const TurboOptions & options)
 {
+    Gamepad * gamepad = Storage::getInstance().GetGamepad();
+
     // Get Charge Buttons
     if ( options.shmupModeEnabled ) {
         chargeState = 0;
         for (uint8_t i = 0; i < 4; i++) {
             if ( shmupBtnPin[i] != (uint8_t)-1 ) { // if pin, get the GPIO
-                chargeState |= (!gpio_get(shmupBtnPin[i]) ? shmupBtnMask[i] : 0);
+                chargeState |= (gamepad->pressedPin(shmupBtnPin[i]) ? shmupBtnMask[i] : 0);
             }
         }
     }
 
     // Get TURBO Key State
-    bTurboState = !gpio_get(options.buttonPin);
+    bTurboState = gamepad->pressedPin(options.buttonPin);
 }
 
 void TurboInput::debounce()
@@ -136,41 +140,66 @@ void TurboInput::process()
     uint16_t buttonsPressed = gamepad->state.buttons & TURBO_BUTTON_MASK;
     uint16_t dpadPressed = gamepad->state.dpad & GAMEPAD_MASK_DPAD;
 
+    // The flicker phase follows the hardware timer, never the loop, and keeps running while TURBO is held
+    advanceFlicker(getMicro());
+
     // Get Turbo Button States
     read(options);
     debounce();
 
+    // Persist shot count changes only once the controller has been left alone
+    if (savePending) {
+        uint32_t now = getMillis();
+        if (bTurboState || gamepad->state.buttons || gamepad->state.dpad) {
+            saveIdleSince = now;
+        } else if ((now - saveIdleSince) >= TURBO_SAVE_IDLE_MS) {
+            Storage::getInstance().enqueueTurboOptionsSave(options);
+            savePending = false;
+        }
+    }
+
     // Set TURBO Enable Buttons
     if (bTurboState) {
-        if (buttonsPressed && (lastPressed != buttonsPressed)) {
-            turboButtonsPressed ^= buttonsPressed; // Toggle Turbo
-            if ( options.shmupModeEnabled ) {
-                turboButtonsPressed |= alwaysEnabled;  // SHMUP Always-on Buttons Set
-            }
-            // Turn off button once turbo is toggled
-            gamepad->state.buttons &= ~(TURBO_BUTTON_MASK);
-        }
+        // A button toggles its turbo when it is let go, unless up/down changed its rate while it was held
+        toggleCandidates |= buttonsPressed & ~lastPressed;
+        toggleTurbo(lastPressed & ~buttonsPressed & toggleCandidates, options);
+        // Buttons held with TURBO are a setting chord, keep them from the host
+        gamepad->state.buttons &= ~(TURBO_BUTTON_MASK);
+        int8_t shotChange = 0;
         if (dpadPressed & GAMEPAD_MASK_DOWN && (lastDpad != dpadPressed)) {
-            if ( options.shotCount > TURBO_SHOT_MIN ) { // can't go lower than 2-shots per second
-                updateTurboShotCount(options.shotCount - 1);
-            }
+            shotChange = -1;
         } else if ( dpadPressed & GAMEPAD_MASK_UP && (lastDpad != dpadPressed)) {
-            if ( options.shotCount < TURBO_SHOT_MAX ) { // can't go higher than 60-shots per second
-                updateTurboShotCount(options.shotCount + 1);
+            shotChange = 1;
+        }
+        if (shotChange != 0) {
+            // Turbo buttons held along with TURBO get their own rate, the shared one changes otherwise
+            if (buttonsPressed) {
+                for (uint8_t i = 0; i < TURBO_BUTTON_COUNT; i++) {
+                    if (buttonsPressed & (1 << i)) {
+                        uint32_t shotCount = (i < options.buttonShotCounts_count && options.buttonShotCounts[i] != 0) ?
+                            options.buttonShotCounts[i] : options.shotCount;
+                        updateButtonShotCount(i, shotCount + shotChange);
+                    }
+                }
+                toggleCandidates &= ~buttonsPressed;
+            } else {
+                updateTurboShotCount(options.shotCount + shotChange);
             }
+            savePending = true;
+            saveIdleSince = getMillis();
         }
         lastPressed = buttonsPressed; // save last pressed
         lastDpad = dpadPressed;
         return; // Holding TURBO cancels turbo functionality
     } else {
+        toggleTurbo(toggleCandidates, options); // TURBO let go first ends the chord too
         lastPressed = 0; // disable last pressed
         lastDpad = 0; // disable last dpad
     }
 
     // Use the dial to modify our turbo shot speed (don't save on dial modify)
     if ( isValidPin(options.shmupDialPin) ) {
-        adc_select_input(adcShmupDial);
-        uint16_t rawValue = adc_read();
+        uint16_t rawValue = AdcSampler::read(adcShmupDial);
         if ( rawValue != dialValue ) {
             updateTurboShotCount((rawValue / turboDialIncrements) + TURBO_SHOT_MIN);
         }
@@ -179,7 +208,7 @@ void TurboInput::process()
 
     // Set TURBO LED if a button is going or turbo is too fast
     if ( isValidPin(options.ledPin) ) {
-        if ((gamepad->state.buttons & turboButtonsPressed) && !bTurboFlicker) {
+        if (gamepad->state.buttons & turboButtonsPressed & ~flickerMask) {
             gpio_put(options.ledPin, 0);
         } else {
             gpio_put(options.ledPin, 1);
@@ -191,27 +220,76 @@ void TurboInput::process()
         gamepad->state.buttons |= chargeState;  // Inject Mask into button states
     }
 
-    // Disable button during turbo flicker
-    if (bTurboFlicker) {
-        if ( options.shmupModeEnabled && options.shmupMixMode == SHMUP_MIX_MODE_CHARGE_PRIORITY) {
-            gamepad->state.buttons &= ~(turboButtonsPressed & ~(chargeState));  // Do not flicker charge buttons
-        } else {
-            gamepad->state.buttons &= ~(turboButtonsPressed);
-        }
+    // Disable buttons during their turbo flicker
+    if ( options.shmupModeEnabled && options.shmupMixMode == SHMUP_MIX_MODE_CHARGE_PRIORITY) {
+        gamepad->state.buttons &= ~(turboButtonsPressed & flickerMask & ~(chargeState));  // Do not flicker charge buttons
+    } else {
+        gamepad->state.buttons &= ~(turboButtonsPressed & flickerMask);
     }
+}
 
-    if (getMillis() < nextTimer) {
-        return; // don't flip if we haven't reached the next timer
+void TurboInput::toggleTurbo(uint16_t buttons, const TurboOptions& options)
+{
+    if (!buttons) {
+        return;
     }
+    turboButtonsPressed ^= buttons; // Toggle Turbo
+    if ( options.shmupModeEnabled ) {
+        turboButtonsPressed |= alwaysEnabled;  // SHMUP Always-on Buttons Set
+    }
+    toggleCandidates &= ~buttons;
+}
+
+void TurboInput::restartFlicker(uint64_t now)
+{
+    const TurboOptions& options = Storage::getInstance().getAddonOptions().turboOptions;
 
-    bTurboFlicker ^= true; // Button ON/OFF State Reverse
-    nextTimer = getMillis() + uIntervalMS; // interval to flicker-off button
+    // Buttons at the same rate flicker together
+    flickerMask = 0;
+    for (uint8_t i = 0; i < TURBO_BUTTON_COUNT; i++) {
+        uint32_t shotCount = (i < options.buttonShotCounts_count && options.buttonShotCounts[i] != 0) ?
+            options.buttonShotCounts[i] : options.shotCount;
+        shotCount = std::clamp<uint32_t>(shotCount, TURBO_SHOT_MIN, TURBO_SHOT_MAX);
+        halfPeriodMicros[i] = 1000000 / shotCount;
+        nextEdgeMicros[i] = now + halfPeriodMicros[i];
+    }
+}
+
+void TurboInput::advanceFlicker(uint64_t now)
+{
+    for (uint8_t i = 0; i < TURBO_BUTTON_COUNT; i++) {
+        if (now < nextEdgeMicros[i]) {
+            continue;
+        }
+        // Skip whole periods when the loop was away, the edges stay on the timer grid
+        uint64_t late = now - nextEdgeMicros[i];
+        uint32_t edges = 1;
+        if (late >= halfPeriodMicros[i]) {
+            edges += late / halfPeriodMicros[i];
+        }
+        nextEdgeMicros[i] += (uint64_t)edges * halfPeriodMicros[i];
+        if (edges & 1) {
+            flickerMask ^= (1 << i); // Button ON/OFF State Reverse
+        }
+    }
 }
 
 void TurboInput::updateTurboShotCount(uint8_t shotCount)
 {
     TurboOptions& options = Storage::getInstance().getAddonOptions().turboOptions;
-    options.shotCount = std::clamp<uint8_t>(shotCount, TURBO_SHOT_MIN, TURBO_SHOT_MAX);
-    Storage::getInstance().save();
-    uIntervalMS = (uint32_t)(1000.0 / options.shotCount);
+    shotCount = std::clamp<uint8_t>(shotCount, TURBO_SHOT_MIN, TURBO_SHOT_MAX);
+    if (options.shotCount != shotCount) {
+        options.shotCount = shotCount;
+        restartFlicker(getMicro());
+    }
+}
+
+void TurboInput::updateButtonShotCount(uint8_t button, uint8_t shotCount)
+{
+    TurboOptions& options = Storage::getInstance().getAddonOptions().turboOptions;
+    while (options.buttonShotCounts_count < TURBO_BUTTON_COUNT) {
+        options.buttonShotCounts[options.buttonShotCounts_count++] = 0; // Follow the shared rate
+    }
+    options.buttonShotCounts[button] = std::clamp<uint8_t>(shotCount, TURBO_SHOT_MIN, TURBO_SHOT_MAX);
+    restartFlicker(getMicro());
 }
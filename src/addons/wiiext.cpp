@@ -29,81 +29,22 @@ void WiiExtensionInput::setup() {
         WII_EXTENSION_I2C_ADDR);
     wii->begin();
     wii->start();
+
+    // Falls back to polling from process() when the queue can't get a DMA channel or the interrupt
+    backgroundPoll = wii->beginBackground();
 }
 
 void WiiExtensionInput::process() {
-    if (nextTimer < getMillis()) {
-        wii->poll();
-        
-        if (wii->extensionType == WII_EXTENSION_NUNCHUCK) {
-            buttonZ = wii->buttonZ;
-            buttonC = wii->buttonC;
-
-            leftX = map(wii->joy1X,0,1023,GAMEPAD_JOYSTICK_MIN,GAMEPAD_JOYSTICK_MAX);
-            leftY = map(wii->joy1Y,1023,0,GAMEPAD_JOYSTICK_MIN,GAMEPAD_JOYSTICK_MAX);
-            rightX = GAMEPAD_JOYSTICK_MID;
-            rightY = GAMEPAD_JOYSTICK_MID;
-
-            triggerLeft = 0;
-            triggerRight = 0;
-        } else if ((wii->extensionType == WII_EXTENSION_CLASSIC) || (wii->extensionType == WII_EXTENSION_CLASSIC_PRO)) {
-            buttonA = wii->buttonA;
-            buttonB = wii->buttonB;
-            buttonX = wii->buttonX;
-            buttonY = wii->buttonY;
-            buttonL = wii->buttonZL;
-            buttonZL = wii->buttonLT;
-            buttonR = wii->buttonZR;
-            buttonZR = wii->buttonRT;
-            dpadUp = wii->directionUp;
-            dpadDown = wii->directionDown;
-            dpadLeft = wii->directionLeft;
-            dpadRight = wii->directionRight;
-            buttonSelect = wii->buttonMinus;
-            buttonStart = wii->buttonPlus;
-            buttonHome = wii->buttonHome;
-
-            if (wii->extensionType == WII_EXTENSION_CLASSIC) {
-                triggerLeft  = wii->triggerLeft;
-                triggerRight = wii->triggerRight;
-            }
-
-            leftX = map(wii->joy1X,0,WII_ANALOG_PRECISION_3,GAMEPAD_JOYSTICK_MIN,GAMEPAD_JOYSTICK_MAX);
-            leftY = map(wii->joy1Y,WII_ANALOG_PRECISION_3,0,GAMEPAD_JOYSTICK_MIN,GAMEPAD_JOYSTICK_MAX);
-            rightX = map(wii->joy2X,0,WII_ANALOG_PRECISION_3,GAMEPAD_JOYSTICK_MIN,GAMEPAD_JOYSTICK_MAX);
-            rightY = map(wii->joy2Y,WII_ANALOG_PRECISION_3,0,GAMEPAD_JOYSTICK_MIN,GAMEPAD_JOYSTICK_MAX);
-        } else if (wii->extensionType == WII_EXTENSION_GUITAR) {
-            buttonSelect = wii->buttonMinus;
-            buttonStart = wii->buttonPlus;
-
-            dpadUp = wii->directionUp;
-            dpadDown = wii->directionDown;
-
-            buttonB = wii->fretGreen;
-            buttonA = wii->fretRed;
-            buttonX = wii->fretYellow;
-            buttonY = wii->fretBlue;
-            buttonL = wii->fretOrange;
-
-            // whammy currently maps to Joy2X in addition to the raw whammy value
-            whammyBar = wii->whammyBar;
-            buttonR = wii->pedalButton;
-
-            leftX = map(wii->joy1X,0,WII_ANALOG_PRECISION_3,GAMEPAD_JOYSTICK_MIN,GAMEPAD_JOYSTICK_MAX);
-            leftY = map(wii->joy1Y,WII_ANALOG_PRECISION_3,0,GAMEPAD_JOYSTICK_MIN,GAMEPAD_JOYSTICK_MAX);
-            rightX = map(wii->joy2X,0,WII_ANALOG_PRECISION_3,GAMEPAD_JOYSTICK_MIN,GAMEPAD_JOYSTICK_MAX);
-            rightY = GAMEPAD_JOYSTICK_MID;
-
-            triggerLeft = 0;
-            triggerRight = 0;
-        } else if (wii->extensionType == WII_EXTENSION_TAIKO) {
-            buttonL = wii->rimLeft;
-            buttonR = wii->rimRight;
-
-            dpadLeft = wii->drumLeft;
-            buttonA = wii->drumRight;
+    if (backgroundPoll) {
+        // Transfers and decoding happen in the background, only a lost extension is looked for here
+        if (nextTimer < getMillis()) {
+            wii->update();
+            nextTimer = getMillis() + uIntervalMS;
         }
-               
+        readState(wii->getState());
+    } else if (nextTimer < getMillis()) {
+        wii->poll();
+        readState(wii->getState());
         nextTimer = getMillis() + uIntervalMS;
     }
 
@@ -114,7 +55,7 @@ void WiiExtensionInput::process() {
     gamepad->state.rx = rightX;
     gamepad->state.ry = rightY;
 
-    if (wii->extensionType == WII_EXTENSION_CLASSIC) {
+    if (extensionType == WII_EXTENSION_CLASSIC) {
         gamepad->hasAnalogTriggers = true;
         gamepad->state.lt = triggerLeft;
         gamepad->state.rt = triggerRight;
@@ -142,6 +83,81 @@ void WiiExtensionInput::process() {
     if (dpadRight) gamepad->state.dpad |= GAMEPAD_MASK_RIGHT;
 }
 
+void WiiExtensionInput::readState(const WiiExtensionState & latest) {
+    // The background poll may publish again at any time, work from a copy
+    const WiiExtensionState state = latest;
+    extensionType = state.extensionType;
+
+    if (state.extensionType == WII_EXTENSION_NUNCHUCK) {
+        buttonZ = state.buttonZ;
+        buttonC = state.buttonC;
+
+        leftX = map(state.joy1X,0,1023,GAMEPAD_JOYSTICK_MIN,GAMEPAD_JOYSTICK_MAX);
+        leftY = map(state.joy1Y,1023,0,GAMEPAD_JOYSTICK_MIN,GAMEPAD_JOYSTICK_MAX);
+        rightX = GAMEPAD_JOYSTICK_MID;
+        rightY = GAMEPAD_JOYSTICK_MID;
+
+        triggerLeft = 0;
+        triggerRight = 0;
+    } else if ((state.extensionType == WII_EXTENSION_CLASSIC) || (state.extensionType == WII_EXTENSION_CLASSIC_PRO)) {
+        buttonA = state.buttonA;
+        buttonB = state.buttonB;
+        buttonX = state.buttonX;
+        buttonY = state.buttonY;
+        buttonL = state.buttonZL;
+        buttonZL = state.buttonLT;
+        buttonR = state.buttonZR;
+        buttonZR = state.buttonRT;
+        dpadUp = state.directionUp;
+        dpadDown = state.directionDown;
+        dpadLeft = state.directionLeft;
+        dpadRight = state.directionRight;
+        buttonSelect = state.buttonMinus;
+        buttonStart = state.buttonPlus;
+        buttonHome = state.buttonHome;
+
+        if (state.extensionType == WII_EXTENSION_CLASSIC) {
+            triggerLeft  = state.triggerLeft;
+            triggerRight = state.triggerRight;
+        }
+
+        leftX = map(state.joy1X,0,WII_ANALOG_PRECISION_3,GAMEPAD_JOYSTICK_MIN,GAMEPAD_JOYSTICK_MAX);
+        leftY = map(state.joy1Y,WII_ANALOG_PRECISION_3,0,GAMEPAD_JOYSTICK_MIN,GAMEPAD_JOYSTICK_MAX);
+        rightX = map(state.joy2X,0,WII_ANALOG_PRECISION_3,GAMEPAD_JOYSTICK_MIN,GAMEPAD_JOYSTICK_MAX);
+        rightY = map(state.joy2Y,WII_ANALOG_PRECISION_3,0,GAMEPAD_JOYSTICK_MIN,GAMEPAD_JOYSTICK_MAX);
+    } else if (state.extensionType == WII_EXTENSION_GUITAR) {
+        buttonSelect = state.buttonMinus;
+        buttonStart = state.buttonPlus;
+
+        dpadUp = state.directionUp;
+        dpadDown = state.directionDown;
+
+        buttonB = state.fretGreen;
+        buttonA = state.fretRed;
+        buttonX = state.fretYellow;
+        buttonY = state.fretBlue;
+        buttonL = state.fretOrange;
+
+        // whammy currently maps to Joy2X in addition to the raw whammy value
+        whammyBar = state.whammyBar;
+        buttonR = state.pedalButton;
+
+        leftX = map(state.joy1X,0,WII_ANALOG_PRECISION_3,GAMEPAD_JOYSTICK_MIN,GAMEPAD_JOYSTICK_MAX);
+        leftY = map(state.joy1Y,WII_ANALOG_PRECISION_3,0,GAMEPAD_JOYSTICK_MIN,GAMEPAD_JOYSTICK_MAX);
+        rightX = map(state.joy2X,0,WII_ANALOG_PRECISION_3,GAMEPAD_JOYSTICK_MIN,GAMEPAD_JOYSTICK_MAX);
+        rightY = GAMEPAD_JOYSTICK_MID;
+
+        triggerLeft = 0;
+        triggerRight = 0;
+    } else if (state.extensionType == WII_EXTENSION_TAIKO) {
+        buttonL = state.rimLeft;
+        buttonR = state.rimRight;
+
+        dpadLeft = state.drumLeft;
+        buttonA = state.drumRight;
+    }
+}
+
 uint16_t WiiExtensionInput::map(uint16_t x, uint16_t in_min, uint16_t in_max, uint16_t out_min, uint16_t out_max) {
     return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
 }
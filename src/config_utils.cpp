@@ -30,6 +30,7 @@
 #include "addons/turbo.h"
 #include "addons/wiiext.h"
 #include "addons/snes_input.h"
+#include "addons/macro.h"
 
 #include "CRC32.h"
 #include "FlashPROM.h"
@@ -97,6 +98,14 @@ void ConfigUtils::initUnsetPropertiesWithDefaults(Config& config)
     INIT_UNSET_PROPERTY(config.gamepadOptions, switchTpShareForDs4, false);
     INIT_UNSET_PROPERTY(config.gamepadOptions, lockHotkeys, DEFAULT_LOCK_HOTKEYS);
     INIT_UNSET_PROPERTY(config.gamepadOptions, fourWayMode, false);
+    INIT_UNSET_PROPERTY(config.gamepadOptions, usbFrameSync, DEFAULT_USB_FRAME_SYNC);
+    INIT_UNSET_PROPERTY(config.gamepadOptions, pioSampler, DEFAULT_PIO_SAMPLER);
+    INIT_UNSET_PROPERTY(config.gamepadOptions, debounceMode, DEFAULT_DEBOUNCE_MODE);
+    INIT_UNSET_PROPERTY(config.gamepadOptions, debounceSamples, DEFAULT_DEBOUNCE_SAMPLES);
+    INIT_UNSET_PROPERTY(config.gamepadOptions, debounceLockoutMicros, DEFAULT_DEBOUNCE_LOCKOUT_MICROS);
+    INIT_UNSET_PROPERTY(config.gamepadOptions, inputRecording, DEFAULT_INPUT_RECORDING);
+    INIT_UNSET_PROPERTY(config.gamepadOptions, adcSampler, DEFAULT_ADC_SAMPLER);
+    INIT_UNSET_PROPERTY(config.gamepadOptions, adcAverageSamples, DEFAULT_ADC_AVERAGE_SAMPLES);
 
     // hotkeyOptions
     HotkeyOptions& hotkeyOptions = config.hotkeyOptions;
@@ -327,6 +336,13 @@ void ConfigUtils::initUnsetPropertiesWithDefaults(Config& config)
     INIT_UNSET_PROPERTY(config.addonOptions.analogOptions, forced_circularity, !!FORCED_CIRCULARITY_ENABLED);
     INIT_UNSET_PROPERTY(config.addonOptions.analogOptions, analog_deadzone, DEFAULT_ANALOG_DEADZONE);
     INIT_UNSET_PROPERTY(config.addonOptions.analogOptions, auto_calibrate, !!AUTO_CALIBRATE_ENABLED);
+    INIT_UNSET_PROPERTY(config.addonOptions.analogOptions, radial_deadzone, !!RADIAL_DEADZONE_ENABLED);
+    INIT_UNSET_PROPERTY(config.addonOptions.analogOptions, analogAdc1Filter, ANALOG_ADC_1_FILTER);
+    INIT_UNSET_PROPERTY(config.addonOptions.analogOptions, analogAdc2Filter, ANALOG_ADC_2_FILTER);
+    INIT_UNSET_PROPERTY(config.addonOptions.analogOptions, analogFilterSamples, ANALOG_FILTER_SAMPLES);
+    INIT_UNSET_PROPERTY(config.addonOptions.analogOptions, analogFilterEmaAlpha, ANALOG_FILTER_EMA_ALPHA);
+    INIT_UNSET_PROPERTY(config.addonOptions.analogOptions, analogFilterMinCutoff, ANALOG_FILTER_MIN_CUTOFF);
+    INIT_UNSET_PROPERTY(config.addonOptions.analogOptions, analogFilterBeta, ANALOG_FILTER_BETA);
 
     // addonOptions.turboOptions
     INIT_UNSET_PROPERTY(config.addonOptions.turboOptions, enabled, !!TURBO_ENABLED);
@@ -378,6 +394,7 @@ void ConfigUtils::initUnsetPropertiesWithDefaults(Config& config)
     INIT_UNSET_PROPERTY(config.addonOptions.analogADS1219Options, i2cSCLPin, I2C_ANALOG1219_SCL_PIN);
     INIT_UNSET_PROPERTY(config.addonOptions.analogADS1219Options, i2cAddress, I2C_ANALOG1219_ADDRESS);
     INIT_UNSET_PROPERTY(config.addonOptions.analogADS1219Options, i2cSpeed, I2C_ANALOG1219_SPEED);
+    INIT_UNSET_PROPERTY(config.addonOptions.analogADS1219Options, drdyPin, I2C_ANALOG1219_DRDY_PIN);
 
     // addonOptions.dualDirectionalOptions
     INIT_UNSET_PROPERTY(config.addonOptions.dualDirectionalOptions, enabled, !!DUAL_DIRECTIONAL_ENABLED);
@@ -473,6 +490,9 @@ void ConfigUtils::initUnsetPropertiesWithDefaults(Config& config)
     INIT_UNSET_PROPERTY(config.addonOptions.focusModeOptions, oledLockEnabled, !!FOCUS_MODE_OLED_LOCK_ENABLED);
     INIT_UNSET_PROPERTY(config.addonOptions.focusModeOptions, rgbLockEnabled, !!FOCUS_MODE_RGB_LOCK_ENABLED);
     INIT_UNSET_PROPERTY(config.addonOptions.focusModeOptions, buttonLockEnabled, !!FOCUS_MODE_BUTTON_LOCK_ENABLED);
+
+    // addonOptions.macroOptions
+    INIT_UNSET_PROPERTY(config.addonOptions.macroOptions, enabled, !!MACRO_ENABLED);
 }
 
 
@@ -651,13 +671,24 @@ static void setHasFlags(const pb_msgdesc_t* fields, void* s)
             *reinterpret_cast<char*>(iter.pSize) = true;
         }
 
-        // Recurse into sub-messages
+        // Recurse into sub-messages, every element of a repeated one
         if (PB_LTYPE(iter.type) == PB_LTYPE_SUBMESSAGE)
         {
             assert(iter.submsg_desc);
             assert(iter.pData);
 
-            setHasFlags(iter.submsg_desc, iter.pData);
+            if (PB_HTYPE(iter.type) == PB_HTYPE_REPEATED && iter.pSize)
+            {
+                const pb_size_t count = *reinterpret_cast<const pb_size_t*>(iter.pSize);
+                for (pb_size_t i = 0; i < count; i++)
+                {
+                    setHasFlags(iter.submsg_desc, reinterpret_cast<char*>(iter.pData) + i * iter.data_size);
+                }
+            }
+            else
+            {
+                setHasFlags(iter.submsg_desc, iter.pData);
+            }
         }
     } while (pb_field_iter_next(&iter));
 }
@@ -3,16 +3,24 @@
 
 #include "storagemanager.h"
 #include "configmanager.h"
+#include "addonmanager.h"
 #include "AnimationStorage.hpp"
 #include "system.h"
+#include "framesync.h"
+#include "latencystats.h"
+#include "inputrecorder.h"
 #include "config_utils.h"
+#include "adcsampler.h"
+#include "addons/turbo.h"
 
+#include <algorithm>
 #include <cstring>
 #include <string>
 #include <vector>
 #include <memory>
 
 #include <pico/types.h>
+#include "hardware/adc.h"
 
 // HTTPD Includes
 #include <ArduinoJson.h>
@@ -37,6 +45,7 @@ extern struct fsdata_file file__index_html[];
 const static char* spaPaths[] = { "/display-config", "/led-config", "/pin-mapping", "/keyboard-mapping", "/settings", "/reset-settings", "/add-ons", "/custom-theme" };
 const static char* excludePaths[] = { "/css", "/images", "/js", "/static" };
 const static uint32_t rebootDelayMs = 500;
+const static char* turboButtonShotCountKeys[TURBO_BUTTON_COUNT] = { "turboShotCountB1", "turboShotCountB2", "turboShotCountB3", "turboShotCountB4", "turboShotCountL1", "turboShotCountR1", "turboShotCountL2", "turboShotCountR2" };
 static string http_post_uri;
 static char http_post_payload[LWIP_HTTPD_POST_MAX_PAYLOAD_LEN];
 static uint16_t http_post_payload_len = 0;
@@ -221,10 +230,10 @@ DynamicJsonDocument get_post_data()
 	return doc;
 }
 
-void save_hotkey(HotkeyEntry* hotkey, const DynamicJsonDocument& doc, const string hotkey_key)
+void save_hotkey(HotkeyEntry* hotkey, JsonVariantConst json)
 {
-	readDoc(hotkey->auxMask, doc, hotkey_key, "auxMask");
-	uint32_t buttonsMask = doc[hotkey_key]["buttonsMask"];
+	hotkey->auxMask = json["auxMask"];
+	uint32_t buttonsMask = json["buttonsMask"];
 	uint32_t dpadMask = 0;
 	if (buttonsMask & GAMEPAD_MASK_DU) {
 		dpadMask |= GAMEPAD_MASK_UP;
@@ -241,12 +250,21 @@ void save_hotkey(HotkeyEntry* hotkey, const DynamicJsonDocument& doc, const stri
 	buttonsMask &= ~(GAMEPAD_MASK_DU | GAMEPAD_MASK_DD | GAMEPAD_MASK_DL | GAMEPAD_MASK_DR);
 	hotkey->dpadMask = dpadMask;
 	hotkey->buttonsMask = buttonsMask;
-	readDoc(hotkey->action, doc, hotkey_key, "action");
+	hotkey->action = json["action"];
+	hotkey->has_auxMask = true;
+	hotkey->has_buttonsMask = true;
+	hotkey->has_dpadMask = true;
+	hotkey->has_action = true;
 }
 
-void load_hotkey(const HotkeyEntry* hotkey, DynamicJsonDocument& doc, const string hotkey_key)
+void save_hotkey(HotkeyEntry* hotkey, const DynamicJsonDocument& doc, const string hotkey_key)
+{
+	save_hotkey(hotkey, doc[hotkey_key]);
+}
+
+void load_hotkey(const HotkeyEntry* hotkey, JsonObject json)
 {
-	writeDoc(doc, hotkey_key, "auxMask", hotkey->auxMask);
+	json["auxMask"] = hotkey->auxMask;
 	uint32_t buttonsMask = hotkey->buttonsMask;
 	if (hotkey->dpadMask & GAMEPAD_MASK_UP) {
 		buttonsMask |= GAMEPAD_MASK_DU;
@@ -260,8 +278,13 @@ void load_hotkey(const HotkeyEntry* hotkey, DynamicJsonDocument& doc, const stri
 	if (hotkey->dpadMask & GAMEPAD_MASK_RIGHT) {
 		buttonsMask |= GAMEPAD_MASK_DR;
 	}
-	writeDoc(doc, hotkey_key, "buttonsMask", buttonsMask);
-	writeDoc(doc, hotkey_key, "action", hotkey->action);
+	json["buttonsMask"] = buttonsMask;
+	json["action"] = hotkey->action;
+}
+
+void load_hotkey(const HotkeyEntry* hotkey, DynamicJsonDocument& doc, const string hotkey_key)
+{
+	load_hotkey(hotkey, doc.createNestedObject(hotkey_key));
 }
 
 // LWIP callback on HTTP POST to validate the URI
@@ -514,6 +537,14 @@ std::string setGamepadOptions()
 	readDoc(gamepadOptions.switchTpShareForDs4, doc, "switchTpShareForDs4");
 	readDoc(gamepadOptions.lockHotkeys, doc, "lockHotkeys");
 	readDoc(gamepadOptions.fourWayMode, doc, "fourWayMode");
+	readDoc(gamepadOptions.usbFrameSync, doc, "usbFrameSync");
+	readDoc(gamepadOptions.pioSampler, doc, "pioSampler");
+	readDoc(gamepadOptions.debounceMode, doc, "debounceMode");
+	readDoc(gamepadOptions.debounceSamples, doc, "debounceSamples");
+	readDoc(gamepadOptions.debounceLockoutMicros, doc, "debounceLockoutMicros");
+	readDoc(gamepadOptions.inputRecording, doc, "inputRecording");
+	readDoc(gamepadOptions.adcSampler, doc, "adcSampler");
+	readDoc(gamepadOptions.adcAverageSamples, doc, "adcAverageSamples");
 
 	HotkeyOptions& hotkeyOptions = Storage::getInstance().getHotkeyOptions();
 	save_hotkey(&hotkeyOptions.hotkey01, doc, "hotkey01");
@@ -528,6 +559,15 @@ std::string setGamepadOptions()
 	save_hotkey(&hotkeyOptions.hotkey10, doc, "hotkey10");
 	save_hotkey(&hotkeyOptions.hotkey11, doc, "hotkey11");
 	save_hotkey(&hotkeyOptions.hotkey12, doc, "hotkey12");
+	if (doc.containsKey("extraHotkeys")) {
+		const size_t maxExtraHotkeys = sizeof(hotkeyOptions.extraHotkeys) / sizeof(hotkeyOptions.extraHotkeys[0]);
+		hotkeyOptions.extraHotkeys_count = 0;
+		for (JsonVariantConst hotkey : doc["extraHotkeys"].as<JsonArrayConst>()) {
+			if (hotkeyOptions.extraHotkeys_count >= maxExtraHotkeys)
+				break;
+			save_hotkey(&hotkeyOptions.extraHotkeys[hotkeyOptions.extraHotkeys_count++], hotkey);
+		}
+	}
 
 	ForcedSetupOptions& forcedSetupOptions = Storage::getInstance().getForcedSetupOptions();
 	readDoc(forcedSetupOptions.mode, doc, "forcedSetupMode");
@@ -548,6 +588,14 @@ std::string getGamepadOptions()
 	writeDoc(doc, "switchTpShareForDs4", gamepadOptions.switchTpShareForDs4 ? 1 : 0);
 	writeDoc(doc, "lockHotkeys", gamepadOptions.lockHotkeys ? 1 : 0);
 	writeDoc(doc, "fourWayMode", gamepadOptions.fourWayMode ? 1 : 0);
+	writeDoc(doc, "usbFrameSync", gamepadOptions.usbFrameSync ? 1 : 0);
+	writeDoc(doc, "pioSampler", gamepadOptions.pioSampler ? 1 : 0);
+	writeDoc(doc, "debounceMode", gamepadOptions.debounceMode);
+	writeDoc(doc, "debounceSamples", gamepadOptions.debounceSamples);
+	writeDoc(doc, "debounceLockoutMicros", gamepadOptions.debounceLockoutMicros);
+	writeDoc(doc, "inputRecording", gamepadOptions.inputRecording ? 1 : 0);
+	writeDoc(doc, "adcSampler", gamepadOptions.adcSampler ? 1 : 0);
+	writeDoc(doc, "adcAverageSamples", gamepadOptions.adcAverageSamples);
 
 	const PinMappings& pinMappings = Storage::getInstance().getPinMappings();
 	writeDoc(doc, "fnButtonPin", pinMappings.pinButtonFn);
@@ -565,6 +613,9 @@ std::string getGamepadOptions()
 	load_hotkey(&hotkeyOptions.hotkey10, doc, "hotkey10");
 	load_hotkey(&hotkeyOptions.hotkey11, doc, "hotkey11");
 	load_hotkey(&hotkeyOptions.hotkey12, doc, "hotkey12");
+	JsonArray extraHotkeys = doc.createNestedArray("extraHotkeys");
+	for (pb_size_t i = 0; i < hotkeyOptions.extraHotkeys_count; i++)
+		load_hotkey(&hotkeyOptions.extraHotkeys[i], extraHotkeys.createNestedObject());
 
 	ForcedSetupOptions& forcedSetupOptions = Storage::getInstance().getForcedSetupOptions();
 	writeDoc(doc, "forcedSetupMode", forcedSetupOptions.mode);
@@ -915,6 +966,25 @@ std::string setAddonOptions()
 	docToValue(analogOptions.forced_circularity, doc, "forced_circularity");
 	docToValue(analogOptions.analog_deadzone, doc, "analog_deadzone");
 	docToValue(analogOptions.auto_calibrate, doc, "auto_calibrate");
+	docToValue(analogOptions.radial_deadzone, doc, "radial_deadzone");
+	docToValue(analogOptions.adc1XCalibration.min, doc, "analogAdc1XMin");
+	docToValue(analogOptions.adc1XCalibration.center, doc, "analogAdc1XCenter");
+	docToValue(analogOptions.adc1XCalibration.max, doc, "analogAdc1XMax");
+	docToValue(analogOptions.adc1YCalibration.min, doc, "analogAdc1YMin");
+	docToValue(analogOptions.adc1YCalibration.center, doc, "analogAdc1YCenter");
+	docToValue(analogOptions.adc1YCalibration.max, doc, "analogAdc1YMax");
+	docToValue(analogOptions.adc2XCalibration.min, doc, "analogAdc2XMin");
+	docToValue(analogOptions.adc2XCalibration.center, doc, "analogAdc2XCenter");
+	docToValue(analogOptions.adc2XCalibration.max, doc, "analogAdc2XMax");
+	docToValue(analogOptions.adc2YCalibration.min, doc, "analogAdc2YMin");
+	docToValue(analogOptions.adc2YCalibration.center, doc, "analogAdc2YCenter");
+	docToValue(analogOptions.adc2YCalibration.max, doc, "analogAdc2YMax");
+	docToValue(analogOptions.analogAdc1Filter, doc, "analogAdc1Filter");
+	docToValue(analogOptions.analogAdc2Filter, doc, "analogAdc2Filter");
+	docToValue(analogOptions.analogFilterSamples, doc, "analogFilterSamples");
+	docToValue(analogOptions.analogFilterEmaAlpha, doc, "analogFilterEmaAlpha");
+	docToValue(analogOptions.analogFilterMinCutoff, doc, "analogFilterMinCutoff");
+	docToValue(analogOptions.analogFilterBeta, doc, "analogFilterBeta");
 	docToValue(analogOptions.enabled, doc, "AnalogInputEnabled");
 
     BootselButtonOptions& bootselButtonOptions = Storage::getInstance().getAddonOptions().bootselButtonOptions;
@@ -963,12 +1033,16 @@ std::string setAddonOptions()
 	docToValue(focusModeOptions.rgbLockEnabled, doc, "focusModeRgbLockEnabled");
 	docToValue(focusModeOptions.enabled, doc, "FocusModeAddonEnabled");
 
+    MacroOptions& macroOptions = Storage::getInstance().getAddonOptions().macroOptions;
+	docToValue(macroOptions.enabled, doc, "MacroInputEnabled");
+
     AnalogADS1219Options& analogADS1219Options = Storage::getInstance().getAddonOptions().analogADS1219Options;
 	docToPin(analogADS1219Options.i2cSDAPin, doc, "i2cAnalog1219SDAPin");
 	docToPin(analogADS1219Options.i2cSCLPin, doc, "i2cAnalog1219SCLPin");
 	docToValue(analogADS1219Options.i2cBlock, doc, "i2cAnalog1219Block");
 	docToValue(analogADS1219Options.i2cSpeed, doc, "i2cAnalog1219Speed");
 	docToValue(analogADS1219Options.i2cAddress, doc, "i2cAnalog1219Address");
+	docToPin(analogADS1219Options.drdyPin, doc, "i2cAnalog1219DRDYPin");
 	docToValue(analogADS1219Options.enabled, doc, "I2CAnalog1219InputEnabled");
 
     SliderOptions& sliderOptions = Storage::getInstance().getAddonOptions().sliderOptions;
@@ -1005,6 +1079,11 @@ std::string setAddonOptions()
 	docToPin(turboOptions.buttonPin, doc, "turboPin");
 	docToPin(turboOptions.ledPin, doc, "turboPinLED");
 	docToValue(turboOptions.shotCount, doc, "turboShotCount");
+	// Keep every per-button entry so a single changed field can be applied
+	while (turboOptions.buttonShotCounts_count < TURBO_BUTTON_COUNT)
+		turboOptions.buttonShotCounts[turboOptions.buttonShotCounts_count++] = 0;
+	for (uint8_t i = 0; i < TURBO_BUTTON_COUNT; i++)
+		docToValue(turboOptions.buttonShotCounts[i], doc, turboButtonShotCountKeys[i]);
 	docToValue(turboOptions.shmupModeEnabled, doc, "shmupMode");
 	docToValue(turboOptions.shmupMixMode, doc, "shmupMixMode");
 	docToValue(turboOptions.shmupAlwaysOn1, doc, "shmupAlwaysOn1");
@@ -1139,6 +1218,61 @@ std::string setPS4Options()
 	return "{\"success\":true}";
 }
 
+std::string setMacroOptions()
+{
+	DynamicJsonDocument doc = get_post_data();
+	MacroOptions& macroOptions = Storage::getInstance().getAddonOptions().macroOptions;
+
+	if (doc.containsKey("macros")) {
+		const size_t maxMacros = sizeof(macroOptions.macros) / sizeof(macroOptions.macros[0]);
+		macroOptions.macros_count = 0;
+		for (JsonVariantConst json : doc["macros"].as<JsonArrayConst>()) {
+			if (macroOptions.macros_count >= maxMacros)
+				break;
+
+			Macro& macro = macroOptions.macros[macroOptions.macros_count++];
+			macro = Macro Macro_init_zero;
+			macro.triggerMask = json["triggerMask"];
+			macro.has_triggerMask = true;
+			macro.triggerPin = json["triggerPin"] | -1;
+			macro.has_triggerPin = true;
+			macro.repeatWhileHeld = json["repeatWhileHeld"];
+			macro.has_repeatWhileHeld = true;
+
+			const size_t maxSteps = sizeof(macro.steps) / sizeof(macro.steps[0]);
+			for (JsonVariantConst step : json["steps"].as<JsonArrayConst>()) {
+				if (macro.steps_count >= maxSteps)
+					break;
+				macro.steps[macro.steps_count++] = step;
+			}
+		}
+	}
+
+	Storage::getInstance().save();
+
+	return serialize_json(doc);
+}
+
+std::string getMacroOptions()
+{
+	DynamicJsonDocument doc(LWIP_HTTPD_POST_MAX_PAYLOAD_LEN);
+	const MacroOptions& macroOptions = Storage::getInstance().getAddonOptions().macroOptions;
+
+	JsonArray macros = doc.createNestedArray("macros");
+	for (pb_size_t i = 0; i < macroOptions.macros_count; i++) {
+		const Macro& macro = macroOptions.macros[i];
+		JsonObject json = macros.createNestedObject();
+		json["triggerMask"] = macro.triggerMask;
+		json["triggerPin"] = cleanPin(macro.triggerPin);
+		json["repeatWhileHeld"] = macro.repeatWhileHeld ? 1 : 0;
+		JsonArray steps = json.createNestedArray("steps");
+		for (pb_size_t j = 0; j < macro.steps_count; j++)
+			steps.add(macro.steps[j]);
+	}
+
+	return serialize_json(doc);
+}
+
 std::string getAddonOptions()
 {
 	DynamicJsonDocument doc(LWIP_HTTPD_POST_MAX_PAYLOAD_LEN);
@@ -1155,6 +1289,25 @@ std::string getAddonOptions()
 	writeDoc(doc, "forced_circularity", analogOptions.forced_circularity);
 	writeDoc(doc, "analog_deadzone", analogOptions.analog_deadzone);
 	writeDoc(doc, "auto_calibrate", analogOptions.auto_calibrate);
+	writeDoc(doc, "radial_deadzone", analogOptions.radial_deadzone);
+	writeDoc(doc, "analogAdc1XMin", analogOptions.adc1XCalibration.min);
+	writeDoc(doc, "analogAdc1XCenter", analogOptions.adc1XCalibration.center);
+	writeDoc(doc, "analogAdc1XMax", analogOptions.adc1XCalibration.max);
+	writeDoc(doc, "analogAdc1YMin", analogOptions.adc1YCalibration.min);
+	writeDoc(doc, "analogAdc1YCenter", analogOptions.adc1YCalibration.center);
+	writeDoc(doc, "analogAdc1YMax", analogOptions.adc1YCalibration.max);
+	writeDoc(doc, "analogAdc2XMin", analogOptions.adc2XCalibration.min);
+	writeDoc(doc, "analogAdc2XCenter", analogOptions.adc2XCalibration.center);
+	writeDoc(doc, "analogAdc2XMax", analogOptions.adc2XCalibration.max);
+	writeDoc(doc, "analogAdc2YMin", analogOptions.adc2YCalibration.min);
+	writeDoc(doc, "analogAdc2YCenter", analogOptions.adc2YCalibration.center);
+	writeDoc(doc, "analogAdc2YMax", analogOptions.adc2YCalibration.max);
+	writeDoc(doc, "analogAdc1Filter", analogOptions.analogAdc1Filter);
+	writeDoc(doc, "analogAdc2Filter", analogOptions.analogAdc2Filter);
+	writeDoc(doc, "analogFilterSamples", analogOptions.analogFilterSamples);
+	writeDoc(doc, "analogFilterEmaAlpha", analogOptions.analogFilterEmaAlpha);
+	writeDoc(doc, "analogFilterMinCutoff", analogOptions.analogFilterMinCutoff);
+	writeDoc(doc, "analogFilterBeta", analogOptions.analogFilterBeta);
 	writeDoc(doc, "AnalogInputEnabled", analogOptions.enabled);
 
     const BootselButtonOptions& bootselButtonOptions = Storage::getInstance().getAddonOptions().bootselButtonOptions;
@@ -1201,6 +1354,7 @@ std::string getAddonOptions()
 	writeDoc(doc, "i2cAnalog1219Block", analogADS1219Options.i2cBlock);
 	writeDoc(doc, "i2cAnalog1219Speed", analogADS1219Options.i2cSpeed);
 	writeDoc(doc, "i2cAnalog1219Address", analogADS1219Options.i2cAddress);
+	writeDoc(doc, "i2cAnalog1219DRDYPin", cleanPin(analogADS1219Options.drdyPin));
 	writeDoc(doc, "I2CAnalog1219InputEnabled", analogADS1219Options.enabled);
 
     const SliderOptions& sliderOptions = Storage::getInstance().getAddonOptions().sliderOptions;
@@ -1237,6 +1391,8 @@ std::string getAddonOptions()
 	writeDoc(doc, "turboPin", cleanPin(turboOptions.buttonPin));
 	writeDoc(doc, "turboPinLED", cleanPin(turboOptions.ledPin));
 	writeDoc(doc, "turboShotCount", turboOptions.shotCount);
+	for (uint8_t i = 0; i < TURBO_BUTTON_COUNT; i++)
+		writeDoc(doc, turboButtonShotCountKeys[i], (i < turboOptions.buttonShotCounts_count) ? turboOptions.buttonShotCounts[i] : 0);
 	writeDoc(doc, "shmupMode", turboOptions.shmupModeEnabled);
 	writeDoc(doc, "shmupMixMode", turboOptions.shmupMixMode);
 	writeDoc(doc, "shmupAlwaysOn1", turboOptions.shmupAlwaysOn1);
@@ -1300,6 +1456,9 @@ std::string getAddonOptions()
 	writeDoc(doc, "focusModeRgbLockEnabled", focusModeOptions.rgbLockEnabled);
 	writeDoc(doc, "FocusModeAddonEnabled", focusModeOptions.enabled);
 
+	const MacroOptions& macroOptions = Storage::getInstance().getAddonOptions().macroOptions;
+	writeDoc(doc, "MacroInputEnabled", macroOptions.enabled);
+
 	return serialize_json(doc);
 }
 
@@ -1321,6 +1480,159 @@ std::string getMemoryReport()
 	return serialize_json(doc);
 }
 
+std::string getFrameJitter()
+{
+	DynamicJsonDocument doc(LWIP_HTTPD_POST_MAX_PAYLOAD_LEN);
+
+	// Captured by the last gamepad session, missing after a power cycle
+	const FrameSync::JitterHistogram* histogram = FrameSync::getJitterHistogram();
+	writeDoc(doc, "valid", histogram != nullptr ? 1 : 0);
+	if (histogram != nullptr)
+	{
+		writeDoc(doc, "usbFrameSync", histogram->sofSync ? 1 : 0);
+		writeDoc(doc, "frames", histogram->frames);
+		writeDoc(doc, "staleFrames", histogram->staleFrames);
+		writeDoc(doc, "minAge", histogram->frames > 0 ? histogram->minAge : 0);
+		writeDoc(doc, "maxAge", histogram->maxAge);
+		writeDoc(doc, "bucketMicros", FRAME_JITTER_BUCKET_MICRO);
+
+		JsonArray buckets = doc.createNestedArray("buckets");
+		for (uint32_t bucket : histogram->buckets)
+		{
+			buckets.add(bucket);
+		}
+	}
+
+	return serialize_json(doc);
+}
+
+std::string getLatencyStats()
+{
+	DynamicJsonDocument doc(LWIP_HTTPD_POST_MAX_PAYLOAD_LEN);
+
+	// Captured by the last gamepad session, missing after a power cycle
+	const LatencyStats::Stats* stats = LatencyStats::getStats();
+	writeDoc(doc, "valid", stats != nullptr && stats->polls > 0 ? 1 : 0);
+	if (stats == nullptr || stats->polls == 0)
+	{
+		return serialize_json(doc);
+	}
+
+	writeDoc(doc, "polls", stats->polls);
+	writeDoc(doc, "clockHz", stats->clockHz);
+
+	const uint32_t sampleCount = std::min<uint32_t>(stats->polls, LATENCY_STATS_SAMPLES);
+	writeDoc(doc, "samples", sampleCount);
+
+	// All values are reported in nanoseconds, p99 covers the most recent samples only
+	const uint64_t cyclesPerMicro = std::max<uint32_t>(stats->clockHz / 1000000, 1);
+	auto toNanos = [cyclesPerMicro](uint64_t cycles) { return static_cast<uint32_t>(cycles * 1000 / cyclesPerMicro); };
+
+	std::vector<uint16_t> samples;
+	samples.reserve(sampleCount);
+	for (int i = 0; i < LATENCY_STAGE_COUNT; i++)
+	{
+		const LatencyStats::StageStats& stage = stats->stages[i];
+		samples.assign(stage.samples, stage.samples + sampleCount);
+		std::sort(samples.begin(), samples.end());
+		const uint32_t p99 = samples[(sampleCount * 99 + 99) / 100 - 1] << LATENCY_STATS_SAMPLE_SHIFT;
+
+		const char* name = LatencyStats::getStageName(static_cast<LatencyStage>(i));
+		writeDoc(doc, "stages", name, "min", toNanos(stage.minCycles));
+		writeDoc(doc, "stages", name, "avg", toNanos(stage.totalCycles / stats->polls));
+		writeDoc(doc, "stages", name, "p99", toNanos(p99));
+		writeDoc(doc, "stages", name, "max", toNanos(stage.maxCycles));
+	}
+
+	return serialize_json(doc);
+}
+
+static int32_t readAnalogPin(int32_t pin)
+{
+	if (!isValidPin(pin) || pin < ADC_SAMPLER_FIRST_PIN || pin >= ADC_SAMPLER_FIRST_PIN + ADC_SAMPLER_CHANNELS)
+		return -1;
+
+	adc_gpio_init(pin);
+	return AdcSampler::read(pin - ADC_SAMPLER_FIRST_PIN);
+}
+
+std::string getAnalogRawValues()
+{
+	// Raw readings of the saved stick pins, polled by the calibration dialog to record min, center and max
+	DynamicJsonDocument doc(LWIP_HTTPD_POST_MAX_PAYLOAD_LEN);
+	const AnalogOptions& analogOptions = Storage::getInstance().getAddonOptions().analogOptions;
+	writeDoc(doc, "analogAdc1X", readAnalogPin(analogOptions.analogAdc1PinX));
+	writeDoc(doc, "analogAdc1Y", readAnalogPin(analogOptions.analogAdc1PinY));
+	writeDoc(doc, "analogAdc2X", readAnalogPin(analogOptions.analogAdc2PinX));
+	writeDoc(doc, "analogAdc2Y", readAnalogPin(analogOptions.analogAdc2PinY));
+	return serialize_json(doc);
+}
+
+std::string getInputRecording()
+{
+	// Recorded by the last gamepad session that had recording enabled, missing after a power cycle
+	const InputRecorder::Recording* recording = InputRecorder::getRecording();
+	if (recording == nullptr)
+	{
+		return "{\"valid\":0}";
+	}
+
+	// Oldest to newest, as the raw little-endian InputRecorder::Record structs. Built by hand
+	// because the base64 payload alone can outgrow the JSON document used by the other handlers
+	const uint32_t recordCount = std::min<uint32_t>(recording->count, INPUT_RECORDER_RECORDS);
+	std::string records;
+	records.reserve(recordCount * sizeof(InputRecorder::Record));
+	for (uint32_t i = recording->count - recordCount; i < recording->count; i++)
+	{
+		records.append(reinterpret_cast<const char*>(&recording->records[i % INPUT_RECORDER_RECORDS]), sizeof(InputRecorder::Record));
+	}
+
+	std::string json("{\"valid\":1,\"count\":");
+	json.append(std::to_string(recording->count));
+	json.append(",\"recordSize\":");
+	json.append(std::to_string(sizeof(InputRecorder::Record)));
+	json.append(",\"records\":\"");
+	json.append(Base64::Encode(records));
+	json.append("\"}");
+	return json;
+}
+
+std::string getAddonProfiles()
+{
+	DynamicJsonDocument doc(LWIP_HTTPD_POST_MAX_PAYLOAD_LEN);
+
+	// Captured by the last gamepad session, missing after a power cycle
+	const AddonProfileTable* profiles = AddonManager::GetProfiles();
+	writeDoc(doc, "valid", profiles != nullptr ? 1 : 0);
+	if (profiles == nullptr)
+	{
+		return serialize_json(doc);
+	}
+
+	// All values are reported in nanoseconds
+	const uint64_t cyclesPerMicro = std::max<uint32_t>(profiles->clockHz / 1000000, 1);
+	auto toNanos = [cyclesPerMicro](uint64_t cycles) { return static_cast<uint32_t>(cycles * 1000 / cyclesPerMicro); };
+
+	JsonArray addons = doc.createNestedArray("addons");
+	for (uint32_t i = 0; i < profiles->count; i++)
+	{
+		const AddonProfileEntry& entry = profiles->entries[i];
+		JsonObject addon = addons.createNestedObject();
+		addon["name"] = entry.name;
+		addon["core"] = entry.processType == CORE1_LOOP ? 1 : 0;
+		addon["preprocessCalls"] = entry.preprocess.calls;
+		addon["preprocessAvg"] = entry.preprocess.calls > 0 ? toNanos(entry.preprocess.totalCycles / entry.preprocess.calls) : 0;
+		addon["preprocessWorst"] = toNanos(entry.preprocess.worstCycles);
+		addon["processCalls"] = entry.process.calls;
+		addon["processAvg"] = entry.process.calls > 0 ? toNanos(entry.process.totalCycles / entry.process.calls) : 0;
+		addon["processWorst"] = toNanos(entry.process.worstCycles);
+		addon["overruns"] = entry.overruns;
+		addon["deadlineMisses"] = entry.deadlineMisses;
+	}
+
+	return serialize_json(doc);
+}
+
 std::string getConfig()
 {
 	return ConfigUtils::toJSON(Storage::getInstance().getConfig());
@@ -1405,6 +1717,7 @@ static const std::pair<const char*, HandlerFuncPtr> handlerFuncs[] =
 	{ "/api/setKeyMappings", setKeyMappings },
 	{ "/api/setAddonsOptions", setAddonOptions },
 	{ "/api/setPS4Options", setPS4Options },
+	{ "/api/setMacroOptions", setMacroOptions },
 	{ "/api/setSplashImage", setSplashImage },
 	{ "/api/reboot", reboot },
 	{ "/api/getDisplayOptions", getDisplayOptions },
@@ -1413,10 +1726,16 @@ static const std::pair<const char*, HandlerFuncPtr> handlerFuncs[] =
 	{ "/api/getPinMappings", getPinMappings },
 	{ "/api/getKeyMappings", getKeyMappings },
 	{ "/api/getAddonsOptions", getAddonOptions },
+	{ "/api/getMacroOptions", getMacroOptions },
 	{ "/api/resetSettings", resetSettings },
 	{ "/api/getSplashImage", getSplashImage },
 	{ "/api/getFirmwareVersion", getFirmwareVersion },
 	{ "/api/getMemoryReport", getMemoryReport },
+	{ "/api/getFrameJitter", getFrameJitter },
+	{ "/api/getLatencyStats", getLatencyStats },
+	{ "/api/getAddonProfiles", getAddonProfiles },
+	{ "/api/getInputRecording", getInputRecording },
+	{ "/api/getAnalogRawValues", getAnalogRawValues },
 	{ "/api/getUsedPins", getUsedPins },
 	{ "/api/getConfig", getConfig },
 #if !defined(NDEBUG)
@@ -0,0 +1,99 @@
+#include "framesync.h"
+
+#include "usb_driver.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pico/platform.h"
+#include "pico/time.h"
+
+#define FRAME_JITTER_MAGIC 0x4a495454
+#define FRAME_SYNC_LOCK_TIMEOUT_MICRO (3 * FRAME_SYNC_PERIOD_MICRO)
+#define FRAME_SYNC_MAX_LEAD_MICRO (FRAME_SYNC_PERIOD_MICRO - 100)
+
+// Kept out of .bss so the numbers from a gamepad session can still be read after rebooting into webconfig.
+// No comparison of start-of-frame scheduling against the free running loop has been measured yet: it
+// takes a session on a board with usbFrameSync on and one with it off, each read back from
+// /api/getFrameJitter after rebooting into webconfig
+static FrameSync::JitterHistogram __uninitialized_ram(jitterHistogram);
+
+static bool syncEnabled = false;
+static volatile bool sofSeen = false;
+static volatile uint32_t lastSofTime = 0;
+static volatile bool sampleValid = false;
+static volatile bool sampleSinceSof = false;
+static volatile uint32_t lastSampleTime = 0;
+static uint32_t peakPollDuration = 0;
+
+// Runs from the USB IRQ on core0
+static void onStartOfFrame(uint32_t frameCount) {
+    (void)frameCount;
+
+    const uint32_t now = time_us_32();
+    lastSofTime = now;
+    sofSeen = true;
+
+    if (!sampleValid) {
+        return;
+    }
+
+    jitterHistogram.frames++;
+    if (!sampleSinceSof) {
+        jitterHistogram.staleFrames++;
+    }
+    sampleSinceSof = false;
+
+    const uint32_t age = now - lastSampleTime;
+    jitterHistogram.minAge = std::min(jitterHistogram.minAge, age);
+    jitterHistogram.maxAge = std::max(jitterHistogram.maxAge, age);
+    jitterHistogram.buckets[std::min<uint32_t>(age / FRAME_JITTER_BUCKET_MICRO, FRAME_JITTER_BUCKETS - 1)]++;
+}
+
+void FrameSync::setup(bool sofSync) {
+    syncEnabled = sofSync;
+
+    memset(&jitterHistogram, 0, sizeof(jitterHistogram));
+    jitterHistogram.sofSync = sofSync ? 1 : 0;
+    jitterHistogram.minAge = UINT32_MAX;
+    jitterHistogram.magic = FRAME_JITTER_MAGIC;
+
+    // Always listen, the histogram is also useful for comparing against the free running loop
+    set_sof_callback(onStartOfFrame);
+}
+
+bool FrameSync::locked() {
+    return syncEnabled && sofSeen && (time_us_32() - lastSofTime) < FRAME_SYNC_LOCK_TIMEOUT_MICRO;
+}
+
+void FrameSync::pollComplete(uint64_t pollStart) {
+    lastSampleTime = static_cast<uint32_t>(pollStart);
+    sampleValid = true;
+    sampleSinceSof = true;
+
+    // Decaying peak, so one slow poll widens the lead for a while without pinning it forever.
+    // Rounding the step up keeps small peaks decaying all the way down
+    const uint32_t duration = static_cast<uint32_t>(time_us_64() - pollStart);
+    peakPollDuration = std::max(duration, peakPollDuration - ((peakPollDuration + 63) >> 6));
+}
+
+uint64_t FrameSync::nextPollTime(uint64_t now, uint64_t fallback) {
+    if (!locked()) {
+        return fallback;
+    }
+
+    const uint32_t lead = std::min<uint32_t>(peakPollDuration + FRAME_SYNC_GUARD_MICRO, FRAME_SYNC_MAX_LEAD_MICRO);
+    const uint32_t sinceSof = static_cast<uint32_t>(now) - lastSofTime;
+
+    // Skip the upcoming frame if its poll window has already opened, we serviced it (or missed it) already
+    uint32_t untilSof = FRAME_SYNC_PERIOD_MICRO - (sinceSof % FRAME_SYNC_PERIOD_MICRO);
+    if (untilSof <= lead) {
+        untilSof += FRAME_SYNC_PERIOD_MICRO;
+    }
+
+    return now + untilSof - lead;
+}
+
+const FrameSync::JitterHistogram* FrameSync::getJitterHistogram() {
+    return jitterHistogram.magic == FRAME_JITTER_MAGIC ? &jitterHistogram : nullptr;
+}
@@ -13,6 +13,10 @@
 
 #include "storagemanager.h"
 
+// Packing of the pin lookup entries
+#define PIN_LOOKUP_DPAD_SHIFT 16
+#define PIN_LOOKUP_FUNCTION (1U << 24)
+
 // MUST BE DEFINED for mpgs
 uint32_t getMillis() {
 	return to_ms_since_boot(get_absolute_time());
@@ -141,33 +145,104 @@ void Gamepad::setup()
 		gpio_set_dir(pinMappings.pinButtonFn, GPIO_IN); // Set as INPUT
 		gpio_pull_up(pinMappings.pinButtonFn);          // Set as PULLUP
 	}
+
+	buildPinLookup(pinMappings.pinButtonFn);
+	hotkeys.compile(hotkeyOptions);
+	debouncer.setMode(options.debounceMode, options.debounceSamples, options.debounceLockoutMicros);
 }
 
-void Gamepad::process()
+/**
+ * @brief Precompute which dpad/button/aux bits every combination of 4 neighbouring pins maps to,
+ * so a read is eight lookups instead of a test per mapping.
+ */
+void Gamepad::buildPinLookup(int32_t pinButtonFn)
 {
-	memcpy(&rawState, &state, sizeof(GamepadState));
+	memset(pinLookup, 0, sizeof(pinLookup));
 
-	// NOTE: Inverted X/Y-axis must run before SOCD and Dpad processing
+	const auto addPin = [this](uint8_t pin, uint32_t bits) {
+		for (uint8_t nibble = 0; nibble < 16; nibble++) {
+			if (nibble & (1 << (pin & 3)))
+				pinLookup[pin >> 2][nibble] |= bits;
+		}
+	};
+
+	for (int i = 0; i < GAMEPAD_DIGITAL_INPUT_COUNT; i++)
+	{
+		if (gamepadMappings[i]->isAssigned())
+		{
+			// The first four mappings are the D-pad
+			const uint32_t bits = i < 4 ? (gamepadMappings[i]->buttonMask << PIN_LOOKUP_DPAD_SHIFT) : gamepadMappings[i]->buttonMask;
+			addPin(gamepadMappings[i]->pin, bits);
+		}
+	}
+
+	if (isValidPin(pinButtonFn))
+		addPin(pinButtonFn, PIN_LOOKUP_FUNCTION);
+}
+
+inline uint32_t Gamepad::gatherPins(uint32_t values) const
+{
+	return pinLookup[0][values & 0xf]
+		| pinLookup[1][(values >> 4) & 0xf]
+		| pinLookup[2][(values >> 8) & 0xf]
+		| pinLookup[3][(values >> 12) & 0xf]
+		| pinLookup[4][(values >> 16) & 0xf]
+		| pinLookup[5][(values >> 20) & 0xf]
+		| pinLookup[6][(values >> 24) & 0xf]
+		| pinLookup[7][values >> 28]
+	;
+}
+
+/**
+ * @brief Start the PIO edge sampler if enabled, falls back to polling the pins when no PIO/DMA resources are left.
+ */
+void Gamepad::setupSampler()
+{
+	if (!options.pioSampler)
+		return;
+
+	// Only the mapped inputs are replayed edge by edge, the sampler can skip everything around them
+	uint32_t pinMask = 0;
+	for (int i = 0; i < GAMEPAD_DIGITAL_INPUT_COUNT; i++)
+	{
+		if (gamepadMappings[i]->isAssigned())
+			pinMask |= 1u << gamepadMappings[i]->pin;
+	}
+	sampler.setup(pinMask);
+}
+
+uint8_t Gamepad::invertDpad(uint8_t dpad)
+{
 	if (options.invertXAxis) {
-		bool left = (state.dpad & mapDpadLeft->buttonMask) != 0;
-		bool right = (state.dpad & mapDpadRight->buttonMask) != 0;
-		state.dpad &= ~(mapDpadLeft->buttonMask | mapDpadRight->buttonMask);
+		bool left = (dpad & mapDpadLeft->buttonMask) != 0;
+		bool right = (dpad & mapDpadRight->buttonMask) != 0;
+		dpad &= ~(mapDpadLeft->buttonMask | mapDpadRight->buttonMask);
 		if (left)
-			state.dpad |= mapDpadRight->buttonMask;
+			dpad |= mapDpadRight->buttonMask;
 		if (right)
-			state.dpad |= mapDpadLeft->buttonMask;
+			dpad |= mapDpadLeft->buttonMask;
 	}
 
 	if (options.invertYAxis) {
-		bool up = (state.dpad & mapDpadUp->buttonMask) != 0;
-		bool down = (state.dpad & mapDpadDown->buttonMask) != 0;
-		state.dpad &= ~(mapDpadUp->buttonMask | mapDpadDown->buttonMask);
+		bool up = (dpad & mapDpadUp->buttonMask) != 0;
+		bool down = (dpad & mapDpadDown->buttonMask) != 0;
+		dpad &= ~(mapDpadUp->buttonMask | mapDpadDown->buttonMask);
 		if (up)
-			state.dpad |= mapDpadDown->buttonMask;
+			dpad |= mapDpadDown->buttonMask;
 		if (down)
-			state.dpad |= mapDpadUp->buttonMask;
+			dpad |= mapDpadUp->buttonMask;
 	}
 
+	return dpad;
+}
+
+void Gamepad::process()
+{
+	memcpy(&rawState, &state, sizeof(GamepadState));
+
+	// NOTE: Inverted X/Y-axis must run before SOCD and Dpad processing
+	state.dpad = invertDpad(state.dpad);
+
 	state.dpad = runSOCDCleaner(resolveSOCDMode(options), state.dpad);
 
 	// SOCD cleaning first, allows for control over which diagonal to take/filter
@@ -212,37 +287,21 @@ void Gamepad::process()
 
 void Gamepad::read()
 {
-	const PinMappings& pinMappings = Storage::getInstance().getPinMappings();
-
 	// Need to invert since we're using pullups
-	uint32_t values = ~gpio_get_all();
-
-	state.aux = 0
-		| (values & (1 << pinMappings.pinButtonFn)) ? AUX_MASK_FUNCTION : 0;
+	readPins(~(sampler.isActive() ? sampler.capture() : gpio_get_all()));
+}
 
-	state.dpad = 0
-		| ((values & mapDpadUp->pinMask)    ? mapDpadUp->buttonMask : 0)
-		| ((values & mapDpadDown->pinMask)  ? mapDpadDown->buttonMask : 0)
-		| ((values & mapDpadLeft->pinMask)  ? mapDpadLeft->buttonMask  : 0)
-		| ((values & mapDpadRight->pinMask) ? mapDpadRight->buttonMask : 0)
-	;
+/**
+ * @brief Load the state from an inverted GPIO word.
+ */
+void Gamepad::readPins(uint32_t values)
+{
+	pressedPins = values;
+	const uint32_t gathered = gatherPins(values);
 
-	state.buttons = 0
-		| ((values & mapButtonB1->pinMask)  ? mapButtonB1->buttonMask  : 0)
-		| ((values & mapButtonB2->pinMask)  ? mapButtonB2->buttonMask  : 0)
-		| ((values & mapButtonB3->pinMask)  ? mapButtonB3->buttonMask  : 0)
-		| ((values & mapButtonB4->pinMask)  ? mapButtonB4->buttonMask  : 0)
-		| ((values & mapButtonL1->pinMask)  ? mapButtonL1->buttonMask  : 0)
-		| ((values & mapButtonR1->pinMask)  ? mapButtonR1->buttonMask  : 0)
-		| ((values & mapButtonL2->pinMask)  ? mapButtonL2->buttonMask  : 0)
-		| ((values & mapButtonR2->pinMask)  ? mapButtonR2->buttonMask  : 0)
-		| ((values & mapButtonS1->pinMask)  ? mapButtonS1->buttonMask  : 0)
-		| ((values & mapButtonS2->pinMask)  ? mapButtonS2->buttonMask  : 0)
-		| ((values & mapButtonL3->pinMask)  ? mapButtonL3->buttonMask  : 0)
-		| ((values & mapButtonR3->pinMask)  ? mapButtonR3->buttonMask  : 0)
-		| ((values & mapButtonA1->pinMask)  ? mapButtonA1->buttonMask  : 0)
-		| ((values & mapButtonA2->pinMask)  ? mapButtonA2->buttonMask  : 0)
-	;
+	state.aux = (gathered & PIN_LOOKUP_FUNCTION) ? AUX_MASK_FUNCTION : 0;
+	state.dpad = static_cast<uint8_t>(gathered >> PIN_LOOKUP_DPAD_SHIFT);
+	state.buttons = static_cast<uint16_t>(gathered);
 
 	state.lx = GAMEPAD_JOYSTICK_MID;
 	state.ly = GAMEPAD_JOYSTICK_MID;
@@ -252,7 +311,31 @@ void Gamepad::read()
 	state.rt = 0;
 }
 
+void Gamepad::mapPins(uint32_t values, GamepadState & target)
+{
+	const uint32_t gathered = gatherPins(values);
+	target.dpad = static_cast<uint8_t>(gathered >> PIN_LOOKUP_DPAD_SHIFT);
+	target.buttons = static_cast<uint16_t>(gathered);
+}
+
 void Gamepad::debounce() {
+	// The integrator counts polls, replaying edges through it would count them as samples
+	if (sampler.isActive() && debouncer.isTimeBased()) {
+		// Replay every edge since the last poll at its own timestamp, so debouncing and
+		// last/first input SOCD priority follow the real press order instead of the poll order
+		const uint64_t now = getMicro();
+		GamepadState edgeState;
+		GpioSamplerEdge edge;
+		while (sampler.nextEdge(edge)) {
+			const uint64_t edgeMicros = now - static_cast<uint32_t>(static_cast<uint32_t>(now) - edge.timeMicros);
+			mapPins(~edge.pins, edgeState);
+			debouncer.debounce(&edgeState, edgeMicros);
+			runSOCDCleaner(resolveSOCDMode(options), invertDpad(edgeState.dpad));
+		}
+	} else if (sampler.isActive()) {
+		sampler.skipEdges();
+	}
+
 	debouncer.debounce(&state);
 }
 
@@ -267,19 +350,13 @@ void Gamepad::hotkey()
 
 	GamepadHotkey action = HOTKEY_NONE;
 
-	if (pressedHotkey(hotkeyOptions.hotkey01))	action = selectHotkey(hotkeyOptions.hotkey01);
-	else if (pressedHotkey(hotkeyOptions.hotkey02))	action = selectHotkey(hotkeyOptions.hotkey02);
-	else if (pressedHotkey(hotkeyOptions.hotkey03))	action = selectHotkey(hotkeyOptions.hotkey03);
-	else if (pressedHotkey(hotkeyOptions.hotkey04))	action = selectHotkey(hotkeyOptions.hotkey04);
-	else if (pressedHotkey(hotkeyOptions.hotkey05))	action = selectHotkey(hotkeyOptions.hotkey05);
-	else if (pressedHotkey(hotkeyOptions.hotkey06))	action = selectHotkey(hotkeyOptions.hotkey06);
-	else if (pressedHotkey(hotkeyOptions.hotkey07))	action = selectHotkey(hotkeyOptions.hotkey07);
-	else if (pressedHotkey(hotkeyOptions.hotkey08))	action = selectHotkey(hotkeyOptions.hotkey08);
-	else if (pressedHotkey(hotkeyOptions.hotkey09))	action = selectHotkey(hotkeyOptions.hotkey09);
-	else if (pressedHotkey(hotkeyOptions.hotkey10))	action = selectHotkey(hotkeyOptions.hotkey10);
-	else if (pressedHotkey(hotkeyOptions.hotkey11))	action = selectHotkey(hotkeyOptions.hotkey11);
-	else if (pressedHotkey(hotkeyOptions.hotkey12))	action = selectHotkey(hotkeyOptions.hotkey12);
-	else                                        lastAction = HOTKEY_NONE;
+	const GamepadHotkeyMatch * hotkey = hotkeys.match(state);
+	if (hotkey != nullptr) {
+		hotkey->release(state);
+		action = hotkey->action;
+	} else {
+		lastAction = HOTKEY_NONE;
+	}
 	processHotkeyIfNewAction(action);
 }
 
@@ -332,6 +409,12 @@ void Gamepad::processHotkeyIfNewAction(GamepadHotkey action)
 				reqSave = true;
 			}
 			break;
+		case HOTKEY_ANALOG_CALIBRATION:
+			// The analog add-on stores the result itself once calibration is toggled off
+			if (action != lastAction) {
+				Storage::getInstance().SetAnalogCalibrationMode(!Storage::getInstance().GetAnalogCalibrationMode());
+			}
+			break;
 	}
 
 	// only save if we did something different (except NONE because NONE doesn't get here)
@@ -5,10 +5,83 @@
 
 #include "gamepad/GamepadDebouncer.h"
 
+void GamepadDebouncer::setMode(DebounceMode debounceMode, uint32_t samples, uint32_t lockoutMicros)
+{
+	mode = debounceMode;
+	eagerLockoutMicros = lockoutMicros;
+	integratorSamples = samples < 1 ? 1 : (samples > DEBOUNCE_INTEGRATOR_MAX_SAMPLES ? DEBOUNCE_INTEGRATOR_MAX_SAMPLES : samples);
+}
+
 void GamepadDebouncer::debounce(GamepadState *state)
 {
-	uint32_t now = getMillis();
+	debounce(state, getMicro());
+}
+
+void GamepadDebouncer::debounce(GamepadState *state, uint64_t nowMicros)
+{
+	switch (mode)
+	{
+		case DEBOUNCE_MODE_INTEGRATOR: debounceIntegrator(state); break;
+		case DEBOUNCE_MODE_EAGER:      debounceEager(state, nowMicros); break;
+		default:                       debounceTimed(state, static_cast<uint32_t>(nowMicros / 1000)); break;
+	}
+}
+
+/**
+ * @brief Report every change as soon as it is seen, then ignore that input for eagerLockoutMicros
+ * so its bounce can't be reported as more presses.
+ */
+void GamepadDebouncer::debounceEager(GamepadState *state, uint64_t nowMicros)
+{
+	const uint32_t sample = state->buttons | (static_cast<uint32_t>(state->dpad) << 16);
+	uint32_t changed = sample ^ eagerState;
+
+	while (changed)
+	{
+		const int bit = __builtin_ctz(changed);
+		changed &= changed - 1;
+
+		if (nowMicros >= eagerLockedUntil[bit])
+		{
+			eagerState ^= 1U << bit;
+			eagerLockedUntil[bit] = nowMicros + eagerLockoutMicros;
+		}
+	}
+
+	state->buttons = static_cast<uint16_t>(eagerState);
+	state->dpad = static_cast<uint8_t>(eagerState >> 16);
+}
+
+/**
+ * @brief Vertical counter debounce of all inputs at once, every input keeps a count of the
+ * consecutive samples that disagreed with its debounced state and toggles when it reaches integratorSamples.
+ */
+void GamepadDebouncer::debounceIntegrator(GamepadState *state)
+{
+	const uint32_t sample = state->buttons | (static_cast<uint32_t>(state->dpad) << 16);
+	const uint32_t changed = sample ^ integratorState;
 
+	// Count up where the sample disagrees, start over where it agrees
+	uint32_t carry = changed;
+	uint32_t reached = changed;
+	for (int i = 0; i < DEBOUNCE_INTEGRATOR_BITS; i++)
+	{
+		const uint32_t bit = integratorCount[i];
+		integratorCount[i] = (bit ^ carry) & changed;
+		carry &= bit;
+		reached &= ((integratorSamples >> i) & 1) ? integratorCount[i] : ~integratorCount[i];
+	}
+
+	integratorState ^= reached;
+	for (int i = 0; i < DEBOUNCE_INTEGRATOR_BITS; i++)
+		integratorCount[i] &= ~reached;
+
+	state->buttons = static_cast<uint16_t>(integratorState);
+	state->dpad = static_cast<uint8_t>(integratorState >> 16);
+}
+
+void GamepadDebouncer::debounceTimed(GamepadState *state, uint32_t now)
+{
 	for (int i = 0; i < 4; i++)
 	{
 		if ((debounceState.dpad & dpadMasks[i]) != (state->dpad & dpadMasks[i]) && (now - dpadTime[i]) > debounceMS)
@@ -0,0 +1,68 @@
+#include "gamepad/GamepadHotkeys.h"
+
+uint8_t GamepadHotkeys::modifierIndex(uint16_t buttons, uint16_t aux)
+{
+	return ((aux & AUX_MASK_FUNCTION) ? (1 << 0) : 0)
+		| ((buttons & GAMEPAD_MASK_S1) ? (1 << 1) : 0)
+		| ((buttons & GAMEPAD_MASK_S2) ? (1 << 2) : 0)
+		| ((buttons & GAMEPAD_MASK_A1) ? (1 << 3) : 0)
+		| ((buttons & GAMEPAD_MASK_A2) ? (1 << 4) : 0);
+}
+
+void GamepadHotkeys::add(const HotkeyEntry & hotkey)
+{
+	// Unbound slots can never fire, leave them out of the table
+	if (hotkey.action == HOTKEY_NONE || hotkeyCount >= GAMEPAD_HOTKEY_MAX_COUNT)
+		return;
+
+	hotkeys[hotkeyCount++] = {
+		.inputMask = (hotkey.buttonsMask & 0xFFFF) | ((hotkey.dpadMask & 0xFF) << GAMEPAD_HOTKEY_DPAD_SHIFT),
+		.auxMask = static_cast<uint16_t>(hotkey.auxMask),
+		.action = hotkey.action,
+	};
+}
+
+void GamepadHotkeys::compile(const HotkeyOptions & hotkeyOptions)
+{
+	hotkeyCount = 0;
+
+	// Configuration order is priority order, the first held hotkey wins
+	add(hotkeyOptions.hotkey01);
+	add(hotkeyOptions.hotkey02);
+	add(hotkeyOptions.hotkey03);
+	add(hotkeyOptions.hotkey04);
+	add(hotkeyOptions.hotkey05);
+	add(hotkeyOptions.hotkey06);
+	add(hotkeyOptions.hotkey07);
+	add(hotkeyOptions.hotkey08);
+	add(hotkeyOptions.hotkey09);
+	add(hotkeyOptions.hotkey10);
+	add(hotkeyOptions.hotkey11);
+	add(hotkeyOptions.hotkey12);
+	for (pb_size_t i = 0; i < hotkeyOptions.extraHotkeys_count; i++)
+		add(hotkeyOptions.extraHotkeys[i]);
+
+	uint16_t count = 0;
+	for (uint8_t combo = 0; combo < GAMEPAD_HOTKEY_MODIFIER_COMBOS; combo++) {
+		offsets[combo] = count;
+		for (uint8_t i = 0; i < hotkeyCount; i++) {
+			const uint8_t required = modifierIndex(hotkeys[i].inputMask, hotkeys[i].auxMask);
+			if ((combo & required) == required)
+				candidates[count++] = i;
+		}
+	}
+	offsets[GAMEPAD_HOTKEY_MODIFIER_COMBOS] = count;
+}
+
+const GamepadHotkeyMatch * GamepadHotkeys::match(const GamepadState & state) const
+{
+	const uint8_t combo = modifierIndex(state.buttons, state.aux);
+	const uint32_t input = state.buttons | (state.dpad << GAMEPAD_HOTKEY_DPAD_SHIFT);
+
+	for (uint16_t i = offsets[combo]; i < offsets[combo + 1]; i++) {
+		const GamepadHotkeyMatch & hotkey = hotkeys[candidates[i]];
+		if ((input & hotkey.inputMask) == hotkey.inputMask && (state.aux & hotkey.auxMask) == hotkey.auxMask)
+			return &hotkey;
+	}
+	return nullptr;
+}
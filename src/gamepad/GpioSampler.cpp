@@ -0,0 +1,147 @@
+#include "gamepad/GpioSampler.h"
+
+#include "hardware/dma.h"
+#include "hardware/gpio.h"
+#include "hardware/structs/timer.h"
+
+#include "gpio_sampler.pio.h"
+#include "PicoClaim.h"
+
+#define GPIO_SAMPLER_RING_MASK (GPIO_SAMPLER_RING_SIZE - 1)
+#define GPIO_SAMPLER_RING_BYTES (GPIO_SAMPLER_RING_SIZE * sizeof(uint32_t))
+
+// Written by DMA only, aligned so both channels can wrap on their own
+static volatile uint32_t edgePins[GPIO_SAMPLER_RING_SIZE] __attribute__((aligned(GPIO_SAMPLER_RING_BYTES)));
+static volatile uint32_t edgeTimes[GPIO_SAMPLER_RING_SIZE] __attribute__((aligned(GPIO_SAMPLER_RING_BYTES)));
+
+bool GpioSampler::claimStateMachine(uint width)
+{
+	// Same program with the width of the sampled range
+	for (uint i = 0; i < gpio_sampler_program.length; i++)
+		program[i] = gpio_sampler_program.instructions[i];
+	program[gpio_sampler_offset_sample_in] = pio_encode_in(pio_pins, width);
+	sampleProgram = gpio_sampler_program;
+	sampleProgram.instructions = program;
+
+	return claimPioStateMachine(&sampleProgram, pio, sm, offset);
+}
+
+bool GpioSampler::setup(uint32_t mask)
+{
+	if (active)
+		return true;
+
+	if (mask == 0)
+		return false;
+
+	// Lowest to highest button pin, anything in between is sampled too
+	pinMask = mask;
+	pinBase = __builtin_ctz(mask);
+	const uint width = 32 - __builtin_clz(mask) - pinBase;
+	sampledMask = (width == 32) ? 0xFFFFFFFF : (((1u << width) - 1) << pinBase);
+
+	if (!claimStateMachine(width))
+		return false;
+
+	valueChannel = claimDmaChannel();
+	timeChannel = claimDmaChannel();
+	if (valueChannel < 0 || timeChannel < 0) {
+		if (valueChannel >= 0)
+			dma_channel_unclaim(valueChannel);
+		pio_remove_program(pio, &sampleProgram, offset);
+		pio_sm_unclaim(pio, sm);
+		return false;
+	}
+
+	// Pushed value -> pin ring, paced by the RX FIFO
+	dma_channel_config valueConfig = dma_channel_get_default_config(valueChannel);
+	channel_config_set_transfer_data_size(&valueConfig, DMA_SIZE_32);
+	channel_config_set_read_increment(&valueConfig, false);
+	channel_config_set_write_increment(&valueConfig, true);
+	channel_config_set_ring(&valueConfig, true, GPIO_SAMPLER_RING_BITS + 2);
+	channel_config_set_dreq(&valueConfig, pio_get_dreq(pio, sm, false));
+	channel_config_set_chain_to(&valueConfig, timeChannel);
+	dma_channel_configure(valueChannel, &valueConfig, edgePins, &pio->rxf[sm], 1, false);
+
+	// Raw timer -> time ring, unpaced so it lands right behind the value
+	dma_channel_config timeConfig = dma_channel_get_default_config(timeChannel);
+	channel_config_set_transfer_data_size(&timeConfig, DMA_SIZE_32);
+	channel_config_set_read_increment(&timeConfig, false);
+	channel_config_set_write_increment(&timeConfig, true);
+	channel_config_set_ring(&timeConfig, true, GPIO_SAMPLER_RING_BITS + 2);
+	channel_config_set_chain_to(&timeConfig, valueChannel);
+	dma_channel_configure(timeChannel, &timeConfig, edgeTimes, &timer_hw->timerawl, 1, false);
+
+	readIndex = 0;
+	captureIndex = 0;
+	lastEdgeTime = edgeTimes[GPIO_SAMPLER_RING_MASK];
+	lastPins = gpio_get_all();
+	lastEdgePins = lastPins & sampledMask;
+
+	dma_channel_start(valueChannel);
+	gpio_sampler_program_init(pio, sm, offset, pinBase, GPIO_SAMPLER_SAMPLE_HZ);
+
+	active = true;
+	return true;
+}
+
+// Completed edges, the time channel is always the last to write an entry
+uint32_t GpioSampler::writeIndex() const
+{
+	const uint32_t writeAddr = dma_hw->ch[timeChannel].write_addr;
+	return ((writeAddr - reinterpret_cast<uint32_t>(edgeTimes)) / sizeof(uint32_t)) & GPIO_SAMPLER_RING_MASK;
+}
+
+uint32_t GpioSampler::capture()
+{
+	const uint32_t index = writeIndex();
+
+	// The chained channels reload a count of one per entry, so laps are detected through the entry
+	// before readIndex instead: it keeps the time it was handed out with until the DMA comes around.
+	// The edges left in the ring are then a mix of two laps, drop them and resync to the levels.
+	const bool lapped = edgeTimes[(readIndex - 1) & GPIO_SAMPLER_RING_MASK] != lastEdgeTime;
+	if (lapped) {
+		overruns++;
+		readIndex = index;
+		lastEdgeTime = edgeTimes[(index - 1) & GPIO_SAMPLER_RING_MASK];
+		lastEdgePins = (edgePins[(index - 1) & GPIO_SAMPLER_RING_MASK] << pinBase) & sampledMask;
+	}
+
+	uint32_t sampled = lastPins & sampledMask;
+	if (index != captureIndex || lapped) {
+		sampled = (edgePins[(index - 1) & GPIO_SAMPLER_RING_MASK] << pinBase) & sampledMask;
+		captureIndex = index;
+	}
+
+	lastPins = sampled | (gpio_get_all() & ~sampledMask);
+	return lastPins;
+}
+
+bool GpioSampler::nextEdge(GpioSamplerEdge & edge)
+{
+	while (readIndex != captureIndex) {
+		const uint32_t pins = (edgePins[readIndex] << pinBase) & sampledMask;
+		const uint32_t time = edgeTimes[readIndex];
+		readIndex = (readIndex + 1) & GPIO_SAMPLER_RING_MASK;
+		lastEdgeTime = time;
+
+		// Other pins inside the range move too, those edges carry nothing for the gamepad
+		const bool buttonEdge = ((pins ^ lastEdgePins) & pinMask) != 0;
+		lastEdgePins = pins;
+		if (buttonEdge) {
+			edge.pins = pins | (lastPins & ~sampledMask);
+			edge.timeMicros = time;
+			return true;
+		}
+	}
+	return false;
+}
+
+void GpioSampler::skipEdges()
+{
+	if (readIndex != captureIndex) {
+		readIndex = captureIndex;
+		lastEdgeTime = edgeTimes[(readIndex - 1) & GPIO_SAMPLER_RING_MASK];
+		lastEdgePins = lastPins & sampledMask;
+	}
+}
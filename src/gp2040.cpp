@@ -2,6 +2,10 @@
 #include "gp2040.h"
 #include "helper.h"
 #include "system.h"
+#include "framesync.h"
+#include "latencystats.h"
+#include "inputrecorder.h"
+#include "adcsampler.h"
 #include "enums.pb.h"
 
 #include "build_info.h"
@@ -24,9 +28,11 @@
 #include "addons/slider_socd.h"
 #include "addons/wiiext.h"
 #include "addons/snes_input.h"
+#include "addons/macro.h"
 
 // Pico includes
 #include "pico/bootrom.h"
+#include "pico/stdlib.h"
 #include "pico/time.h"
 #include "hardware/adc.h"
 
@@ -48,6 +54,18 @@ GP2040::~GP2040() {
 }
 
 void GP2040::setup() {
+	// PIO USB for the keyboard host needs 120MHz. Switch before anything derives a rate from clk_sys:
+	// the cycle counter, the GPIO sampler's PIO divider, latency statistics and add-on profiling.
+	// What the slower clock adds to key-to-report latency is unmeasured, /api/getLatencyStats on a
+	// board with the add-on enabled shows it
+	const KeyboardHostOptions& keyboardHostOptions = Storage::getInstance().getAddonOptions().keyboardHostOptions;
+	if (keyboardHostOptions.enabled && isValidPin(keyboardHostOptions.pinDplus)) {
+		set_sys_clock_khz(120000, true);
+	}
+
+	// Cycle counter for latency statistics and add-on profiling
+	System::initCycleCounter();
+
     // Setup Gamepad and Gamepad Storage
 	Gamepad * gamepad = Storage::getInstance().GetGamepad();
 	gamepad->setup();
@@ -99,11 +117,20 @@ void GP2040::setup() {
 			}
 	}
 
+	// Track USB start-of-frame for poll scheduling, latency statistics and add-on cost
+	if (!Storage::getInstance().GetConfigMode()) {
+		FrameSync::setup(gamepad->getOptions().usbFrameSync);
+		gamepad->setupSampler();
+		InputRecorder::setup(gamepad->getOptions().inputRecording);
+		LatencyStats::setup();
+		AddonManager::EnableProfiling();
+	}
+
 	// Initialize our ADC (various add-ons)
 	adc_init();
 
 	// Setup Add-ons
-  	//addons.LoadAddon(new KeyboardHostAddon(), CORE0_INPUT);
+	addons.LoadAddon(new KeyboardHostAddon(), CORE0_INPUT);
 	addons.LoadAddon(new AnalogInput(), CORE0_INPUT);
 	addons.LoadAddon(new BootselButtonAddon(), CORE0_INPUT);
 	addons.LoadAddon(new DualDirectionalInput(), CORE0_INPUT);
@@ -118,11 +145,16 @@ void GP2040::setup() {
 	addons.LoadAddon(new PlayerNumAddon(), CORE0_USBREPORT);
 	addons.LoadAddon(new SliderSOCDInput(), CORE0_INPUT);
 	addons.LoadAddon(new TiltInput(), CORE0_INPUT);
+	addons.LoadAddon(new MacroInput(), CORE0_INPUT);
+
+	// Start free-running ADC sampling once every add-on has registered its inputs
+	if (!Storage::getInstance().GetConfigMode()) {
+		AdcSampler::setup(gamepad->getOptions().adcSampler, gamepad->getOptions().adcAverageSamples);
+	}
 }
 
 void GP2040::run() {
 	Gamepad * gamepad = Storage::getInstance().GetGamepad();
-	Gamepad * processedGamepad = Storage::getInstance().GetProcessedGamepad();
 	bool configMode = Storage::getInstance().GetConfigMode();
 	while (1) { // LOOP
 		Storage::getInstance().performEnqueuedSaves();
@@ -137,41 +169,65 @@ void GP2040::run() {
 			continue;
 		}
 
-		if (nextRuntime > getMicro()) { // fix for unsigned
-			sleep_us(50); // Give some time back to our CPU (lower power consumption)
+		const uint64_t pollStart = getMicro();
+		if (nextRuntime > pollStart) { // fix for unsigned
+			if (FrameSync::locked()) {
+				// Keep USB serviced and idle until the poll window ahead of the next start-of-frame
+				tud_task();
+				best_effort_wfe_or_timeout(from_us_since_boot(nextRuntime));
+			} else {
+				sleep_us(50); // Give some time back to our CPU (lower power consumption)
+			}
 			continue;
 		}
 
 		// Gamepad Features
+		LatencyStats::begin();
 		gamepad->read(); 	// gpio pin reads
+		InputRecorder::record(gamepad, static_cast<uint32_t>(pollStart));
+		LatencyStats::mark(LATENCY_STAGE_READ);
 	#if GAMEPAD_DEBOUNCE_MILLIS > 0
 		gamepad->debounce();
 	#endif
+		LatencyStats::mark(LATENCY_STAGE_DEBOUNCE);
 		gamepad->hotkey(); 	// check for MPGS hotkeys
 		rebootHotkeys.process(gamepad, configMode);
+		LatencyStats::mark(LATENCY_STAGE_HOTKEY);
 
 		// Pre-Process add-ons for MPGS
 		addons.PreprocessAddons(ADDON_PROCESS::CORE0_INPUT);
+		LatencyStats::mark(LATENCY_STAGE_PREPROCESS_ADDONS);
 		
 		gamepad->process(); // process through MPGS
+		LatencyStats::mark(LATENCY_STAGE_PROCESS);
 
 		// (Post) Process for add-ons
 		addons.ProcessAddons(ADDON_PROCESS::CORE0_INPUT);
+		LatencyStats::mark(LATENCY_STAGE_PROCESS_ADDONS);
 
-		// Copy Processed Gamepad for Core1 (race condition otherwise)
-		memcpy(&processedGamepad->state, &gamepad->state, sizeof(GamepadState));
+		// Hand the processed state over to Core1, it picks up the latest snapshot on its own loop
+		Storage::getInstance().PublishProcessedGamepadState(gamepad->state);
 
 		// USB FEATURES : Send/Get USB Features (including Player LEDs on X-Input)
-		send_report(gamepad->getReport(), gamepad->getReportSize());
+		void * report = gamepad->getReport();
+		uint16_t reportSize = gamepad->getReportSize();
+		LatencyStats::mark(LATENCY_STAGE_REPORT_BUILD);
+		send_report(report, reportSize);
+		LatencyStats::mark(LATENCY_STAGE_SEND_REPORT);
+		FrameSync::pollComplete(pollStart);
 		Storage::getInstance().ClearFeatureData();
 		receive_report(Storage::getInstance().GetFeatureData());
 
 		// Process USB Reports
 		addons.ProcessAddons(ADDON_PROCESS::CORE0_USBREPORT);
+		LatencyStats::mark(LATENCY_STAGE_USB_REPORT);
 
 		tud_task(); // TinyUSB Task update
+		LatencyStats::mark(LATENCY_STAGE_TUD_TASK);
+		LatencyStats::end();
 
-		nextRuntime = getMicro() + GAMEPAD_POLL_MICRO;
+		const uint64_t pollEnd = getMicro();
+		nextRuntime = FrameSync::nextPollTime(pollEnd, pollEnd + GAMEPAD_POLL_MICRO);
 	}
 }
 
@@ -1,6 +1,7 @@
 // GP2040 includes
 #include "gp2040aux.h"
 #include "gamepad.h"
+#include "system.h"
 
 #include "storagemanager.h" // Global Managers
 #include "addonmanager.h"
@@ -11,6 +12,7 @@
 #include "addons/board_led.h"
 #include "addons/buzzerspeaker.h"
 #include "addons/ps4mode.h"
+#include "addons/keyboard_host.h"
 
 #include <iterator>
 
@@ -21,21 +23,26 @@ GP2040Aux::~GP2040Aux() {
 }
 
 void GP2040Aux::setup() {
-	addons.LoadAddon(new I2CDisplayAddon(), CORE1_LOOP);
-	addons.LoadAddon(new NeoPicoLEDAddon(), CORE1_LOOP);
-	addons.LoadAddon(new PlayerLEDAddon(), CORE1_LOOP);
-	addons.LoadAddon(new BoardLedAddon(), CORE1_LOOP);
-	addons.LoadAddon(new BuzzerSpeakerAddon(), CORE1_LOOP);
-	addons.LoadAddon(new PS4ModeAddon(), CORE1_LOOP);
+	// Cycle counter for add-on profiling, SysTick is per core
+	System::initCycleCounter();
+
+	// Period and worst case budget per add-on, see ScheduleAddons
+	addons.LoadAddon(new I2CDisplayAddon(), CORE1_LOOP, { I2C_DISPLAY_PERIOD_MICRO, I2C_DISPLAY_BUDGET_MICRO });
+	addons.LoadAddon(new NeoPicoLEDAddon(), CORE1_LOOP, { NEOPICO_LED_PERIOD_MICRO, NEOPICO_LED_BUDGET_MICRO });
+	addons.LoadAddon(new PlayerLEDAddon(), CORE1_LOOP, { PLED_PERIOD_MICRO, PLED_BUDGET_MICRO });
+	addons.LoadAddon(new BoardLedAddon(), CORE1_LOOP, { BOARD_LED_PERIOD_MICRO, BOARD_LED_BUDGET_MICRO });
+	addons.LoadAddon(new BuzzerSpeakerAddon(), CORE1_LOOP, { BUZZER_PERIOD_MICRO, BUZZER_BUDGET_MICRO });
+	addons.LoadAddon(new PS4ModeAddon(), CORE1_LOOP, { PS4MODE_PERIOD_MICRO, 0, true });
+	addons.LoadAddon(new KeyboardHostServiceAddon(), CORE1_LOOP, { KEYBOARD_HOST_PERIOD_MICRO, KEYBOARD_HOST_BUDGET_MICRO });
 }
 
 void GP2040Aux::run() {
 	while (1) {
+		Storage::getInstance().SyncProcessedGamepad();
+		nextRuntime = addons.ScheduleAddons(CORE1_LOOP);
 		if (nextRuntime > getMicro()) { // fix for unsigned
-			sleep_us(50); // Give some time back to our CPU (lower power consumption)
-			continue;
+			// Nothing is due, sleep until the next release (interrupts and events still wake us)
+			best_effort_wfe_or_timeout(from_us_since_boot(nextRuntime));
 		}
-		addons.ProcessAddons(CORE1_LOOP);
-		nextRuntime = getMicro() + GAMEPAD_POLL_MICRO;
 	}
 }
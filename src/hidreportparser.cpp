@@ -0,0 +1,438 @@
+#include "hidreportparser.h"
+
+#include "gamepad/GamepadState.h"
+
+// Short item prefixes with the size bits masked off, HID 1.11 section 6.2.2
+#define HID_ITEM_SIZE_MASK      0x03
+#define HID_ITEM_LONG           0xFE
+#define HID_MAIN_INPUT          0x80
+#define HID_MAIN_OUTPUT         0x90
+#define HID_MAIN_COLLECTION     0xA0
+#define HID_MAIN_FEATURE        0xB0
+#define HID_MAIN_END_COLLECTION 0xC0
+#define HID_GLOBAL_USAGE_PAGE   0x04
+#define HID_GLOBAL_LOGICAL_MIN  0x14
+#define HID_GLOBAL_LOGICAL_MAX  0x24
+#define HID_GLOBAL_REPORT_SIZE  0x74
+#define HID_GLOBAL_REPORT_ID    0x84
+#define HID_GLOBAL_REPORT_COUNT 0x94
+#define HID_GLOBAL_PUSH         0xA4
+#define HID_GLOBAL_POP          0xB4
+#define HID_LOCAL_USAGE         0x08
+#define HID_LOCAL_USAGE_MIN     0x18
+#define HID_LOCAL_USAGE_MAX     0x28
+
+#define HID_INPUT_CONSTANT      0x01
+#define HID_INPUT_VARIABLE      0x02
+#define HID_INPUT_RELATIVE      0x04
+
+#define HID_COLLECTION_APPLICATION 0x01
+
+#define HID_PAGE_GENERIC_DESKTOP 0x01
+#define HID_PAGE_KEYBOARD       0x07
+#define HID_PAGE_BUTTON         0x09
+
+#define HID_USAGE_MOUSE         0x02
+#define HID_USAGE_X             0x30
+#define HID_USAGE_Y             0x31
+#define HID_USAGE_Z             0x32
+#define HID_USAGE_RX            0x33
+#define HID_USAGE_RY            0x34
+#define HID_USAGE_RZ            0x35
+#define HID_USAGE_HAT_SWITCH    0x39
+#define HID_USAGE_DPAD_UP       0x90
+#define HID_USAGE_DPAD_DOWN     0x91
+#define HID_USAGE_DPAD_RIGHT    0x92
+#define HID_USAGE_DPAD_LEFT     0x93
+
+#define HID_BOOT_MODIFIER_USAGE 0xE0
+#define HID_BOOT_KEY_OFFSET     16
+#define HID_BOOT_KEY_COUNT      6
+#define HID_BOOT_REPORT_BITS    64
+
+#define HID_PUSH_DEPTH          2
+
+// Buttons 1-14 in the order most DirectInput pads and the DualShock 4 number them
+static const uint16_t hidButtonMasks[] = {
+    GAMEPAD_MASK_B3, GAMEPAD_MASK_B1, GAMEPAD_MASK_B2, GAMEPAD_MASK_B4,
+    GAMEPAD_MASK_L1, GAMEPAD_MASK_R1, GAMEPAD_MASK_L2, GAMEPAD_MASK_R2,
+    GAMEPAD_MASK_S1, GAMEPAD_MASK_S2, GAMEPAD_MASK_L3, GAMEPAD_MASK_R3,
+    GAMEPAD_MASK_A1, GAMEPAD_MASK_A2,
+};
+
+// Hat positions clockwise from north, anything past the last one is released
+static const uint8_t hidHatMasks[] = {
+    GAMEPAD_MASK_UP,
+    GAMEPAD_MASK_UP | GAMEPAD_MASK_RIGHT,
+    GAMEPAD_MASK_RIGHT,
+    GAMEPAD_MASK_DOWN | GAMEPAD_MASK_RIGHT,
+    GAMEPAD_MASK_DOWN,
+    GAMEPAD_MASK_DOWN | GAMEPAD_MASK_LEFT,
+    GAMEPAD_MASK_LEFT,
+    GAMEPAD_MASK_UP | GAMEPAD_MASK_LEFT,
+};
+
+struct HidGlobals {
+    uint16_t usagePage;
+    int32_t logicalMin;
+    int32_t logicalMax;
+    uint16_t reportSize;
+    uint8_t reportId;
+    uint16_t reportCount;
+};
+
+static uint32_t extract(const uint8_t * data, uint16_t bitOffset, uint8_t bitSize) {
+    const uint8_t shift = bitOffset & 7;
+    const uint8_t bytes = (shift + bitSize + 7) >> 3;
+    data += bitOffset >> 3;
+
+    uint64_t raw = 0;
+    for (uint8_t i = 0; i < bytes; i++) {
+        raw |= static_cast<uint64_t>(data[i]) << (8 * i);
+    }
+    raw >>= shift;
+    return (bitSize < 32) ? (static_cast<uint32_t>(raw) & ((1UL << bitSize) - 1)) : static_cast<uint32_t>(raw);
+}
+
+static int32_t signExtend(uint32_t value, uint8_t bitSize) {
+    if (bitSize >= 32) {
+        return static_cast<int32_t>(value);
+    }
+    return static_cast<int32_t>(value << (32 - bitSize)) >> (32 - bitSize);
+}
+
+HidReportParser::Report * HidReportParser::report(uint8_t id) {
+    for (uint8_t i = 0; i < reportCount; i++) {
+        if (reports[i].id == id) {
+            return &reports[i];
+        }
+    }
+    if (reportCount >= HID_REPORT_MAX_REPORTS) {
+        return nullptr;
+    }
+    reports[reportCount] = { .id = id, .bits = 0, .inputMask = 0, .analog = 0 };
+    return &reports[reportCount++];
+}
+
+void HidReportParser::add(const Field & field) {
+    Report * owner = report(field.reportId);
+    if (owner == nullptr || fieldCount >= HID_REPORT_MAX_FIELDS) {
+        return;
+    }
+
+    switch (field.kind) {
+        case FieldKind::BIT:
+            owner->inputMask |= field.mask;
+            break;
+        case FieldKind::KEY_ARRAY:
+            for (uint16_t usage = 0; keys != nullptr && usage < HID_REPORT_KEY_COUNT; usage++) {
+                owner->inputMask |= keys[usage];
+            }
+            break;
+        case FieldKind::HAT:
+            owner->inputMask |= static_cast<uint32_t>(GAMEPAD_MASK_DPAD) << HID_REPORT_DPAD_SHIFT;
+            break;
+        case FieldKind::AXIS:
+            owner->analog |= field.target;
+            break;
+    }
+    fields[fieldCount++] = field;
+}
+
+void HidReportParser::addVariable(uint32_t usage, uint8_t reportId, uint16_t bitOffset, uint8_t bitSize, int32_t logicalMin, int32_t logicalMax) {
+    const uint16_t page = usage >> 16;
+    const uint16_t id = usage & 0xFFFF;
+    Field field = {
+        .kind = FieldKind::BIT,
+        .reportId = reportId,
+        .bitSize = bitSize,
+        .count = 1,
+        .bitOffset = bitOffset,
+        .target = 0,
+        .mask = 0,
+        .logicalMin = logicalMin,
+        .range = 0,
+    };
+
+    if (page == HID_PAGE_KEYBOARD) {
+        if (keys != nullptr && id < HID_REPORT_KEY_COUNT) {
+            field.mask = keys[id];
+        }
+    } else if (page == HID_PAGE_BUTTON) {
+        if (id >= 1 && id <= sizeof(hidButtonMasks) / sizeof(hidButtonMasks[0])) {
+            field.mask = hidButtonMasks[id - 1];
+        }
+    } else if (page == HID_PAGE_GENERIC_DESKTOP) {
+        switch (id) {
+            case HID_USAGE_X:  field.target = HID_REPORT_ANALOG_LX; break;
+            case HID_USAGE_Y:  field.target = HID_REPORT_ANALOG_LY; break;
+            case HID_USAGE_Z:  field.target = HID_REPORT_ANALOG_RX; break;
+            case HID_USAGE_RZ: field.target = HID_REPORT_ANALOG_RY; break;
+            case HID_USAGE_RX: field.target = HID_REPORT_ANALOG_LT; break;
+            case HID_USAGE_RY: field.target = HID_REPORT_ANALOG_RT; break;
+            case HID_USAGE_HAT_SWITCH:
+                field.kind = FieldKind::HAT;
+                add(field);
+                return;
+            case HID_USAGE_DPAD_UP:    field.mask = GAMEPAD_MASK_UP << HID_REPORT_DPAD_SHIFT; break;
+            case HID_USAGE_DPAD_DOWN:  field.mask = GAMEPAD_MASK_DOWN << HID_REPORT_DPAD_SHIFT; break;
+            case HID_USAGE_DPAD_RIGHT: field.mask = GAMEPAD_MASK_RIGHT << HID_REPORT_DPAD_SHIFT; break;
+            case HID_USAGE_DPAD_LEFT:  field.mask = GAMEPAD_MASK_LEFT << HID_REPORT_DPAD_SHIFT; break;
+        }
+        if (field.target != 0 && logicalMax > logicalMin) {
+            field.kind = FieldKind::AXIS;
+            field.range = static_cast<uint32_t>(logicalMax - logicalMin);
+            add(field);
+            return;
+        }
+    }
+
+    if (field.mask != 0) {
+        add(field);
+    }
+}
+
+bool HidReportParser::compile(const uint8_t * descriptor, uint16_t length, const uint32_t * keyMasks) {
+    keys = keyMasks;
+    usesReportIds = false;
+    fieldCount = 0;
+    reportCount = 0;
+
+    HidGlobals global = { };
+    HidGlobals stack[HID_PUSH_DEPTH];
+    uint8_t depth = 0;
+
+    uint32_t usages[HID_REPORT_MAX_USAGES];
+    uint8_t usageCount = 0;
+    uint32_t usageMin = 0;
+    uint32_t usageMax = 0;
+    bool usageRange = false;
+
+    // A mouse's buttons are clicks, not gamepad buttons, its whole application collection is skipped
+    uint8_t collectionDepth = 0;
+    bool inMouse = false;
+
+    uint16_t i = 0;
+    while (i < length) {
+        const uint8_t prefix = descriptor[i++];
+        if (prefix == HID_ITEM_LONG) {
+            // Data size, long tag and data, nothing here uses them
+            if (i >= length) break;
+            i += 2 + descriptor[i];
+            continue;
+        }
+
+        const uint8_t size = ((prefix & HID_ITEM_SIZE_MASK) == 3) ? 4 : (prefix & HID_ITEM_SIZE_MASK);
+        if (i + size > length) break;
+        uint32_t data = 0;
+        for (uint8_t b = 0; b < size; b++) {
+            data |= static_cast<uint32_t>(descriptor[i + b]) << (8 * b);
+        }
+        // Logical extents are signed in the item's own size
+        const int32_t value = (size > 0) ? signExtend(data, size * 8) : 0;
+        i += size;
+
+        switch (prefix & ~HID_ITEM_SIZE_MASK) {
+            case HID_GLOBAL_USAGE_PAGE:   global.usagePage = data; break;
+            case HID_GLOBAL_LOGICAL_MIN:  global.logicalMin = value; break;
+            case HID_GLOBAL_LOGICAL_MAX:
+                // Plenty of descriptors write 255 in one byte, take it unsigned when it would end below the minimum
+                global.logicalMax = (value < global.logicalMin) ? static_cast<int32_t>(data) : value;
+                break;
+            case HID_GLOBAL_REPORT_SIZE:  global.reportSize = data; break;
+            case HID_GLOBAL_REPORT_COUNT: global.reportCount = data; break;
+            case HID_GLOBAL_REPORT_ID:
+                global.reportId = data;
+                usesReportIds = true;
+                break;
+            case HID_GLOBAL_PUSH:
+                if (depth < HID_PUSH_DEPTH) stack[depth++] = global;
+                break;
+            case HID_GLOBAL_POP:
+                if (depth > 0) global = stack[--depth];
+                break;
+            case HID_LOCAL_USAGE:
+                if (usageCount < HID_REPORT_MAX_USAGES) {
+                    usages[usageCount++] = (size == 4) ? data : ((static_cast<uint32_t>(global.usagePage) << 16) | data);
+                }
+                break;
+            case HID_LOCAL_USAGE_MIN:
+                usageMin = (size == 4) ? data : ((static_cast<uint32_t>(global.usagePage) << 16) | data);
+                usageRange = true;
+                break;
+            case HID_LOCAL_USAGE_MAX:
+                usageMax = (size == 4) ? data : ((static_cast<uint32_t>(global.usagePage) << 16) | data);
+                usageRange = true;
+                break;
+            case HID_MAIN_INPUT:
+                {
+                    Report * owner = report(global.reportId);
+                    if (owner == nullptr) break;
+                    const uint16_t bitOffset = owner->bits;
+                    owner->bits += global.reportSize * global.reportCount;
+
+                    if ((data & HID_INPUT_CONSTANT) || global.reportSize == 0 || global.reportSize > 32) {
+                        // Padding
+                    } else if (inMouse || (data & HID_INPUT_RELATIVE)) {
+                        // Motion deltas have no position to put a stick at
+                    } else if (data & HID_INPUT_VARIABLE) {
+                        for (uint16_t e = 0; e < global.reportCount; e++) {
+                            uint32_t usage = 0;
+                            if (usageRange) {
+                                usage = (usageMin + e < usageMax) ? usageMin + e : usageMax;
+                            } else if (usageCount > 0) {
+                                usage = usages[(e < usageCount) ? e : usageCount - 1];
+                            }
+                            addVariable(usage, global.reportId, bitOffset + e * global.reportSize, global.reportSize,
+                                global.logicalMin, global.logicalMax);
+                        }
+                    } else {
+                        // Arrays hold usages, only keyboards are mapped that way
+                        const uint32_t firstUsage = usageRange ? usageMin : (usageCount > 0 ? usages[0] : 0);
+                        if ((firstUsage >> 16) == HID_PAGE_KEYBOARD && keys != nullptr) {
+                            add({
+                                .kind = FieldKind::KEY_ARRAY,
+                                .reportId = global.reportId,
+                                .bitSize = static_cast<uint8_t>(global.reportSize),
+                                .count = static_cast<uint8_t>((global.reportCount < 0xFF) ? global.reportCount : 0xFF),
+                                .bitOffset = bitOffset,
+                                .target = 0,
+                                .mask = 0,
+                                .logicalMin = global.logicalMin - static_cast<int32_t>(firstUsage & 0xFFFF),
+                                .range = 0,
+                            });
+                        }
+                    }
+                }
+                usageCount = 0;
+                usageRange = false;
+                break;
+            case HID_MAIN_COLLECTION:
+                if (collectionDepth++ == 0 && data == HID_COLLECTION_APPLICATION) {
+                    inMouse = usageCount > 0 && usages[0] == ((HID_PAGE_GENERIC_DESKTOP << 16) | HID_USAGE_MOUSE);
+                }
+                usageCount = 0;
+                usageRange = false;
+                break;
+            case HID_MAIN_END_COLLECTION:
+                if (collectionDepth > 0 && --collectionDepth == 0) {
+                    inMouse = false;
+                }
+                usageCount = 0;
+                usageRange = false;
+                break;
+            case HID_MAIN_OUTPUT:
+            case HID_MAIN_FEATURE:
+                // Every main item ends the local state
+                usageCount = 0;
+                usageRange = false;
+                break;
+        }
+    }
+
+    return fieldCount > 0;
+}
+
+void HidReportParser::compileBootKeyboard(const uint32_t * keyMasks) {
+    keys = keyMasks;
+    usesReportIds = false;
+    fieldCount = 0;
+    reportCount = 0;
+
+    // Modifier bits, a reserved byte, then six key usages
+    for (uint8_t bit = 0; bit < 8; bit++) {
+        addVariable((HID_PAGE_KEYBOARD << 16) | (HID_BOOT_MODIFIER_USAGE + bit), 0, bit, 1, 0, 1);
+    }
+    add({
+        .kind = FieldKind::KEY_ARRAY,
+        .reportId = 0,
+        .bitSize = 8,
+        .count = HID_BOOT_KEY_COUNT,
+        .bitOffset = HID_BOOT_KEY_OFFSET,
+        .target = 0,
+        .mask = 0,
+        .logicalMin = 0,
+        .range = 0,
+    });
+    Report * owner = report(0);
+    if (owner != nullptr) {
+        owner->bits = HID_BOOT_REPORT_BITS;
+    }
+}
+
+void HidReportParser::translate(const uint8_t * data, uint16_t length, HidReportState & state) const {
+    uint8_t id = 0;
+    if (usesReportIds) {
+        if (length == 0) return;
+        id = data[0];
+        data++;
+        length--;
+    }
+
+    const Report * owner = nullptr;
+    for (uint8_t i = 0; i < reportCount; i++) {
+        if (reports[i].id == id) {
+            owner = &reports[i];
+            break;
+        }
+    }
+    if (owner == nullptr) return;
+
+    const uint32_t availableBits = static_cast<uint32_t>(length) * 8;
+    uint32_t inputs = 0;
+    GamepadState & gamepad = state.state;
+
+    for (uint8_t i = 0; i < fieldCount; i++) {
+        const Field & field = fields[i];
+        if (field.reportId != id || field.bitOffset + static_cast<uint32_t>(field.bitSize) * field.count > availableBits) {
+            continue;
+        }
+
+        switch (field.kind) {
+            case FieldKind::BIT:
+                if (extract(data, field.bitOffset, field.bitSize) != 0) {
+                    inputs |= field.mask;
+                }
+                break;
+            case FieldKind::KEY_ARRAY:
+                for (uint8_t e = 0; e < field.count; e++) {
+                    const int32_t usage = static_cast<int32_t>(extract(data, field.bitOffset + e * field.bitSize, field.bitSize)) - field.logicalMin;
+                    if (usage > 0 && usage < HID_REPORT_KEY_COUNT) {
+                        inputs |= keys[usage];
+                    }
+                }
+                break;
+            case FieldKind::HAT:
+                {
+                    const int32_t position = static_cast<int32_t>(extract(data, field.bitOffset, field.bitSize)) - field.logicalMin;
+                    if (position >= 0 && position < static_cast<int32_t>(sizeof(hidHatMasks))) {
+                        inputs |= static_cast<uint32_t>(hidHatMasks[position]) << HID_REPORT_DPAD_SHIFT;
+                    }
+                }
+                break;
+            case FieldKind::AXIS:
+                {
+                    const uint32_t raw = extract(data, field.bitOffset, field.bitSize);
+                    const int32_t value = (field.logicalMin < 0) ? signExtend(raw, field.bitSize) : static_cast<int32_t>(raw);
+                    uint32_t position = (value > field.logicalMin) ? static_cast<uint32_t>(value - field.logicalMin) : 0;
+                    if (position > field.range) position = field.range;
+
+                    switch (field.target) {
+                        case HID_REPORT_ANALOG_LX: gamepad.lx = (static_cast<uint64_t>(position) * GAMEPAD_JOYSTICK_MAX) / field.range; break;
+                        case HID_REPORT_ANALOG_LY: gamepad.ly = (static_cast<uint64_t>(position) * GAMEPAD_JOYSTICK_MAX) / field.range; break;
+                        case HID_REPORT_ANALOG_RX: gamepad.rx = (static_cast<uint64_t>(position) * GAMEPAD_JOYSTICK_MAX) / field.range; break;
+                        case HID_REPORT_ANALOG_RY: gamepad.ry = (static_cast<uint64_t>(position) * GAMEPAD_JOYSTICK_MAX) / field.range; break;
+                        case HID_REPORT_ANALOG_LT: gamepad.lt = (static_cast<uint64_t>(position) * 0xFF) / field.range; break;
+                        case HID_REPORT_ANALOG_RT: gamepad.rt = (static_cast<uint64_t>(position) * 0xFF) / field.range; break;
+                    }
+                }
+                break;
+        }
+    }
+
+    const uint16_t buttonMask = owner->inputMask & 0xFFFF;
+    const uint8_t dpadMask = owner->inputMask >> HID_REPORT_DPAD_SHIFT;
+    gamepad.buttons = (gamepad.buttons & ~buttonMask) | (inputs & buttonMask);
+    gamepad.dpad = (gamepad.dpad & ~dpadMask) | ((inputs >> HID_REPORT_DPAD_SHIFT) & dpadMask);
+    state.analog |= owner->analog;
+}
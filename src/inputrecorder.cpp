@@ -0,0 +1,57 @@
+#include "inputrecorder.h"
+#include "gamepad.h"
+
+#include <cstring>
+
+#include "pico/platform.h"
+
+#define INPUT_RECORDER_MAGIC 0x52454344
+
+// Kept out of .bss so a session can still be downloaded after rebooting into webconfig
+static InputRecorder::Recording __uninitialized_ram(recording);
+
+static bool recordingEnabled = false;
+
+void InputRecorder::setup(bool enabled) {
+    recordingEnabled = enabled;
+    if (!enabled) {
+        return;
+    }
+
+    memset(&recording, 0, sizeof(recording));
+    recording.magic = INPUT_RECORDER_MAGIC;
+}
+
+void InputRecorder::record(const Gamepad * gamepad, uint32_t timeMicros) {
+    if (!recordingEnabled) {
+        return;
+    }
+
+    Record next = {
+        .timeMicros = timeMicros,
+        .pins = gamepad->getPressedPins(),
+        .adc = { },
+    };
+    // Newest single conversion, before the sampler's averaging and the add-on filters
+    const uint8_t channels = AdcSampler::getChannelMask();
+    for (uint8_t channel = 0; channel < ADC_SAMPLER_CHANNELS; channel++) {
+        if (channels & (1 << channel)) {
+            next.adc[channel] = AdcSampler::read(channel, 1);
+        }
+    }
+
+    // Unchanged polls are implied by the gap between two timestamps
+    if (recording.count > 0) {
+        const Record& last = recording.records[(recording.count - 1) % INPUT_RECORDER_RECORDS];
+        if (last.pins == next.pins && memcmp(last.adc, next.adc, sizeof(next.adc)) == 0) {
+            return;
+        }
+    }
+
+    recording.records[recording.count % INPUT_RECORDER_RECORDS] = next;
+    recording.count++;
+}
+
+const InputRecorder::Recording* InputRecorder::getRecording() {
+    return recording.magic == INPUT_RECORDER_MAGIC ? &recording : nullptr;
+}
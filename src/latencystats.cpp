@@ -0,0 +1,75 @@
+#include "latencystats.h"
+#include "system.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "pico/platform.h"
+#include "hardware/clocks.h"
+
+#define LATENCY_STATS_MAGIC 0x4c415453
+
+// Kept out of .bss so the numbers from a gamepad session can still be read after rebooting into webconfig
+static LatencyStats::Stats __uninitialized_ram(stats);
+
+static uint32_t lastMark = 0;
+static uint32_t stageCycles[LATENCY_STAGE_COUNT] = { };
+
+static const char* stageNames[LATENCY_STAGE_COUNT] = {
+    "read",
+    "debounce",
+    "hotkey",
+    "preprocessAddons",
+    "process",
+    "processAddons",
+    "reportBuild",
+    "sendReport",
+    "usbReport",
+    "tudTask",
+    "total",
+};
+
+void LatencyStats::setup() {
+    memset(&stats, 0, sizeof(stats));
+    for (StageStats& stage : stats.stages) {
+        stage.minCycles = UINT32_MAX;
+    }
+    stats.clockHz = clock_get_hz(clk_sys);
+    stats.magic = LATENCY_STATS_MAGIC;
+}
+
+void LatencyStats::begin() {
+    lastMark = System::getCycleCount();
+}
+
+void LatencyStats::mark(LatencyStage stage) {
+    const uint32_t now = System::getCycleCount();
+    stageCycles[stage] = System::getCyclesElapsed(lastMark, now);
+    lastMark = now;
+}
+
+void LatencyStats::end() {
+    stageCycles[LATENCY_STAGE_TOTAL] = 0;
+    for (int i = LATENCY_STAGE_READ; i <= LATENCY_STAGE_SEND_REPORT; i++) {
+        stageCycles[LATENCY_STAGE_TOTAL] += stageCycles[i];
+    }
+
+    const uint32_t slot = stats.polls % LATENCY_STATS_SAMPLES;
+    for (int i = 0; i < LATENCY_STAGE_COUNT; i++) {
+        const uint32_t cycles = stageCycles[i];
+        StageStats& stage = stats.stages[i];
+        stage.minCycles = std::min(stage.minCycles, cycles);
+        stage.maxCycles = std::max(stage.maxCycles, cycles);
+        stage.totalCycles += cycles;
+        stage.samples[slot] = std::min<uint32_t>(cycles >> LATENCY_STATS_SAMPLE_SHIFT, UINT16_MAX);
+    }
+    stats.polls++;
+}
+
+const char* LatencyStats::getStageName(LatencyStage stage) {
+    return stageNames[stage];
+}
+
+const LatencyStats::Stats* LatencyStats::getStats() {
+    return stats.magic == LATENCY_STATS_MAGIC ? &stats : nullptr;
+}
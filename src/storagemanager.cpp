@@ -111,6 +111,20 @@ void Storage::performEnqueuedSaves()
 		animationOptionsSavePending.store(false);
 		critical_section_exit(&animationOptionsCs);
 	}
+
+	if (turboOptionsSavePending)
+	{
+		config.addonOptions.turboOptions = turboOptionsToSave;
+		save();
+		turboOptionsSavePending = false;
+	}
+
+	if (analogOptionsSavePending)
+	{
+		config.addonOptions.analogOptions = analogOptionsToSave;
+		save();
+		analogOptionsSavePending = false;
+	}
 }
 
 void Storage::enqueueAnimationOptionsSave(const AnimationOptions& animationOptions)
@@ -126,6 +140,18 @@ void Storage::enqueueAnimationOptionsSave(const AnimationOptions& animationOptio
 	critical_section_exit(&animationOptionsCs);
 }
 
+void Storage::enqueueTurboOptionsSave(const TurboOptions& turboOptions)
+{
+	turboOptionsToSave = turboOptions;
+	turboOptionsSavePending = true;
+}
+
+void Storage::enqueueAnalogOptionsSave(const AnalogOptions& analogOptions)
+{
+	analogOptionsToSave = analogOptions;
+	analogOptionsSavePending = true;
+}
+
 void Storage::ResetSettings()
 {
 	EEPROM.reset();
@@ -142,6 +168,16 @@ bool Storage::GetConfigMode()
 	return CONFIG_MODE;
 }
 
+void Storage::SetAnalogCalibrationMode(bool mode)
+{
+	analogCalibrationMode = mode;
+}
+
+bool Storage::GetAnalogCalibrationMode()
+{
+	return analogCalibrationMode;
+}
+
 void Storage::SetGamepad(Gamepad * newpad)
 {
 	gamepad = newpad;
@@ -162,6 +198,17 @@ Gamepad * Storage::GetProcessedGamepad()
 	return processedGamepad;
 }
 
+void Storage::PublishProcessedGamepadState(const GamepadState & state)
+{
+	processedGamepadState.write(state);
+}
+
+void Storage::SyncProcessedGamepad()
+{
+	if (processedGamepad != nullptr)
+		processedGamepadState.read(processedGamepad->state);
+}
+
 void Storage::SetFeatureData(uint8_t * newData)
 {
 	memcpy(newData, featureData, sizeof(uint8_t)*sizeof(featureData));
@@ -1,6 +1,7 @@
 #include "system.h"
 
 #include <hardware/flash.h>
+#include <hardware/structs/systick.h>
 #include <hardware/sync.h>
 #include <hardware/watchdog.h>
 #include <pico/multicore.h>
@@ -40,6 +41,23 @@ uint32_t System::getUsedHeap() {
     return mallinfo().uordblks;
 }
 
+void System::initCycleCounter() {
+    // SysTick is per core and not used by the SDK, count down from the full 24-bit range on the processor clock
+    systick_hw->csr = 0;
+    systick_hw->rvr = 0x00ffffff;
+    systick_hw->cvr = 0;
+    systick_hw->csr = M0PLUS_SYST_CSR_CLKSOURCE_BITS | M0PLUS_SYST_CSR_ENABLE_BITS;
+}
+
+uint32_t System::getCycleCount() {
+    // Invert so the value counts up
+    return ~systick_hw->cvr & 0x00ffffff;
+}
+
+uint32_t System::getCyclesElapsed(uint32_t start, uint32_t end) {
+    return (end - start) & 0x00ffffff;
+}
+
 void System::reboot(BootMode bootMode) {
     // Make sure that the other core is halted
     // We do not want it to be talking to devices (e.g. OLED display) while we reboot
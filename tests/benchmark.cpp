@@ -0,0 +1,182 @@
+#include "hoststub.h"
+#include "gamepadfixture.h"
+
+#include "addons/analog.h"
+#include "addons/dualdirectional.h"
+#include "addons/turbo.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+// Prints the host cost of every stage of a poll in ns/op. The numbers are for spotting regressions
+// between two builds on the same machine, they do not translate to RP2040 cycles.
+// --quick only checks that every stage still runs.
+
+#define BENCHMARK_PATTERNS 256
+
+static uint32_t patterns[BENCHMARK_PATTERNS];
+static volatile uint32_t sink;
+
+template <typename Operation>
+static double measure(const char * name, uint32_t iterations, Operation && operation) {
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; i++) {
+        operation(i);
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    const double perOperation = static_cast<double>(elapsed.count()) / iterations;
+    printf("%-26s %8.1f ns/op\n", name, perOperation);
+    return perOperation;
+}
+
+// Kept out of line like Gamepad::readPins(), so both sides pay for a call
+static void __attribute__((noinline)) readPerMapping(const Gamepad & gamepad, uint32_t values, GamepadState & state) {
+    readPinsPerMapping(gamepad, values, state);
+}
+
+static void configure() {
+    HostStub::reset();
+    Storage & storage = Storage::getInstance();
+
+    mapBoardPins(storage.getPinMappings());
+
+    GamepadOptions & options = storage.getGamepadOptions();
+    options.inputMode = INPUT_MODE_XINPUT;
+    options.socdMode = SOCD_MODE_SECOND_INPUT_PRIORITY;
+    options.dpadMode = DPAD_MODE_DIGITAL;
+    options.debounceMode = DEBOUNCE_MODE_TIMED;
+
+    // A bound hotkey so the lookup walks a real candidate list
+    HotkeyOptions & hotkeys = storage.getHotkeyOptions();
+    hotkeys.hotkey01.action = HOTKEY_SOCD_NEUTRAL;
+    hotkeys.hotkey01.buttonsMask = GAMEPAD_MASK_S1 | GAMEPAD_MASK_S2;
+    hotkeys.hotkey01.dpadMask = GAMEPAD_MASK_DOWN;
+
+    AddonOptions & addons = storage.getAddonOptions();
+    addons.turboOptions.enabled = true;
+    addons.turboOptions.buttonPin = -1;
+    addons.turboOptions.ledPin = -1;
+    addons.turboOptions.shmupDialPin = -1;
+    addons.turboOptions.shotCount = 20;
+    addons.dualDirectionalOptions.enabled = true;
+    addons.dualDirectionalOptions.upPin = -1;
+    addons.dualDirectionalOptions.downPin = -1;
+    addons.dualDirectionalOptions.leftPin = -1;
+    addons.dualDirectionalOptions.rightPin = -1;
+    addons.dualDirectionalOptions.dpadMode = DPAD_MODE_DIGITAL;
+    addons.analogOptions.enabled = true;
+    addons.analogOptions.analogAdc1PinX = 26;
+    addons.analogOptions.analogAdc1PinY = 27;
+    addons.analogOptions.analogAdc2PinX = -1;
+    addons.analogOptions.analogAdc2PinY = -1;
+    addons.analogOptions.analogAdc1Mode = DPAD_MODE_LEFT_ANALOG;
+    addons.analogOptions.analog_deadzone = 5;
+    addons.analogOptions.forced_circularity = true;
+
+    // Random mashing over the mapped pins, active low like the pull-ups
+    uint32_t seed = 0x2040;
+    for (uint32_t & pattern : patterns) {
+        seed = seed * 1664525 + 1013904223;
+        pattern = ~(seed & 0x003F3FFC);
+    }
+}
+
+int main(int argc, char ** argv) {
+    const bool quick = argc > 1 && strcmp(argv[1], "--quick") == 0;
+    const uint32_t iterations = quick ? 1000 : 2000000;
+
+    configure();
+    Storage & storage = Storage::getInstance();
+
+    Gamepad gamepad;
+    gamepad.setup();
+    storage.SetGamepad(&gamepad);
+
+    TurboInput turbo;
+    turbo.setup();
+    DualDirectionalInput dualDirectional;
+    dualDirectional.setup();
+    AnalogInput analog;
+    analog.setup();
+
+    measure("read", iterations, [&](uint32_t i) {
+        HostStub::setGpio(patterns[i % BENCHMARK_PATTERNS]);
+        gamepad.read();
+    });
+    // The pin gathering alone, against the per-mapping tests it replaced
+    measure("readPins (lookup)", iterations, [&](uint32_t i) {
+        gamepad.readPins(~patterns[i % BENCHMARK_PATTERNS]);
+        sink = gamepad.state.buttons;
+    });
+    GamepadState reference;
+    measure("readPins (per mapping)", iterations, [&](uint32_t i) {
+        readPerMapping(gamepad, ~patterns[i % BENCHMARK_PATTERNS], reference);
+        sink = reference.buttons;
+    });
+    measure("debounce", iterations, [&](uint32_t i) {
+        HostStub::setGpio(patterns[i % BENCHMARK_PATTERNS]);
+        HostStub::advanceTime(1000);
+        gamepad.read();
+        gamepad.debounce();
+    });
+    measure("hotkey", iterations, [&](uint32_t i) {
+        HostStub::setGpio(patterns[i % BENCHMARK_PATTERNS]);
+        gamepad.read();
+        gamepad.hotkey();
+    });
+    measure("process", iterations, [&](uint32_t i) {
+        HostStub::setGpio(patterns[i % BENCHMARK_PATTERNS]);
+        gamepad.read();
+        gamepad.process();
+    });
+    measure("dualdirectional", iterations, [&](uint32_t i) {
+        HostStub::setGpio(patterns[i % BENCHMARK_PATTERNS]);
+        gamepad.read();
+        dualDirectional.preprocess();
+        dualDirectional.process();
+    });
+    measure("turbo", iterations, [&](uint32_t i) {
+        HostStub::setGpio(patterns[i % BENCHMARK_PATTERNS]);
+        HostStub::advanceTime(1000);
+        gamepad.read();
+        turbo.process();
+    });
+    // Sweeps the stick around its whole throw, corners included
+    measure("analog", iterations, [&](uint32_t i) {
+        HostStub::setAdc(0, (i * 37) & 0xFFF);
+        HostStub::setAdc(1, (i * 91) & 0xFFF);
+        HostStub::advanceTime(1000);
+        analog.process();
+    });
+
+    // Stick 1 with each filter, a poll reads and filters two axes
+    AnalogOptions & analogOptions = storage.getAddonOptions().analogOptions;
+    analogOptions.forced_circularity = false;
+    const struct { AnalogFilter filter; const char * name; } filters[] = {
+        { ANALOG_FILTER_NONE, "analog (no filter)" },
+        { ANALOG_FILTER_EMA, "analog (ema)" },
+        { ANALOG_FILTER_ONE_EURO, "analog (one-euro)" },
+    };
+    for (const auto & [filter, name] : filters) {
+        analogOptions.analogAdc1Filter = filter;
+        analog.setup();
+        const double perPoll = measure(name, iterations, [&](uint32_t i) {
+            HostStub::setAdc(0, (i * 37) & 0xFFF);
+            HostStub::setAdc(1, (i * 91) & 0xFFF);
+            HostStub::advanceTime(1000);
+            analog.process();
+        });
+        printf("%-26s %8.1f ns/axis\n", "", perPoll / 2);
+    }
+
+    gamepad.read();
+    gamepad.process();
+    measure("getHIDReport", iterations, [&](uint32_t) { sink = gamepad.getHIDReport()->direction; });
+    measure("getSwitchReport", iterations, [&](uint32_t) { sink = gamepad.getSwitchReport()->hat; });
+    measure("getXInputReport", iterations, [&](uint32_t) { sink = gamepad.getXInputReport()->buttons1; });
+    measure("getPS4Report", iterations, [&](uint32_t) { sink = gamepad.getPS4Report()->dpad; });
+    measure("getKeyboardReport", iterations, [&](uint32_t) { sink = gamepad.getKeyboardReport()->keycode[0]; });
+
+    return 0;
+}
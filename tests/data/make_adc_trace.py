@@ -0,0 +1,69 @@
+#!/usr/bin/env python3
+"""
+Writes adc_trace.csv, a two-axis raw ADC trace for the analog filter tests.
+
+The trace is modelled, not captured: a stick resting off-center, a slow full circle, fast flicks to
+the edges and a quick wiggle, sampled about every millisecond with jittered and occasionally late
+polls. The readings carry Gaussian noise and rare spikes like a cheap stick on the RP2040 ADC, and
+are quantized to 12 bits.
+
+No board capture has been taken yet. test_analogfilter replays adc_capture.csv from this directory
+instead when it exists: the same micros,x,y lines, raw 12-bit readings of GPIO 26 and 27 taken once
+per poll about 1 ms apart, starting with at least a second of the stick at rest.
+"""
+
+import math
+import random
+
+ADC_MAX = 4095
+CENTER_X = 2071
+CENTER_Y = 2013
+RADIUS = 2000
+
+
+def stick(t):
+    """Noise-free stick position in ADC codes at t seconds."""
+    if t < 1.0:
+        return CENTER_X, CENTER_Y
+    if t < 3.0:
+        angle = (t - 1.0) * math.pi
+        return CENTER_X + RADIUS * math.cos(angle), CENTER_Y + RADIUS * math.sin(angle)
+    if t < 3.5:
+        return CENTER_X, CENTER_Y
+    if t < 4.5:
+        # Flicks to the left and right edges, 15 ms to get there
+        phase = (t - 3.5) % 0.25
+        target = -RADIUS if (t - 3.5) < 0.5 else RADIUS
+        if phase < 0.015:
+            return CENTER_X + target * phase / 0.015, CENTER_Y
+        if phase < 0.125:
+            return CENTER_X + target, CENTER_Y
+        if phase < 0.140:
+            return CENTER_X + target * (1.0 - (phase - 0.125) / 0.015), CENTER_Y
+        return CENTER_X, CENTER_Y
+    if t < 5.5:
+        return CENTER_X + RADIUS / 2 * math.sin(2 * math.pi * 8 * (t - 4.5)), CENTER_Y
+    return CENTER_X, CENTER_Y
+
+
+def reading(value, rng):
+    value += rng.gauss(0.0, 2.5)
+    if rng.random() < 0.01:
+        value += rng.choice((-12, 12))
+    return max(0, min(ADC_MAX, int(round(value))))
+
+
+def main():
+    rng = random.Random(2040)
+    micros = 0
+    with open("adc_trace.csv", "w") as trace:
+        trace.write("# Modelled two-axis stick trace, see make_adc_trace.py\n")
+        trace.write("micros,x,y\n")
+        while micros < 6000000:
+            x, y = stick(micros / 1e6)
+            trace.write(f"{micros},{reading(x, rng)},{reading(y, rng)}\n")
+            micros += rng.randint(950, 1050) if rng.random() > 0.002 else 4000
+
+
+if __name__ == "__main__":
+    main()
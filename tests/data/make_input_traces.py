@@ -0,0 +1,110 @@
+#!/usr/bin/env python3
+"""
+Writes the input recordings replayed by test_replay, in the format /api/getInputRecording returns.
+
+The recordings are scripted, not captured: SOCD overlaps in both press orders, opposing directions
+pressed in the same poll, rolling diagonals and a long seeded random walk over the directions, on
+the Pico's default dpad pins and, for dual_directional.json, on a second set of spare pins. Polls
+are 1 ms apart and every press or release is at least 8 ms after the last change of any input, past
+the 5 ms debounce. A download from a board with recording enabled can be dropped in next to them.
+
+Record layout, little-endian, see headers/inputrecorder.h:
+    uint32 timeMicros, uint32 pins (set bit = pin held low), uint16 adc[4]
+"""
+
+import base64
+import json
+import random
+import struct
+
+START_MICROS = 5000000
+POLL_MICROS = 1000
+
+# Pico board defaults, configs/Pico/BoardConfig.h
+UP, DOWN, RIGHT, LEFT, B1 = 2, 3, 4, 5, 6
+# Dual directional on spare pins
+DUAL_UP, DUAL_DOWN, DUAL_LEFT, DUAL_RIGHT = 0, 1, 14, 15
+
+
+def pins(*held):
+    return sum(1 << pin for pin in held)
+
+
+def write(path, steps):
+    """steps is a list of (hold millis, pins held), one record per change."""
+    records = b""
+    count = 0
+    micros = START_MICROS
+    last = None
+    for millis, held in steps:
+        if held != last:
+            records += struct.pack("<II4H", micros & 0xFFFFFFFF, held, 0, 0, 0, 0)
+            count += 1
+            last = held
+        micros += millis * POLL_MICROS
+    # Releases everything so the last hold has an end
+    records += struct.pack("<II4H", micros & 0xFFFFFFFF, 0, 0, 0, 0, 0)
+    count += 1
+    with open(path, "w") as f:
+        json.dump({
+            "valid": 1,
+            "count": count,
+            "recordSize": 16,
+            "records": base64.b64encode(records).decode(),
+        }, f)
+        f.write("\n")
+
+
+def scripted(up, down, left, right):
+    """Overlaps in both orders, simultaneous presses and rolls, each hold long enough to settle."""
+    h = 20
+    return [
+        (h, 0),
+        # Left then right, and back
+        (h, pins(left)), (h, pins(left, right)), (h, pins(right)), (h, 0),
+        (h, pins(right)), (h, pins(right, left)), (h, pins(left)), (h, 0),
+        # First press released first
+        (h, pins(left)), (h, pins(left, right)), (h, pins(right)), (h, pins(right, left)), (h, pins(left)), (h, 0),
+        # Up and down
+        (h, pins(up)), (h, pins(up, down)), (h, pins(down)), (h, 0),
+        (h, pins(down)), (h, pins(down, up)), (h, pins(up)), (h, 0),
+        # Opposing directions landing in the same poll
+        (h, pins(left, right)), (h, pins(left)), (h, pins(left, right)), (h, 0),
+        (h, pins(up, down)), (h, pins(down)), (h, 0),
+        # All four, pressed one at a time and released in another order
+        (h, pins(up)), (h, pins(up, left)), (h, pins(up, left, down)), (h, pins(up, left, down, right)),
+        (h, pins(left, down, right)), (h, pins(down, right)), (h, pins(right)), (h, 0),
+        # Quarter circles both ways
+        (h, pins(down)), (h, pins(down, right)), (h, pins(right)), (h, pins(right, up)), (h, pins(up)),
+        (h, pins(up, left)), (h, pins(left)), (h, pins(left, down)), (h, pins(down)), (h, 0),
+        (h, pins(down)), (h, pins(down, left)), (h, pins(left)), (h, 0),
+        # Diagonal held while the opposite side comes and goes
+        (h, pins(up, left)), (h, pins(up, left, right)), (h, pins(up, right)), (h, pins(up, right, left)),
+        (h, pins(up, left)), (h, 0),
+    ]
+
+
+def random_walk(inputs, seed, changes):
+    """Toggles one input at a time, 8 to 30 ms apart."""
+    rng = random.Random(seed)
+    held = 0
+    steps = [(20, 0)]
+    for _ in range(changes):
+        held ^= 1 << rng.choice(inputs)
+        steps.append((rng.randint(8, 30), held))
+    steps.append((20, 0))
+    return steps
+
+
+def main():
+    dpad = [UP, DOWN, LEFT, RIGHT]
+    write("socd_dpad.json",
+          scripted(UP, DOWN, LEFT, RIGHT) + random_walk(dpad + [B1], 1, 400))
+
+    dual = [DUAL_UP, DUAL_DOWN, DUAL_LEFT, DUAL_RIGHT]
+    write("dual_directional.json",
+          scripted(DUAL_UP, DUAL_DOWN, DUAL_LEFT, DUAL_RIGHT) + random_walk(dpad + dual, 2, 600))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,59 @@
+#ifndef GAMEPADFIXTURE_H_
+#define GAMEPADFIXTURE_H_
+
+#include "gamepad.h"
+#include "storagemanager.h"
+
+// Shared setup of the host tests and the benchmark that run a whole Gamepad
+
+// The Pico board's default mapping
+static inline void mapBoardPins(PinMappings & pins) {
+    pins.pinDpadUp = PIN_DPAD_UP;
+    pins.pinDpadDown = PIN_DPAD_DOWN;
+    pins.pinDpadLeft = PIN_DPAD_LEFT;
+    pins.pinDpadRight = PIN_DPAD_RIGHT;
+    pins.pinButtonB1 = PIN_BUTTON_B1;
+    pins.pinButtonB2 = PIN_BUTTON_B2;
+    pins.pinButtonB3 = PIN_BUTTON_B3;
+    pins.pinButtonB4 = PIN_BUTTON_B4;
+    pins.pinButtonL1 = PIN_BUTTON_L1;
+    pins.pinButtonR1 = PIN_BUTTON_R1;
+    pins.pinButtonL2 = PIN_BUTTON_L2;
+    pins.pinButtonR2 = PIN_BUTTON_R2;
+    pins.pinButtonS1 = PIN_BUTTON_S1;
+    pins.pinButtonS2 = PIN_BUTTON_S2;
+    pins.pinButtonL3 = PIN_BUTTON_L3;
+    pins.pinButtonR3 = PIN_BUTTON_R3;
+    pins.pinButtonA1 = PIN_BUTTON_A1;
+    pins.pinButtonA2 = PIN_BUTTON_A2;
+    pins.pinButtonFn = PIN_BUTTON_FN;
+}
+
+// Gamepad::read() before the pin lookup table, one test per mapping. values is the inverted GPIO word
+static inline void readPinsPerMapping(const Gamepad & gamepad, uint32_t values, GamepadState & state) {
+    state.dpad = 0
+        | ((values & gamepad.mapDpadUp->pinMask)    ? gamepad.mapDpadUp->buttonMask : 0)
+        | ((values & gamepad.mapDpadDown->pinMask)  ? gamepad.mapDpadDown->buttonMask : 0)
+        | ((values & gamepad.mapDpadLeft->pinMask)  ? gamepad.mapDpadLeft->buttonMask  : 0)
+        | ((values & gamepad.mapDpadRight->pinMask) ? gamepad.mapDpadRight->buttonMask : 0)
+    ;
+
+    state.buttons = 0
+        | ((values & gamepad.mapButtonB1->pinMask)  ? gamepad.mapButtonB1->buttonMask  : 0)
+        | ((values & gamepad.mapButtonB2->pinMask)  ? gamepad.mapButtonB2->buttonMask  : 0)
+        | ((values & gamepad.mapButtonB3->pinMask)  ? gamepad.mapButtonB3->buttonMask  : 0)
+        | ((values & gamepad.mapButtonB4->pinMask)  ? gamepad.mapButtonB4->buttonMask  : 0)
+        | ((values & gamepad.mapButtonL1->pinMask)  ? gamepad.mapButtonL1->buttonMask  : 0)
+        | ((values & gamepad.mapButtonR1->pinMask)  ? gamepad.mapButtonR1->buttonMask  : 0)
+        | ((values & gamepad.mapButtonL2->pinMask)  ? gamepad.mapButtonL2->buttonMask  : 0)
+        | ((values & gamepad.mapButtonR2->pinMask)  ? gamepad.mapButtonR2->buttonMask  : 0)
+        | ((values & gamepad.mapButtonS1->pinMask)  ? gamepad.mapButtonS1->buttonMask  : 0)
+        | ((values & gamepad.mapButtonS2->pinMask)  ? gamepad.mapButtonS2->buttonMask  : 0)
+        | ((values & gamepad.mapButtonL3->pinMask)  ? gamepad.mapButtonL3->buttonMask  : 0)
+        | ((values & gamepad.mapButtonR3->pinMask)  ? gamepad.mapButtonR3->buttonMask  : 0)
+        | ((values & gamepad.mapButtonA1->pinMask)  ? gamepad.mapButtonA1->buttonMask  : 0)
+        | ((values & gamepad.mapButtonA2->pinMask)  ? gamepad.mapButtonA2->buttonMask  : 0)
+    ;
+}
+
+#endif
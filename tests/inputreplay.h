@@ -0,0 +1,139 @@
+#ifndef INPUTREPLAY_H_
+#define INPUTREPLAY_H_
+
+#include "hoststub.h"
+#include "gamepad.h"
+#include "gpaddon.h"
+#include "inputrecorder.h"
+
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Plays an input recording back through the core0 input path of GP2040::run()
+
+// Poll interval for the stretches a recording leaves out because the input did not change
+#define INPUT_REPLAY_POLL_MICROS 1000
+
+typedef std::vector<InputRecorder::Record> InputRecords;
+
+static inline bool decodeBase64(const std::string & text, std::string & data) {
+    static const std::string alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    uint32_t bits = 0;
+    int bitCount = 0;
+    data.clear();
+    for (char c : text) {
+        if (c == '=') {
+            break;
+        }
+        const size_t value = alphabet.find(c);
+        if (value == std::string::npos) {
+            return false;
+        }
+        bits = (bits << 6) | value;
+        bitCount += 6;
+        if (bitCount >= 8) {
+            bitCount -= 8;
+            data.push_back(static_cast<char>((bits >> bitCount) & 0xFF));
+        }
+    }
+    return true;
+}
+
+// Finds the value of a top level key in the flat JSON object /api/getInputRecording returns
+static inline std::string jsonValue(const std::string & json, const char * key) {
+    const std::string quoted = std::string("\"") + key + "\"";
+    size_t pos = json.find(quoted);
+    if (pos == std::string::npos || (pos = json.find(':', pos + quoted.size())) == std::string::npos) {
+        return std::string();
+    }
+    pos = json.find_first_not_of(" \t\r\n", pos + 1);
+    if (pos == std::string::npos) {
+        return std::string();
+    }
+    if (json[pos] == '"') {
+        const size_t end = json.find('"', pos + 1);
+        return end == std::string::npos ? std::string() : json.substr(pos + 1, end - pos - 1);
+    }
+    return json.substr(pos, json.find_first_of(",} \t\r\n", pos) - pos);
+}
+
+// Reads a saved download of /api/getInputRecording. Fails on recordings from firmware with
+// another Record layout
+static inline bool loadInputRecording(const char * path, InputRecords & records) {
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+    std::stringstream contents;
+    contents << file.rdbuf();
+    const std::string json = contents.str();
+
+    std::string data;
+    if (jsonValue(json, "valid") != "1" ||
+        jsonValue(json, "recordSize") != std::to_string(sizeof(InputRecorder::Record)) ||
+        !decodeBase64(jsonValue(json, "records"), data) ||
+        data.empty() || data.size() % sizeof(InputRecorder::Record) != 0) {
+        return false;
+    }
+
+    records.resize(data.size() / sizeof(InputRecorder::Record));
+    memcpy(records.data(), data.data(), data.size());
+    return true;
+}
+
+// Runs every recorded poll, and INPUT_REPLAY_POLL_MICROS apart in between, with the pins and ADC
+// readings of the last record before it. afterPoll sees the state as it would go into the report
+class InputReplay {
+public:
+    typedef std::function<void(const InputRecorder::Record &)> PollCallback;
+
+    InputReplay(Gamepad & gamepad, const std::vector<GPAddon *> & addons) : gamepad(gamepad), addons(addons) {}
+
+    void run(const InputRecords & records, const PollCallback & afterPoll) {
+        if (records.empty()) {
+            return;
+        }
+        // Records keep the lower 32 bits of the timer, the differences survive a wrap
+        uint64_t nowMicros = records.front().timeMicros;
+        for (size_t i = 0; i < records.size(); i++) {
+            const InputRecorder::Record & record = records[i];
+            const uint64_t endMicros = (i + 1 < records.size()) ?
+                nowMicros + static_cast<uint32_t>(records[i + 1].timeMicros - record.timeMicros) :
+                nowMicros + INPUT_REPLAY_POLL_MICROS;
+            for (; nowMicros < endMicros; nowMicros += INPUT_REPLAY_POLL_MICROS) {
+                poll(record, nowMicros);
+                afterPoll(record);
+            }
+            nowMicros = endMicros;
+        }
+    }
+
+    void poll(const InputRecorder::Record & record, uint64_t nowMicros) {
+        HostStub::setTime(nowMicros);
+        HostStub::setGpio(~record.pins);
+        for (uint8_t channel = 0; channel < ADC_SAMPLER_CHANNELS; channel++) {
+            HostStub::setAdc(channel, record.adc[channel]);
+        }
+
+        gamepad.read();
+        gamepad.debounce();
+        gamepad.hotkey();
+        for (GPAddon * addon : addons) {
+            addon->preprocess();
+        }
+        gamepad.process();
+        for (GPAddon * addon : addons) {
+            addon->process();
+        }
+    }
+
+private:
+    Gamepad & gamepad;
+    std::vector<GPAddon *> addons;
+};
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef MOCKI2CBUS_H_
+#define MOCKI2CBUS_H_
+
+#include "hoststub.h"
+#include "testing.h"
+
+#include "I2CBus.h"
+#include "I2CQueue.h"
+
+#include <atomic>
+#include <vector>
+
+// Fake clock step per poll of a busy bus, a bus that never settles runs into the queue's deadline
+#define MOCK_I2C_POLL_MICROS 10
+#define MOCK_I2C_STUCK 0xFFFF
+
+// Records what I2CQueue does to the block and lets the test raise its interrupts
+class MockI2CBus : public I2CBus {
+public:
+    struct Transfer
+    {
+        uint8_t address;
+        std::vector<uint16_t> commands;
+        uint8_t * readData;
+        uint16_t readLength;
+    };
+
+    virtual bool claim() { claimed = true; return true; }
+    virtual void setAddress(uint8_t value) { address = value; }
+
+    // Fails the test if the queue starts a transfer while another is still on the bus
+    virtual void startTransfer(const uint16_t * commands, uint16_t count, uint8_t * readData, uint16_t readLength) {
+        CHECK(!inFlight.exchange(true));
+        transfers.push_back({ address, std::vector<uint16_t>(commands, commands + count), readData, readLength });
+        started.store(true, std::memory_order_release);
+    }
+    virtual void abortTransfer() { aborts++; }
+
+    virtual uint32_t interruptStatus() { return status; }
+    virtual void clearStop() { status &= ~I2C_BUS_INTERRUPT_STOP; stopClears++; }
+    virtual void clearAbort() { status &= ~I2C_BUS_INTERRUPT_ABORT; abortClears++; }
+
+    virtual bool isActive() { return poll(activePolls); }
+    virtual bool isReceiving() { return poll(receivingPolls); }
+    virtual void flushReceive() { flushes++; }
+
+    // The transfer on the bus ends with the given interrupt and the queue handles it
+    void raise(I2CQueue & queue, uint32_t interrupt) {
+        CHECK(started.exchange(false, std::memory_order_acquire));
+        inFlight = false;
+        status = interrupt;
+        queue.handleIRQ();
+    }
+
+    bool claimed = false;
+    uint8_t address = 0;
+    std::vector<Transfer> transfers;
+    std::atomic<bool> inFlight { false };
+    std::atomic<bool> started { false };
+    uint32_t status = 0;
+    uint32_t aborts = 0;
+    uint32_t stopClears = 0;
+    uint32_t abortClears = 0;
+    uint32_t flushes = 0;
+    uint32_t activePolls = 0;       // Polls that still find the bus or the receive DMA busy, MOCK_I2C_STUCK never settles
+    uint32_t receivingPolls = 0;
+
+private:
+    static bool poll(uint32_t & polls) {
+        if (polls == 0) {
+            return false;
+        }
+        if (polls != MOCK_I2C_STUCK) {
+            polls--;
+        }
+        HostStub::advanceTime(MOCK_I2C_POLL_MICROS);
+        return true;
+    }
+};
+
+#endif
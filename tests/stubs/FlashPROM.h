@@ -0,0 +1,6 @@
+#ifndef FLASHPROM_H_
+#define FLASHPROM_H_
+
+// Persistence is Storage's job on the host, see storagemanager.h in this directory
+
+#endif
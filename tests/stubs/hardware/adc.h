@@ -0,0 +1,12 @@
+#ifndef _HARDWARE_ADC_H
+#define _HARDWARE_ADC_H
+
+#include "pico/platform.h"
+
+void adc_select_input(uint input);
+uint16_t adc_read(void);
+
+static inline void adc_init(void) { }
+static inline void adc_gpio_init(uint gpio) { (void)gpio; }
+
+#endif
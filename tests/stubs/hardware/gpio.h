@@ -0,0 +1,28 @@
+#ifndef _HARDWARE_GPIO_H
+#define _HARDWARE_GPIO_H
+
+#include "pico/platform.h"
+
+#define GPIO_IN false
+#define GPIO_OUT true
+
+enum gpio_function {
+    GPIO_FUNC_SIO = 5,
+    GPIO_FUNC_PIO0 = 6,
+    GPIO_FUNC_PIO1 = 7,
+    GPIO_FUNC_NULL = 0x1f,
+};
+
+uint32_t gpio_get_all(void);
+void gpio_put(uint gpio, bool value);
+
+static inline bool gpio_get(uint gpio) { return (gpio_get_all() >> gpio) & 1; }
+static inline void gpio_init(uint gpio) { (void)gpio; }
+static inline void gpio_init_mask(uint32_t mask) { (void)mask; }
+static inline void gpio_set_dir(uint gpio, bool out) { (void)gpio; (void)out; }
+static inline void gpio_pull_up(uint gpio) { (void)gpio; }
+static inline void gpio_pull_down(uint gpio) { (void)gpio; }
+static inline void gpio_disable_pulls(uint gpio) { (void)gpio; }
+static inline void gpio_set_function(uint gpio, enum gpio_function fn) { (void)gpio; (void)fn; }
+
+#endif
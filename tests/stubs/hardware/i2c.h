@@ -0,0 +1,18 @@
+#ifndef _HARDWARE_I2C_H
+#define _HARDWARE_I2C_H
+
+#include "pico/platform.h"
+#include "pico/error.h"
+
+// Handles and i2c_init() only, I2CQueue reaches the registers through an I2CBus
+typedef struct i2c_inst { uint index; } i2c_inst_t;
+
+extern i2c_inst_t i2c0_inst;
+extern i2c_inst_t i2c1_inst;
+#define i2c0 (&i2c0_inst)
+#define i2c1 (&i2c1_inst)
+
+// Counts the resets per block, see HostStub::getI2CInitCount()
+uint i2c_init(i2c_inst_t * i2c, uint baudrate);
+
+#endif
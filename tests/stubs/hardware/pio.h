@@ -0,0 +1,18 @@
+#ifndef _HARDWARE_PIO_H
+#define _HARDWARE_PIO_H
+
+#include "pico/platform.h"
+
+// Only the types the headers name, nothing on the host drives a state machine
+#define PIO_INSTRUCTION_COUNT 32
+
+typedef struct pio_hw pio_hw_t;
+typedef pio_hw_t * PIO;
+
+typedef struct pio_program {
+    const uint16_t * instructions;
+    uint8_t length;
+    int8_t origin;
+} pio_program_t;
+
+#endif
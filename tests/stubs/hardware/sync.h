@@ -0,0 +1,42 @@
+#ifndef _HARDWARE_SYNC_H
+#define _HARDWARE_SYNC_H
+
+#include <atomic>
+
+#include "pico/platform.h"
+
+// A full fence, the same ordering the dmb gives between the two cores
+static inline void __dmb(void) { std::atomic_thread_fence(std::memory_order_seq_cst); }
+
+static inline void __compiler_memory_barrier(void) { std::atomic_signal_fence(std::memory_order_seq_cst); }
+
+static inline uint32_t save_and_disable_interrupts(void) { return 0; }
+static inline void restore_interrupts(uint32_t status) { (void)status; }
+
+// Hardware spinlocks as real spinlocks, so tests can hammer them from several threads
+#define NUM_SPIN_LOCKS 32
+
+typedef std::atomic_flag spin_lock_t;
+
+static inline spin_lock_t * spin_lock_instance(uint lock_num) {
+    static spin_lock_t locks[NUM_SPIN_LOCKS];
+    return &locks[lock_num % NUM_SPIN_LOCKS];
+}
+
+static inline int spin_lock_claim_unused(bool required) {
+    static std::atomic<int> claimed(0);
+    (void)required;
+    return claimed++ % NUM_SPIN_LOCKS;
+}
+
+static inline uint32_t spin_lock_blocking(spin_lock_t * lock) {
+    while (lock->test_and_set(std::memory_order_acquire)) { }
+    return 0;
+}
+
+static inline void spin_unlock(spin_lock_t * lock, uint32_t saved_irq) {
+    (void)saved_irq;
+    lock->clear(std::memory_order_release);
+}
+
+#endif
@@ -0,0 +1,16 @@
+#ifndef _HELPER_H_
+#define _HELPER_H_
+
+#include "pico/time.h"
+#include <string>
+
+#include "BoardConfig.h"
+#include <stdint.h>
+
+// Host stand-in for headers/helper.h, without the LED and USB driver headers
+
+#define GP2040VERSION "host"
+
+static inline bool isValidPin(int32_t pin) { return pin >= 0 && pin < NUM_BANK0_GPIOS; }
+
+#endif
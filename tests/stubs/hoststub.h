@@ -0,0 +1,34 @@
+#ifndef HOSTSTUB_H_
+#define HOSTSTUB_H_
+
+#include <stdint.h>
+
+#include "config.pb.h"
+
+// Knobs for the pico-sdk stand-ins, tests drive the clock and the pins explicitly
+namespace HostStub {
+    void setTime(uint64_t micros);
+    void advanceTime(uint64_t micros);
+
+    // Raw GPIO levels as gpio_get_all() returns them, buttons are active low
+    void setGpio(uint32_t levels);
+    // Holds an ADC input at one reading, every sample the free-running sampler kept included
+    void setAdc(uint8_t channel, uint16_t value);
+    // One more conversion of an input in the free-running sampler, AdcSampler::read(channel, samples)
+    // averages the newest ones
+    void pushAdcSample(uint8_t channel, uint16_t value);
+
+    // Number of Storage::save() calls since the last reset
+    uint32_t getSaveCount();
+
+    // Saves handed to Storage::enqueue*Save() since the last reset, and the last options of each kind
+    uint32_t getEnqueuedSaveCount();
+    const TurboOptions & getEnqueuedTurboOptions();
+    const AnalogOptions & getEnqueuedAnalogOptions();
+
+    // Number of i2c_init() resets of a block since the last reset
+    uint32_t getI2CInitCount(uint8_t block);
+    void reset();
+}
+
+#endif
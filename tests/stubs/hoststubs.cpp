@@ -0,0 +1,120 @@
+#include "hoststub.h"
+
+#include "hardware/adc.h"
+#include "hardware/gpio.h"
+#include "hardware/i2c.h"
+#include "pico/time.h"
+
+#include "adcsampler.h"
+#include "framesync.h"
+#include "gamepad/GpioSampler.h"
+#include "storagemanager.h"
+
+#include <algorithm>
+#include <cstring>
+
+static uint64_t nowMicros = 0;
+static uint32_t gpioLevels = 0xFFFFFFFF;
+static uint32_t gpioOutputs = 0;
+// Newest sample of each input first
+static uint16_t adcSamples[ADC_SAMPLER_CHANNELS][ADC_SAMPLER_DEPTH] = { };
+static uint8_t adcInput = 0;
+static uint8_t adcChannelMask = 0;
+static uint32_t saveCount = 0;
+static uint32_t enqueuedSaveCount = 0;
+static TurboOptions enqueuedTurboOptions = TurboOptions_init_zero;
+static AnalogOptions enqueuedAnalogOptions = AnalogOptions_init_zero;
+static uint32_t i2cInitCounts[2] = { };
+
+void HostStub::setTime(uint64_t micros) { nowMicros = micros; }
+void HostStub::advanceTime(uint64_t micros) { nowMicros += micros; }
+void HostStub::setGpio(uint32_t levels) { gpioLevels = levels; }
+void HostStub::setAdc(uint8_t channel, uint16_t value) {
+    for (uint16_t & sample : adcSamples[channel % ADC_SAMPLER_CHANNELS]) sample = value;
+}
+void HostStub::pushAdcSample(uint8_t channel, uint16_t value) {
+    uint16_t * samples = adcSamples[channel % ADC_SAMPLER_CHANNELS];
+    memmove(samples + 1, samples, (ADC_SAMPLER_DEPTH - 1) * sizeof(uint16_t));
+    samples[0] = value;
+}
+uint32_t HostStub::getSaveCount() { return saveCount; }
+uint32_t HostStub::getEnqueuedSaveCount() { return enqueuedSaveCount; }
+const TurboOptions & HostStub::getEnqueuedTurboOptions() { return enqueuedTurboOptions; }
+const AnalogOptions & HostStub::getEnqueuedAnalogOptions() { return enqueuedAnalogOptions; }
+uint32_t HostStub::getI2CInitCount(uint8_t block) { return i2cInitCounts[block % 2]; }
+
+void HostStub::reset() {
+    nowMicros = 0;
+    gpioLevels = 0xFFFFFFFF;
+    gpioOutputs = 0;
+    memset(adcSamples, 0, sizeof(adcSamples));
+    adcChannelMask = 0;
+    saveCount = 0;
+    enqueuedSaveCount = 0;
+    enqueuedTurboOptions = TurboOptions_init_zero;
+    enqueuedAnalogOptions = AnalogOptions_init_zero;
+    i2cInitCounts[0] = i2cInitCounts[1] = 0;
+    Storage::getInstance().reset();
+}
+
+uint64_t time_us_64(void) { return nowMicros; }
+void sleep_us(uint64_t us) { nowMicros += us; }
+void sleep_ms(uint32_t ms) { nowMicros += ms * 1000ULL; }
+void busy_wait_us(uint64_t us) { nowMicros += us; }
+
+i2c_inst_t i2c0_inst = { 0 };
+i2c_inst_t i2c1_inst = { 1 };
+uint i2c_init(i2c_inst_t * i2c, uint baudrate) { i2cInitCounts[i2c->index % 2]++; return baudrate; }
+
+uint32_t gpio_get_all(void) { return gpioLevels; }
+void gpio_put(uint gpio, bool value) { gpioOutputs = value ? (gpioOutputs | (1U << gpio)) : (gpioOutputs & ~(1U << gpio)); }
+
+void adc_select_input(uint input) { adcInput = input % ADC_SAMPLER_CHANNELS; }
+uint16_t adc_read(void) { return adcSamples[adcInput][0]; }
+
+// Never active, the callers take their blocking fallback
+void AdcSampler::enableChannel(uint8_t channel) { adcChannelMask |= 1 << (channel % ADC_SAMPLER_CHANNELS); }
+void AdcSampler::setup(bool enabled, uint32_t averageSamples) { (void)enabled; (void)averageSamples; }
+bool AdcSampler::isActive() { return false; }
+uint8_t AdcSampler::getChannelMask() { return adcChannelMask; }
+uint16_t AdcSampler::read(uint8_t channel) { return read(channel, 1); }
+uint16_t AdcSampler::read(uint8_t channel, uint32_t samples) {
+    samples = std::clamp<uint32_t>(samples, 1, ADC_SAMPLER_DEPTH / 2);
+    uint32_t sum = 0;
+    for (uint32_t i = 0; i < samples; i++) {
+        sum += adcSamples[channel % ADC_SAMPLER_CHANNELS][i];
+    }
+    return sum / samples;
+}
+
+// No state machine on the host, Gamepad reads the pins directly
+bool GpioSampler::setup(uint32_t mask) { (void)mask; return false; }
+uint32_t GpioSampler::capture() { return gpio_get_all(); }
+bool GpioSampler::nextEdge(GpioSamplerEdge & edge) { (void)edge; return false; }
+void GpioSampler::skipEdges() { }
+
+// No USB on the host, polls are never scheduled against start-of-frame
+bool FrameSync::locked() { return false; }
+
+bool Storage::save() {
+    saveCount++;
+    return true;
+}
+
+void Storage::enqueueTurboOptionsSave(const TurboOptions& turboOptions) {
+    enqueuedTurboOptions = turboOptions;
+    enqueuedSaveCount++;
+}
+
+void Storage::enqueueAnalogOptionsSave(const AnalogOptions& analogOptions) {
+    enqueuedAnalogOptions = analogOptions;
+    enqueuedSaveCount++;
+}
+
+void Storage::reset() {
+    config = Config_init_zero;
+    configMode = false;
+    analogCalibrationMode = false;
+    gamepad = nullptr;
+    processedGamepad = nullptr;
+}
@@ -0,0 +1,14 @@
+#ifndef _PICO_CRITICAL_SECTION_H
+#define _PICO_CRITICAL_SECTION_H
+
+#include <mutex>
+
+typedef struct {
+    std::mutex * lock;
+} critical_section_t;
+
+static inline void critical_section_init(critical_section_t * cs) { cs->lock = new std::mutex(); }
+static inline void critical_section_enter_blocking(critical_section_t * cs) { cs->lock->lock(); }
+static inline void critical_section_exit(critical_section_t * cs) { cs->lock->unlock(); }
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef _PICO_PLATFORM_H
+#define _PICO_PLATFORM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/types.h>
+
+#define NUM_BANK0_GPIOS 30
+#define NUM_CORES 2
+
+#define __not_in_flash_func(name) name
+#define __time_critical_func(name) name
+#define __uninitialized_ram(name) name
+#define __force_inline inline __attribute__((always_inline))
+
+static inline uint get_core_num(void) { return 0; }
+static inline void tight_loop_contents(void) { }
+
+#endif
@@ -0,0 +1,8 @@
+#ifndef _PICO_STDLIB_H
+#define _PICO_STDLIB_H
+
+#include "pico/platform.h"
+#include "pico/time.h"
+#include "hardware/gpio.h"
+
+#endif
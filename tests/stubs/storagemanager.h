@@ -0,0 +1,63 @@
+#ifndef STORAGE_H_
+#define STORAGE_H_
+
+#include <stdint.h>
+
+#include "helper.h"
+#include "gamepad.h"
+
+#include "config.pb.h"
+
+#define SI Storage::getInstance()
+
+// Host stand-in for headers/storagemanager.h, the config lives in RAM and saves are only counted
+class Storage {
+public:
+    Storage(Storage const&) = delete;
+    void operator=(Storage const&)  = delete;
+    static Storage& getInstance()
+    {
+        static Storage instance;
+        return instance;
+    }
+
+    Config& getConfig() { return config; }
+    GamepadOptions& getGamepadOptions() { return config.gamepadOptions; }
+    HotkeyOptions& getHotkeyOptions() { return config.hotkeyOptions; }
+    ForcedSetupOptions& getForcedSetupOptions() { return config.forcedSetupOptions; }
+    PinMappings& getPinMappings() { return config.pinMappings; }
+    KeyboardMapping& getKeyboardMapping() { return config.keyboardMapping; }
+    AddonOptions& getAddonOptions() { return config.addonOptions; }
+
+    bool save();
+
+    // Only recorded, see HostStub::getEnqueuedSaveCount(). The queue itself lives in the firmware's
+    // storagemanager.cpp with the flash and animation code and is not built here
+    void enqueueTurboOptionsSave(const TurboOptions& turboOptions);
+    void enqueueAnalogOptionsSave(const AnalogOptions& analogOptions);
+
+    void SetConfigMode(bool mode) { configMode = mode; }
+    bool GetConfigMode() { return configMode; }
+
+    void SetAnalogCalibrationMode(bool mode) { analogCalibrationMode = mode; }
+    bool GetAnalogCalibrationMode() { return analogCalibrationMode; }
+
+    void SetGamepad(Gamepad * value) { gamepad = value; }
+    Gamepad * GetGamepad() { return gamepad; }
+
+    void SetProcessedGamepad(Gamepad * value) { processedGamepad = value; }
+    Gamepad * GetProcessedGamepad() { return processedGamepad; }
+
+    // Clears the config
+    void reset();
+
+private:
+    Storage() { reset(); }
+    bool configMode = false;
+    bool analogCalibrationMode = false;
+    Gamepad * gamepad = nullptr;
+    Gamepad * processedGamepad = nullptr;
+    Config config;
+};
+
+#endif
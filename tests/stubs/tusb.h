@@ -0,0 +1,59 @@
+#ifndef _TUSB_H_
+#define _TUSB_H_
+
+#include <stdint.h>
+
+// Just enough of TinyUSB for the descriptor headers, the host build never enumerates
+#define CFG_TUD_HID_EP_BUFSIZE 64
+
+#define TUSB_DESC_DEVICE 0x01
+#define HID_ITF_PROTOCOL_KEYBOARD 1
+
+// Modifier usages and their bits in the boot keyboard report
+#define HID_KEY_CONTROL_LEFT  0xE0
+#define HID_KEY_SHIFT_LEFT    0xE1
+#define HID_KEY_ALT_LEFT      0xE2
+#define HID_KEY_GUI_LEFT      0xE3
+#define HID_KEY_CONTROL_RIGHT 0xE4
+#define HID_KEY_SHIFT_RIGHT   0xE5
+#define HID_KEY_ALT_RIGHT     0xE6
+#define HID_KEY_GUI_RIGHT     0xE7
+
+#define KEYBOARD_MODIFIER_LEFTCTRL   (1 << 0)
+#define KEYBOARD_MODIFIER_LEFTSHIFT  (1 << 1)
+#define KEYBOARD_MODIFIER_LEFTALT    (1 << 2)
+#define KEYBOARD_MODIFIER_LEFTGUI    (1 << 3)
+#define KEYBOARD_MODIFIER_RIGHTCTRL  (1 << 4)
+#define KEYBOARD_MODIFIER_RIGHTSHIFT (1 << 5)
+#define KEYBOARD_MODIFIER_RIGHTALT   (1 << 6)
+#define KEYBOARD_MODIFIER_RIGHTGUI   (1 << 7)
+
+typedef struct __attribute__((packed)) {
+    uint8_t bLength;
+    uint8_t bDescriptorType;
+    uint16_t bcdUSB;
+    uint8_t bDeviceClass;
+    uint8_t bDeviceSubClass;
+    uint8_t bDeviceProtocol;
+    uint8_t bMaxPacketSize0;
+    uint16_t idVendor;
+    uint16_t idProduct;
+    uint16_t bcdDevice;
+    uint8_t iManufacturer;
+    uint8_t iProduct;
+    uint8_t iSerialNumber;
+    uint8_t bNumConfigurations;
+} tusb_desc_device_t;
+
+#define TUD_CONFIG_DESC_LEN 9
+#define TUD_HID_DESC_LEN 25
+
+#define TUD_CONFIG_DESCRIPTOR(config_num, _itfcount, _stridx, _total_len, _attribute, _power_ma) \
+    9, 0x02, (uint8_t)(_total_len), (uint8_t)((_total_len) >> 8), _itfcount, config_num, _stridx, (uint8_t)(0x80 | (_attribute)), (uint8_t)((_power_ma) / 2)
+
+#define TUD_HID_DESCRIPTOR(_itfnum, _stridx, _boot_protocol, _report_desc_len, _epin, _epsize, _ep_interval) \
+    9, 0x04, _itfnum, 0, 1, 0x03, (uint8_t)((_boot_protocol) ? 1 : 0), _boot_protocol, _stridx, \
+    9, 0x21, 0x11, 0x01, 0, 1, 0x22, (uint8_t)(_report_desc_len), (uint8_t)((_report_desc_len) >> 8), \
+    7, 0x05, _epin, 0x03, (uint8_t)(_epsize), (uint8_t)((_epsize) >> 8), _ep_interval
+
+#endif
@@ -0,0 +1,237 @@
+#include "testing.h"
+#include "hoststub.h"
+
+#include "addons/analog.h"
+#include "storagemanager.h"
+
+#include <math.h>
+#include <stdlib.h>
+
+// Runs the integer pipeline of AnalogInput against the float one it replaced, over every raw reading
+
+#define ADC_MAX ((1 << 12) - 1)
+#define ANALOG_PIN_X 26
+#define ANALOG_PIN_Y 27
+
+// Largest difference to the float path, in 16-bit output counts
+#define UNCALIBRATED_TOLERANCE 1
+#define CALIBRATED_TOLERANCE 17     // One ADC code
+#define CIRCULARITY_TOLERANCE 3
+
+// The float path as it was, readPin(), map() and adjustCircularity()
+static uint16_t referenceMap(uint16_t x, uint16_t in_min, uint16_t in_max, uint16_t out_min, uint16_t out_max) {
+    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+static float referenceReadPin(uint16_t adc_hold, uint16_t center, bool autoCalibrate, float deadzone) {
+    uint16_t adc_calibrated;
+
+    if (autoCalibrate) {
+        if (adc_hold > center) {
+            adc_calibrated = referenceMap(adc_hold, center, ADC_MAX, ADC_MAX / 2, ADC_MAX);
+        }
+        else if (adc_hold == center) {
+            adc_calibrated = ADC_MAX / 2;
+        }
+        else {
+            adc_calibrated = referenceMap(adc_hold, 0, center, 0, ADC_MAX / 2);
+        }
+    }
+    else {
+        adc_calibrated = adc_hold;
+    }
+
+    float adc_value = ((float)adc_calibrated) / ADC_MAX;
+
+    if (fabsf(adc_value - 0.5f) < deadzone) {
+        adc_value = 0.5f;
+    }
+
+    return adc_value;
+}
+
+static void referenceCircularity(float& x, float& y) {
+    float x_magnitude = x - 0.5f;
+    float y_magnitude = y - 0.5f;
+    float magnitude = sqrtf((x_magnitude * x_magnitude) + (y_magnitude * y_magnitude));
+
+    if (magnitude > 0.5f) {
+        x = ((x_magnitude / magnitude) * 0.5f + 0.5f);
+        y = ((y_magnitude / magnitude) * 0.5f + 0.5f);
+    }
+}
+
+static uint16_t referenceOutput(float value) {
+    return (uint16_t)(65535.0f * value);
+}
+
+struct AnalogFixture
+{
+    Gamepad gamepad;
+    AnalogInput analog;
+
+    // Stick 1 on the left stick, centerX and centerY are what the ADC reads at setup
+    void setup(bool autoCalibrate, uint32_t deadzone, bool circularity, InvertMode invert = INVERT_NONE,
+            uint16_t centerX = ADC_MAX / 2, uint16_t centerY = ADC_MAX / 2) {
+        HostStub::reset();
+        Storage & storage = Storage::getInstance();
+        storage.SetGamepad(&gamepad);
+
+        AnalogOptions & options = storage.getAddonOptions().analogOptions;
+        options.enabled = true;
+        options.analogAdc1PinX = ANALOG_PIN_X;
+        options.analogAdc1PinY = ANALOG_PIN_Y;
+        options.analogAdc2PinX = -1;
+        options.analogAdc2PinY = -1;
+        options.analogAdc1Mode = DPAD_MODE_LEFT_ANALOG;
+        options.analogAdc2Mode = DPAD_MODE_DIGITAL;
+        options.analogAdc1Invert = invert;
+        options.auto_calibrate = autoCalibrate;
+        options.analog_deadzone = deadzone;
+        options.forced_circularity = circularity;
+        options.analogAdc1Filter = ANALOG_FILTER_NONE;
+
+        HostStub::setAdc(ANALOG_PIN_X - 26, centerX);
+        HostStub::setAdc(ANALOG_PIN_Y - 26, centerY);
+        analog.setup();
+    }
+
+    void sample(uint16_t rawX, uint16_t rawY) {
+        HostStub::setAdc(ANALOG_PIN_X - 26, rawX);
+        HostStub::setAdc(ANALOG_PIN_Y - 26, rawY);
+        HostStub::advanceTime(1000);
+        analog.process();
+    }
+};
+
+static AnalogFixture fixture;
+
+static void testUncalibratedWithinOneCount() {
+    for (InvertMode invert : { INVERT_NONE, INVERT_XY }) {
+        fixture.setup(false, 0, false, invert);
+        int32_t worst = 0;
+        for (uint16_t raw = 0; raw <= ADC_MAX; raw++) {
+            fixture.sample(raw, ADC_MAX - raw);
+            float x = referenceReadPin(raw, 0, false, 0);
+            float y = referenceReadPin(ADC_MAX - raw, 0, false, 0);
+            if (invert == INVERT_XY) {
+                x = 1.0f - x;
+                y = 1.0f - y;
+            }
+            worst = std::max(worst, abs(fixture.gamepad.state.lx - referenceOutput(x)));
+            worst = std::max(worst, abs(fixture.gamepad.state.ly - referenceOutput(y)));
+        }
+        printf("invert %d: %d counts\n", invert, worst);
+        CHECK(worst <= UNCALIBRATED_TOLERANCE);
+    }
+}
+
+static void testAxialDeadzone() {
+    const uint32_t deadzone = 5;
+    fixture.setup(false, deadzone, false);
+    int32_t worst = 0;
+    for (uint16_t raw = 0; raw <= ADC_MAX; raw++) {
+        fixture.sample(raw, raw);
+        worst = std::max(worst, abs(fixture.gamepad.state.lx - referenceOutput(referenceReadPin(raw, 0, false, deadzone / 200.0f))));
+        CHECK_EQ(fixture.gamepad.state.lx, fixture.gamepad.state.ly);
+    }
+    printf("%d counts\n", worst);
+    CHECK(worst <= UNCALIBRATED_TOLERANCE);
+}
+
+// No float counterpart, the deadzone is a circle of the same radius as the axial one
+static void testRadialDeadzone() {
+    const uint32_t deadzone = 10;
+    fixture.setup(false, deadzone, false);
+    Storage::getInstance().getAddonOptions().analogOptions.radial_deadzone = true;
+    fixture.analog.setup();
+
+    const float radius = deadzone / 200.0f;
+    for (uint16_t rawX = 0; rawX <= ADC_MAX; rawX += 7) {
+        for (uint16_t rawY = 0; rawY <= ADC_MAX; rawY += 7) {
+            fixture.sample(rawX, rawY);
+            const float dx = fixture.gamepad.state.lx / 65535.0f - 0.5f;
+            const float dy = fixture.gamepad.state.ly / 65535.0f - 0.5f;
+            const float x = static_cast<float>(rawX) / ADC_MAX - 0.5f;
+            const float y = static_cast<float>(rawY) / ADC_MAX - 0.5f;
+            const float distance = sqrtf(x * x + y * y);
+            if (distance < radius - 1.0f / ADC_MAX) {
+                CHECK_EQ(fixture.gamepad.state.lx, GAMEPAD_JOYSTICK_MID);
+                CHECK_EQ(fixture.gamepad.state.ly, GAMEPAD_JOYSTICK_MID);
+            } else if (distance > radius + 1.0f / ADC_MAX) {
+                CHECK(fabsf(dx - x) < 2.0f / ADC_MAX && fabsf(dy - y) < 2.0f / ADC_MAX);
+            }
+        }
+    }
+}
+
+static void testCalibratedWithinOneCode() {
+    int32_t worst = 0;
+    for (uint16_t center = 1; center < ADC_MAX; center++) {
+        fixture.setup(true, 0, false, INVERT_NONE, center, ADC_MAX - center);
+        for (uint16_t raw = 0; raw <= ADC_MAX; raw++) {
+            fixture.sample(raw, raw);
+            worst = std::max(worst, abs(fixture.gamepad.state.lx - referenceOutput(referenceReadPin(raw, center, true, 0))));
+            worst = std::max(worst, abs(fixture.gamepad.state.ly - referenceOutput(referenceReadPin(raw, ADC_MAX - center, true, 0))));
+        }
+    }
+    printf("%d counts\n", worst);
+    CHECK(worst <= CALIBRATED_TOLERANCE);
+}
+
+static void testCircularityWithinThreeCounts() {
+    fixture.setup(false, 0, true);
+    int32_t worst = 0;
+    for (uint16_t rawX = 0; rawX <= ADC_MAX; rawX++) {
+        for (uint16_t rawY = 0; rawY <= ADC_MAX; rawY++) {
+            fixture.sample(rawX, rawY);
+            float x = referenceReadPin(rawX, 0, false, 0);
+            float y = referenceReadPin(rawY, 0, false, 0);
+            referenceCircularity(x, y);
+            worst = std::max(worst, abs(fixture.gamepad.state.lx - referenceOutput(x)));
+            worst = std::max(worst, abs(fixture.gamepad.state.ly - referenceOutput(y)));
+        }
+    }
+    printf("%d counts\n", worst);
+    CHECK(worst <= CIRCULARITY_TOLERANCE);
+}
+
+// The calibration hotkey ends inside a poll, the add-on hands the flash write to the main loop's
+// queue instead of saving. The queue itself is not built on the host
+static void testCalibrationSaveIsQueued() {
+    fixture.setup(false, 0, false);
+    Storage & storage = Storage::getInstance();
+
+    storage.SetAnalogCalibrationMode(true);
+    fixture.sample(2000, 2100);
+    fixture.sample(0, 0);
+    fixture.sample(ADC_MAX, ADC_MAX);
+    storage.SetAnalogCalibrationMode(false);
+    fixture.sample(2000, 2100);
+    CHECK_EQ(HostStub::getSaveCount(), 0);
+    CHECK_EQ(HostStub::getEnqueuedSaveCount(), 1);
+
+    const AnalogOptions & options = HostStub::getEnqueuedAnalogOptions();
+    CHECK_EQ(options.adc1XCalibration.min, 0);
+    CHECK_EQ(options.adc1XCalibration.center, 2000);
+    CHECK_EQ(options.adc1XCalibration.max, ADC_MAX);
+    CHECK_EQ(options.adc1YCalibration.center, 2100);
+
+    // Calibrated, the recorded center is the middle of the output
+    fixture.sample(2000, 2100);
+    CHECK(abs(fixture.gamepad.state.lx - GAMEPAD_JOYSTICK_MID) <= CALIBRATED_TOLERANCE);
+    CHECK(abs(fixture.gamepad.state.ly - GAMEPAD_JOYSTICK_MID) <= CALIBRATED_TOLERANCE);
+
+    CHECK_EQ(HostStub::getSaveCount(), 0);
+    CHECK_EQ(HostStub::getEnqueuedSaveCount(), 1);
+}
+
+int main() {
+    RUN_TEST(testUncalibratedWithinOneCount);
+    RUN_TEST(testAxialDeadzone);
+    RUN_TEST(testRadialDeadzone);
+    RUN_TEST(testCalibratedWithinOneCode);
+    RUN_TEST(testCircularityWithinThreeCounts);
+    RUN_TEST(testCalibrationSaveIsQueued);
+    return 0;
+}
@@ -0,0 +1,338 @@
+#include "testing.h"
+#include "hoststub.h"
+
+#include "addons/analog.h"
+#include "adcsampler.h"
+#include "storagemanager.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+// Replays data/adc_trace.csv through the integer EMA and one-euro filters of AnalogInput and
+// compares every output with a double precision version of the same filter, and through the
+// oversampling filter with the trace's noise on every conversion of the free-running sampler.
+//
+// adc_trace.csv is modelled, no board capture has been taken yet. One goes in data/adc_capture.csv
+// in the same format, a micros,x,y line per poll with the raw 12-bit readings of GPIO 26 and 27,
+// polls about 1 ms apart, starting with at least a second of the stick at rest. It is replayed
+// in place of the modelled trace when present
+
+#define ANALOG_PIN_X 26
+#define ANALOG_PIN_Y 27
+
+#define FILTER_EMA_ALPHA 25     // Percent
+#define FILTER_MIN_CUTOFF 50    // Tenths of a Hz
+#define FILTER_BETA 5000        // mHz per full throw per second
+
+// 0.1% of the 16-bit range
+#define FILTER_TOLERANCE 66
+
+// Rest at the start of the trace, after the filters settled
+#define REST_START_MICROS 200000
+#define REST_END_MICROS 1000000
+
+// Conversions of each of the two inputs the free-running sampler makes between 1 ms polls
+#define OVERSAMPLE_CONVERSIONS (ADC_SAMPLER_SAMPLE_HZ / 2 / 1000)
+
+struct TraceSample
+{
+    uint32_t micros;
+    uint16_t x;
+    uint16_t y;
+};
+
+static std::vector<TraceSample> loadTrace(const char * path) {
+    std::vector<TraceSample> trace;
+    FILE * file = fopen(path, "r");
+    if (file == nullptr) {
+        return trace;
+    }
+
+    char line[64];
+    while (fgets(line, sizeof(line), file) != nullptr) {
+        TraceSample sample;
+        unsigned int micros, x, y;
+        if (sscanf(line, "%u,%u,%u", &micros, &x, &y) == 3) {
+            sample.micros = micros;
+            sample.x = x;
+            sample.y = y;
+            trace.push_back(sample);
+        }
+    }
+    fclose(file);
+    return trace;
+}
+
+static uint16_t toAnalog(uint16_t value) {
+    return (value << 4) | (value >> 8);
+}
+
+// Same filters in double precision, on the same 16-bit input and the same clamped step
+class ReferenceFilter
+{
+public:
+    ReferenceFilter(AnalogFilter filter) : filter(filter) { }
+
+    double apply(uint16_t value, uint32_t elapsedMicros) {
+        if (!primed) {
+            filtered = value;
+            speed = 0;
+            primed = true;
+            return filtered;
+        }
+
+        const double dt = elapsedMicros / 1e6;
+        if (filter == ANALOG_FILTER_EMA) {
+            filtered += (value - filtered) * FILTER_EMA_ALPHA / 100.0;
+        } else {
+            const double rate = (value - filtered) / 65535.0 / dt;     // Full throws per second
+            speed += (rate - speed) * smoothing(1.0, dt);
+            const double cutoff = std::min(FILTER_MIN_CUTOFF / 10.0 + FILTER_BETA / 1000.0 * std::fabs(speed), 1000.0);
+            filtered += (value - filtered) * smoothing(cutoff, dt);
+        }
+        return filtered;
+    }
+
+private:
+    static double smoothing(double cutoff, double dt) {
+        const double tau = 1.0 / (2.0 * M_PI * cutoff);
+        return dt / (dt + tau);
+    }
+
+    AnalogFilter filter;
+    bool primed = false;
+    double filtered = 0;
+    double speed = 0;
+};
+
+struct FilterResult
+{
+    int32_t worst;
+    double rms;
+    uint32_t inputSpread;     // Largest minus smallest reading at rest, 16-bit units
+    uint32_t outputSpread;
+};
+
+static AnalogOptions & setupAnalog(Gamepad & gamepad, uint64_t startMicros, AnalogFilter filter) {
+    HostStub::reset();
+    HostStub::setTime(startMicros);
+    Storage & storage = Storage::getInstance();
+    storage.SetGamepad(&gamepad);
+
+    AnalogOptions & options = storage.getAddonOptions().analogOptions;
+    options.enabled = true;
+    options.analogAdc1PinX = ANALOG_PIN_X;
+    options.analogAdc1PinY = ANALOG_PIN_Y;
+    options.analogAdc2PinX = -1;
+    options.analogAdc2PinY = -1;
+    options.analogAdc1Mode = DPAD_MODE_LEFT_ANALOG;
+    options.analogAdc2Mode = DPAD_MODE_DIGITAL;
+    options.analogAdc1Filter = filter;
+    options.analogFilterEmaAlpha = FILTER_EMA_ALPHA;
+    options.analogFilterMinCutoff = FILTER_MIN_CUTOFF;
+    options.analogFilterBeta = FILTER_BETA;
+    return options;
+}
+
+static FilterResult replay(const std::vector<TraceSample> & trace, AnalogFilter filter) {
+    Gamepad gamepad;
+    setupAnalog(gamepad, trace[0].micros, filter);
+    AnalogInput analog;
+    analog.setup();
+
+    ReferenceFilter referenceX(filter);
+    ReferenceFilter referenceY(filter);
+    FilterResult result = { 0, 0, 0, 0 };
+    uint16_t inputMin = UINT16_MAX, inputMax = 0, outputMin = UINT16_MAX, outputMax = 0;
+    double squares = 0;
+    uint64_t last = trace[0].micros;
+
+    for (const TraceSample & sample : trace) {
+        HostStub::setTime(sample.micros);
+        HostStub::setAdc(ANALOG_PIN_X - 26, sample.x);
+        HostStub::setAdc(ANALOG_PIN_Y - 26, sample.y);
+        analog.process();
+
+        const uint32_t elapsed = std::clamp<uint64_t>(sample.micros - last, 1, 50000);
+        last = sample.micros;
+        const uint16_t inputX = toAnalog(sample.x);
+        const uint16_t inputY = toAnalog(sample.y);
+        const double expectedX = referenceX.apply(inputX, elapsed);
+        const double expectedY = referenceY.apply(inputY, elapsed);
+
+        const double errorX = gamepad.state.lx - expectedX;
+        const double errorY = gamepad.state.ly - expectedY;
+        result.worst = std::max<int32_t>(result.worst, std::lround(std::max(std::fabs(errorX), std::fabs(errorY))));
+        squares += errorX * errorX + errorY * errorY;
+
+        if (sample.micros >= REST_START_MICROS && sample.micros < REST_END_MICROS) {
+            inputMin = std::min(inputMin, inputX);
+            inputMax = std::max(inputMax, inputX);
+            outputMin = std::min(outputMin, gamepad.state.lx);
+            outputMax = std::max(outputMax, gamepad.state.lx);
+        }
+    }
+
+    result.rms = std::sqrt(squares / (2 * trace.size()));
+    result.inputSpread = inputMax - inputMin;
+    result.outputSpread = outputMax - outputMin;
+    return result;
+}
+
+// Stick position of every poll and the noise around it, both taken from the trace. The median of
+// five neighbouring readings drops the noise and follows the motion, the noise is what the
+// readings at rest scatter around their mean
+struct TraceNoise
+{
+    std::vector<uint16_t> x;
+    std::vector<uint16_t> y;
+    std::vector<int32_t> noise;
+};
+
+static TraceNoise splitNoise(const std::vector<TraceSample> & trace) {
+    TraceNoise split;
+    for (size_t i = 0; i < trace.size(); i++) {
+        uint16_t x[5], y[5];
+        for (size_t j = 0; j < 5; j++) {
+            const size_t index = std::clamp<size_t>(i + j, 2, trace.size() + 1) - 2;
+            x[j] = trace[index].x;
+            y[j] = trace[index].y;
+        }
+        std::nth_element(x, x + 2, x + 5);
+        std::nth_element(y, y + 2, y + 5);
+        split.x.push_back(x[2]);
+        split.y.push_back(y[2]);
+    }
+
+    double sumX = 0, sumY = 0;
+    uint32_t count = 0;
+    for (const TraceSample & sample : trace) {
+        if (sample.micros >= REST_START_MICROS && sample.micros < REST_END_MICROS) {
+            sumX += sample.x;
+            sumY += sample.y;
+            count++;
+        }
+    }
+    CHECK(count > 100);
+    for (const TraceSample & sample : trace) {
+        if (sample.micros >= REST_START_MICROS && sample.micros < REST_END_MICROS) {
+            split.noise.push_back(sample.x - std::lround(sumX / count));
+            split.noise.push_back(sample.y - std::lround(sumY / count));
+        }
+    }
+    return split;
+}
+
+struct OversampleResult
+{
+    double singleRms;           // Error of one conversion against the stick position
+    double oversampledRms;      // Error of the filter output
+    uint32_t singleSpread;      // Largest minus smallest at rest, 16-bit units
+    uint32_t oversampledSpread;
+};
+
+// Every poll OVERSAMPLE_CONVERSIONS conversions of both inputs land in the sampler, each the stick
+// position plus the next noise value of the trace. The output has to be the mean of the newest
+// ones, as many as the clamped sample count
+static OversampleResult replayOversampled(const std::vector<TraceSample> & trace, uint32_t samples) {
+    Gamepad gamepad;
+    setupAnalog(gamepad, trace[0].micros, ANALOG_FILTER_OVERSAMPLE).analogFilterSamples = samples;
+    AnalogInput analog;
+    analog.setup();
+
+    const TraceNoise split = splitNoise(trace);
+    const uint32_t averaged = std::clamp<uint32_t>(samples, 1, ADC_SAMPLER_DEPTH / 2);
+    const double scale = 65535.0 / 4095.0;
+    OversampleResult result = { 0, 0, 0, 0 };
+    uint16_t singleMin = UINT16_MAX, singleMax = 0, outputMin = UINT16_MAX, outputMax = 0;
+    double singleSquares = 0, outputSquares = 0;
+    size_t next = 0;
+    std::vector<uint16_t> conversionsX, conversionsY;
+
+    for (size_t i = 0; i < trace.size(); i++) {
+        HostStub::setTime(trace[i].micros);
+        for (uint32_t j = 0; j < OVERSAMPLE_CONVERSIONS; j++) {
+            conversionsX.push_back(std::clamp<int32_t>(split.x[i] + split.noise[next++ % split.noise.size()], 0, 4095));
+            conversionsY.push_back(std::clamp<int32_t>(split.y[i] + split.noise[next++ % split.noise.size()], 0, 4095));
+            HostStub::pushAdcSample(ANALOG_PIN_X - 26, conversionsX.back());
+            HostStub::pushAdcSample(ANALOG_PIN_Y - 26, conversionsY.back());
+        }
+        analog.process();
+
+        uint32_t sumX = 0, sumY = 0;
+        for (uint32_t j = 0; j < averaged; j++) {
+            sumX += conversionsX[conversionsX.size() - 1 - j];
+            sumY += conversionsY[conversionsY.size() - 1 - j];
+        }
+        CHECK_EQ(gamepad.state.lx, toAnalog(sumX / averaged));
+        CHECK_EQ(gamepad.state.ly, toAnalog(sumY / averaged));
+
+        const uint16_t single = toAnalog(conversionsX.back());
+        const double errorSingle = single - split.x[i] * scale;
+        const double errorOutput = gamepad.state.lx - split.x[i] * scale;
+        singleSquares += errorSingle * errorSingle;
+        outputSquares += errorOutput * errorOutput;
+
+        if (trace[i].micros >= REST_START_MICROS && trace[i].micros < REST_END_MICROS) {
+            singleMin = std::min(singleMin, single);
+            singleMax = std::max(singleMax, single);
+            outputMin = std::min(outputMin, gamepad.state.lx);
+            outputMax = std::max(outputMax, gamepad.state.lx);
+        }
+        conversionsX.erase(conversionsX.begin(), conversionsX.end() - ADC_SAMPLER_DEPTH);
+        conversionsY.erase(conversionsY.begin(), conversionsY.end() - ADC_SAMPLER_DEPTH);
+    }
+
+    result.singleRms = std::sqrt(singleSquares / trace.size());
+    result.oversampledRms = std::sqrt(outputSquares / trace.size());
+    result.singleSpread = singleMax - singleMin;
+    result.oversampledSpread = outputMax - outputMin;
+    return result;
+}
+
+static std::vector<TraceSample> trace;
+
+static void testEmaMatchesReference() {
+    const FilterResult result = replay(trace, ANALOG_FILTER_EMA);
+    printf("worst %d counts, rms %.2f, rest spread %u -> %u\n", result.worst, result.rms, result.inputSpread, result.outputSpread);
+    CHECK(result.worst <= FILTER_TOLERANCE);
+    CHECK(result.outputSpread < result.inputSpread);
+}
+
+static void testOneEuroMatchesReference() {
+    const FilterResult result = replay(trace, ANALOG_FILTER_ONE_EURO);
+    printf("worst %d counts, rms %.2f, rest spread %u -> %u\n", result.worst, result.rms, result.inputSpread, result.outputSpread);
+    CHECK(result.worst <= FILTER_TOLERANCE);
+    CHECK(result.outputSpread < result.inputSpread);
+}
+
+// Averaging four conversions halves the noise, some of that is lost to the 12-bit truncation
+static void testOversampleAveragesConversions() {
+    const OversampleResult result = replayOversampled(trace, 4);
+    printf("rms %.2f -> %.2f, rest spread %u -> %u\n", result.singleRms, result.oversampledRms, result.singleSpread, result.oversampledSpread);
+    CHECK(result.oversampledRms < result.singleRms * 0.7);
+    CHECK(result.oversampledSpread < result.singleSpread);
+}
+
+// More samples than the sampler keeps per input average the newest ADC_SAMPLER_DEPTH / 2
+static void testOversampleSamplesAreClamped() {
+    const OversampleResult result = replayOversampled(trace, 20);
+    printf("rms %.2f -> %.2f, rest spread %u -> %u\n", result.singleRms, result.oversampledRms, result.singleSpread, result.oversampledSpread);
+    CHECK(result.oversampledRms < result.singleRms * 0.5);
+}
+
+int main() {
+    trace = loadTrace(ADC_CAPTURE_PATH);
+    if (trace.empty()) {
+        trace = loadTrace(ADC_TRACE_PATH);
+    } else {
+        printf("replaying the board capture %s\n", ADC_CAPTURE_PATH);
+    }
+    CHECK(trace.size() > 1000);
+    RUN_TEST(testEmaMatchesReference);
+    RUN_TEST(testOneEuroMatchesReference);
+    RUN_TEST(testOversampleAveragesConversions);
+    RUN_TEST(testOversampleSamplesAreClamped);
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include "testing.h"
+
+#include "gamepad/GamepadDebouncer.h"
+
+#include <string.h>
+
+static GamepadState sample(uint16_t buttons, uint8_t dpad = 0) {
+    GamepadState state = { };
+    state.buttons = buttons;
+    state.dpad = dpad;
+    return state;
+}
+
+static void resetDebouncer(GamepadDebouncer & debouncer) {
+    debouncer.debounceState = { };
+    memset(debouncer.dpadTime, 0, sizeof(debouncer.dpadTime));
+    memset(debouncer.buttonTime, 0, sizeof(debouncer.buttonTime));
+}
+
+static void testTimedHoldsChangesForDebounceMS() {
+    GamepadDebouncer debouncer(5);
+    resetDebouncer(debouncer);
+    debouncer.setMode(DEBOUNCE_MODE_TIMED, 0, 0);
+
+    GamepadState state = sample(GAMEPAD_MASK_B1, GAMEPAD_MASK_UP);
+    debouncer.debounce(&state, 10000);
+    CHECK_EQ(state.buttons, GAMEPAD_MASK_B1);
+    CHECK_EQ(state.dpad, GAMEPAD_MASK_UP);
+
+    // Released 2ms after the press, still inside the window
+    state = sample(0);
+    debouncer.debounce(&state, 12000);
+    CHECK_EQ(state.buttons, GAMEPAD_MASK_B1);
+    CHECK_EQ(state.dpad, GAMEPAD_MASK_UP);
+
+    state = sample(0);
+    debouncer.debounce(&state, 16000);
+    CHECK_EQ(state.buttons, 0);
+    CHECK_EQ(state.dpad, 0);
+}
+
+static void testIntegratorNeedsConsecutiveSamples() {
+    GamepadDebouncer debouncer(5);
+    debouncer.setMode(DEBOUNCE_MODE_INTEGRATOR, 3, 0);
+    CHECK(!debouncer.isTimeBased());
+
+    GamepadState state = sample(GAMEPAD_MASK_B2);
+    debouncer.debounce(&state, 0);
+    CHECK_EQ(state.buttons, 0);
+    state = sample(GAMEPAD_MASK_B2);
+    debouncer.debounce(&state, 0);
+    CHECK_EQ(state.buttons, 0);
+
+    // A bounce starts the count over
+    state = sample(0);
+    debouncer.debounce(&state, 0);
+    for (int i = 0; i < 2; i++) {
+        state = sample(GAMEPAD_MASK_B2, GAMEPAD_MASK_LEFT);
+        debouncer.debounce(&state, 0);
+        CHECK_EQ(state.buttons, 0);
+        CHECK_EQ(state.dpad, 0);
+    }
+    state = sample(GAMEPAD_MASK_B2, GAMEPAD_MASK_LEFT);
+    debouncer.debounce(&state, 0);
+    CHECK_EQ(state.buttons, GAMEPAD_MASK_B2);
+    CHECK_EQ(state.dpad, GAMEPAD_MASK_LEFT);
+}
+
+static void testIntegratorClampsSamples() {
+    GamepadDebouncer debouncer(5);
+    debouncer.setMode(DEBOUNCE_MODE_INTEGRATOR, 100, 0);
+
+    GamepadState state;
+    for (int i = 0; i < DEBOUNCE_INTEGRATOR_MAX_SAMPLES - 1; i++) {
+        state = sample(GAMEPAD_MASK_R2);
+        debouncer.debounce(&state, 0);
+        CHECK_EQ(state.buttons, 0);
+    }
+    state = sample(GAMEPAD_MASK_R2);
+    debouncer.debounce(&state, 0);
+    CHECK_EQ(state.buttons, GAMEPAD_MASK_R2);
+}
+
+static void testEagerReportsFirstEdgeThenLocksOut() {
+    GamepadDebouncer debouncer(5);
+    debouncer.setMode(DEBOUNCE_MODE_EAGER, 0, 2000);
+    CHECK(debouncer.isTimeBased());
+
+    GamepadState state = sample(GAMEPAD_MASK_S2);
+    debouncer.debounce(&state, 1000);
+    CHECK_EQ(state.buttons, GAMEPAD_MASK_S2);
+
+    // Bounce inside the lockout is ignored
+    state = sample(0);
+    debouncer.debounce(&state, 1500);
+    CHECK_EQ(state.buttons, GAMEPAD_MASK_S2);
+    state = sample(GAMEPAD_MASK_S2 | GAMEPAD_MASK_B4);
+    debouncer.debounce(&state, 2500);
+    CHECK_EQ(state.buttons, GAMEPAD_MASK_S2 | GAMEPAD_MASK_B4);
+
+    state = sample(GAMEPAD_MASK_B4);
+    debouncer.debounce(&state, 3000);
+    CHECK_EQ(state.buttons, GAMEPAD_MASK_B4);
+}
+
+int main() {
+    RUN_TEST(testTimedHoldsChangesForDebounceMS);
+    RUN_TEST(testIntegratorNeedsConsecutiveSamples);
+    RUN_TEST(testIntegratorClampsSamples);
+    RUN_TEST(testEagerReportsFirstEdgeThenLocksOut);
+    return 0;
+}
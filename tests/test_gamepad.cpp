@@ -0,0 +1,72 @@
+#include "testing.h"
+#include "hoststub.h"
+#include "gamepadfixture.h"
+
+static uint32_t nextRandom(uint32_t & seed) {
+    seed = seed * 1664525 + 1013904223;
+    return seed;
+}
+
+static void testPinLookupMatchesPerMappingRead() {
+    HostStub::reset();
+    mapBoardPins(Storage::getInstance().getPinMappings());
+    Gamepad gamepad;
+    gamepad.setup();
+
+    GamepadState expected;
+    uint32_t seed = 1;
+    for (uint32_t i = 0; i < 100000; i++) {
+        const uint32_t values = nextRandom(seed);
+        gamepad.readPins(values);
+        readPinsPerMapping(gamepad, values, expected);
+        CHECK_EQ(gamepad.state.dpad, expected.dpad);
+        CHECK_EQ(gamepad.state.buttons, expected.buttons);
+        CHECK_EQ(gamepad.state.aux, 0);
+    }
+}
+
+// Every mapping on its own pin in a different nibble position, including pins above 15
+static void testPinLookupWithScrambledMapping() {
+    HostStub::reset();
+    PinMappings & pins = Storage::getInstance().getPinMappings();
+    mapBoardPins(pins);
+    pins.pinDpadUp = 29;
+    pins.pinButtonB1 = 0;
+    pins.pinButtonA2 = 22;
+    pins.pinButtonL3 = -1;
+    pins.pinButtonFn = 14;
+    Gamepad gamepad;
+    gamepad.setup();
+
+    GamepadState expected;
+    uint32_t seed = 7;
+    for (uint32_t i = 0; i < 100000; i++) {
+        const uint32_t values = nextRandom(seed);
+        gamepad.readPins(values);
+        readPinsPerMapping(gamepad, values, expected);
+        CHECK_EQ(gamepad.state.dpad, expected.dpad);
+        CHECK_EQ(gamepad.state.buttons, expected.buttons);
+        CHECK_EQ(gamepad.state.aux, (values & (1U << 14)) ? AUX_MASK_FUNCTION : 0);
+    }
+}
+
+static void testReadInvertsPullUps() {
+    HostStub::reset();
+    mapBoardPins(Storage::getInstance().getPinMappings());
+    Gamepad gamepad;
+    gamepad.setup();
+
+    HostStub::setGpio(~((1U << PIN_BUTTON_B2) | (1U << PIN_DPAD_LEFT)));
+    gamepad.read();
+    CHECK_EQ(gamepad.state.buttons, GAMEPAD_MASK_B2);
+    CHECK_EQ(gamepad.state.dpad, GAMEPAD_MASK_LEFT);
+    CHECK(gamepad.pressedPin(PIN_BUTTON_B2));
+    CHECK(!gamepad.pressedPin(PIN_BUTTON_B1));
+}
+
+int main() {
+    RUN_TEST(testPinLookupMatchesPerMappingRead);
+    RUN_TEST(testPinLookupWithScrambledMapping);
+    RUN_TEST(testReadInvertsPullUps);
+    return 0;
+}
@@ -0,0 +1,133 @@
+#include "testing.h"
+
+#include "hidreportparser.h"
+
+// Report 1: 12 buttons, a hat and four 8-bit axes, report 2: one vendor button on its own
+static const uint8_t gamepadDescriptor[] = {
+    0x05, 0x01, 0x09, 0x05, 0xA1, 0x01,
+    0x85, 0x01,
+    0x05, 0x09, 0x19, 0x01, 0x29, 0x0C, 0x15, 0x00, 0x25, 0x01, 0x75, 0x01, 0x95, 0x0C, 0x81, 0x02,
+    0x75, 0x01, 0x95, 0x04, 0x81, 0x03,
+    0x05, 0x01, 0x09, 0x39, 0x15, 0x00, 0x25, 0x07, 0x75, 0x04, 0x95, 0x01, 0x81, 0x42,
+    0x75, 0x04, 0x95, 0x01, 0x81, 0x03,
+    0x09, 0x30, 0x09, 0x31, 0x09, 0x32, 0x09, 0x35, 0x15, 0x00, 0x26, 0xFF, 0x00, 0x75, 0x08, 0x95, 0x04, 0x81, 0x02,
+    0x85, 0x02,
+    0x05, 0x09, 0x09, 0x0D, 0x15, 0x00, 0x25, 0x01, 0x75, 0x01, 0x95, 0x01, 0x81, 0x02,
+    0x75, 0x07, 0x95, 0x01, 0x81, 0x03,
+    0xC0,
+};
+
+static void testGamepadReport() {
+    HidReportParser parser;
+    CHECK(parser.compile(gamepadDescriptor, sizeof(gamepadDescriptor), nullptr));
+
+    HidReportState state;
+    // Button 2, hat east, X full right, Y full up, Z and Rz centred
+    const uint8_t report[] = { 0x01, 0x02, 0x00, 0x02, 0xFF, 0x00, 0x80, 0x80 };
+    parser.translate(report, sizeof(report), state);
+    CHECK_EQ(state.state.buttons, GAMEPAD_MASK_B1);
+    CHECK_EQ(state.state.dpad, GAMEPAD_MASK_RIGHT);
+    CHECK_EQ(state.state.lx, GAMEPAD_JOYSTICK_MAX);
+    CHECK_EQ(state.state.ly, 0);
+    CHECK_EQ(state.analog, HID_REPORT_ANALOG_LX | HID_REPORT_ANALOG_LY | HID_REPORT_ANALOG_RX | HID_REPORT_ANALOG_RY);
+
+    // Report 2 only owns button 13, the rest of report 1 stays
+    const uint8_t home[] = { 0x02, 0x01 };
+    parser.translate(home, sizeof(home), state);
+    CHECK_EQ(state.state.buttons, GAMEPAD_MASK_B1 | GAMEPAD_MASK_A1);
+    CHECK_EQ(state.state.dpad, GAMEPAD_MASK_RIGHT);
+
+    // Null hat and released buttons
+    const uint8_t idle[] = { 0x01, 0x00, 0x00, 0x08, 0x80, 0x80, 0x80, 0x80 };
+    parser.translate(idle, sizeof(idle), state);
+    CHECK_EQ(state.state.buttons, GAMEPAD_MASK_A1);
+    CHECK_EQ(state.state.dpad, 0);
+}
+
+static void testShortReportIsIgnored() {
+    HidReportParser parser;
+    CHECK(parser.compile(gamepadDescriptor, sizeof(gamepadDescriptor), nullptr));
+
+    HidReportState state;
+    const uint8_t truncated[] = { 0x01, 0x02 };
+    parser.translate(truncated, sizeof(truncated), state);
+    CHECK_EQ(state.state.buttons, GAMEPAD_MASK_B1);
+    CHECK_EQ(state.state.lx, GAMEPAD_JOYSTICK_MID);
+}
+
+static void testBootKeyboard() {
+    uint32_t keys[HID_REPORT_KEY_COUNT] = { };
+    keys[0x04] = GAMEPAD_MASK_B1;                                       // A
+    keys[0xE1] = GAMEPAD_MASK_S1;                                       // Left shift
+    keys[0x52] = static_cast<uint32_t>(GAMEPAD_MASK_UP) << HID_REPORT_DPAD_SHIFT; // Up arrow
+
+    HidReportParser parser;
+    parser.compileBootKeyboard(keys);
+
+    HidReportState state;
+    const uint8_t report[] = { 0x02, 0x00, 0x04, 0x52, 0x00, 0x00, 0x00, 0x00 };
+    parser.translate(report, sizeof(report), state);
+    CHECK_EQ(state.state.buttons, GAMEPAD_MASK_B1 | GAMEPAD_MASK_S1);
+    CHECK_EQ(state.state.dpad, GAMEPAD_MASK_UP);
+
+    const uint8_t released[] = { 0x00, 0x00, 0x52, 0x00, 0x00, 0x00, 0x00, 0x00 };
+    parser.translate(released, sizeof(released), state);
+    CHECK_EQ(state.state.buttons, 0);
+    CHECK_EQ(state.state.dpad, GAMEPAD_MASK_UP);
+}
+
+// Boot mouse: three buttons, then relative X, Y and wheel
+static const uint8_t mouseDescriptor[] = {
+    0x05, 0x01, 0x09, 0x02, 0xA1, 0x01,
+    0x09, 0x01, 0xA1, 0x00,
+    0x05, 0x09, 0x19, 0x01, 0x29, 0x03, 0x15, 0x00, 0x25, 0x01, 0x75, 0x01, 0x95, 0x03, 0x81, 0x02,
+    0x75, 0x05, 0x95, 0x01, 0x81, 0x03,
+    0x05, 0x01, 0x09, 0x30, 0x09, 0x31, 0x09, 0x38, 0x15, 0x81, 0x25, 0x7F, 0x75, 0x08, 0x95, 0x03, 0x81, 0x06,
+    0xC0,
+    0xC0,
+};
+
+static void testMouseIsNotMapped() {
+    HidReportParser parser;
+    CHECK(!parser.compile(mouseDescriptor, sizeof(mouseDescriptor), nullptr));
+
+    HidReportState state;
+    // All three buttons, moving right and up
+    const uint8_t report[] = { 0x07, 0x40, 0xC0, 0x00 };
+    parser.translate(report, sizeof(report), state);
+    CHECK_EQ(state.state.buttons, 0);
+    CHECK_EQ(state.state.lx, GAMEPAD_JOYSTICK_MID);
+    CHECK_EQ(state.analog, 0);
+}
+
+// Joystick with a relative dial next to its absolute stick, only the stick is an axis
+static const uint8_t dialDescriptor[] = {
+    0x05, 0x01, 0x09, 0x04, 0xA1, 0x01,
+    0x05, 0x09, 0x09, 0x01, 0x15, 0x00, 0x25, 0x01, 0x75, 0x01, 0x95, 0x01, 0x81, 0x02,
+    0x75, 0x07, 0x95, 0x01, 0x81, 0x03,
+    0x05, 0x01, 0x09, 0x30, 0x15, 0x00, 0x26, 0xFF, 0x00, 0x75, 0x08, 0x95, 0x01, 0x81, 0x02,
+    0x09, 0x37, 0x09, 0x31, 0x15, 0x81, 0x25, 0x7F, 0x75, 0x08, 0x95, 0x02, 0x81, 0x06,
+    0xC0,
+};
+
+static void testRelativeItemsAreSkipped() {
+    HidReportParser parser;
+    CHECK(parser.compile(dialDescriptor, sizeof(dialDescriptor), nullptr));
+
+    HidReportState state;
+    const uint8_t report[] = { 0x01, 0xFF, 0x10, 0x80 };
+    parser.translate(report, sizeof(report), state);
+    CHECK_EQ(state.state.buttons, GAMEPAD_MASK_B3);
+    CHECK_EQ(state.state.lx, GAMEPAD_JOYSTICK_MAX);
+    CHECK_EQ(state.state.ly, GAMEPAD_JOYSTICK_MID);
+    CHECK_EQ(state.analog, HID_REPORT_ANALOG_LX);
+}
+
+int main() {
+    RUN_TEST(testGamepadReport);
+    RUN_TEST(testShortReportIsIgnored);
+    RUN_TEST(testBootKeyboard);
+    RUN_TEST(testMouseIsNotMapped);
+    RUN_TEST(testRelativeItemsAreSkipped);
+    return 0;
+}
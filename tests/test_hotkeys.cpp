@@ -0,0 +1,81 @@
+#include "testing.h"
+
+#include "gamepad/GamepadHotkeys.h"
+
+static HotkeyEntry entry(GamepadHotkey action, uint32_t buttons, uint32_t dpad, uint32_t aux = 0) {
+    HotkeyEntry hotkey = HotkeyEntry_init_zero;
+    hotkey.action = action;
+    hotkey.buttonsMask = buttons;
+    hotkey.dpadMask = dpad;
+    hotkey.auxMask = aux;
+    return hotkey;
+}
+
+static GamepadState held(uint16_t buttons, uint8_t dpad, uint16_t aux = 0) {
+    GamepadState state = { };
+    state.buttons = buttons;
+    state.dpad = dpad;
+    state.aux = aux;
+    return state;
+}
+
+static void testMatchesOnlyWithAllInputsHeld() {
+    HotkeyOptions options = HotkeyOptions_init_zero;
+    options.hotkey01 = entry(HOTKEY_DPAD_LEFT_ANALOG, GAMEPAD_MASK_S1 | GAMEPAD_MASK_S2, GAMEPAD_MASK_LEFT);
+
+    GamepadHotkeys hotkeys;
+    hotkeys.compile(options);
+
+    CHECK(hotkeys.match(held(GAMEPAD_MASK_S1 | GAMEPAD_MASK_S2, 0)) == nullptr);
+    CHECK(hotkeys.match(held(GAMEPAD_MASK_S1, GAMEPAD_MASK_LEFT)) == nullptr);
+
+    const GamepadHotkeyMatch * match = hotkeys.match(held(GAMEPAD_MASK_S1 | GAMEPAD_MASK_S2 | GAMEPAD_MASK_B1, GAMEPAD_MASK_LEFT));
+    CHECK(match != nullptr);
+    CHECK_EQ(match->action, HOTKEY_DPAD_LEFT_ANALOG);
+
+    GamepadState state = held(GAMEPAD_MASK_S1 | GAMEPAD_MASK_S2 | GAMEPAD_MASK_B1, GAMEPAD_MASK_LEFT | GAMEPAD_MASK_UP);
+    match->release(state);
+    CHECK_EQ(state.buttons, GAMEPAD_MASK_B1);
+    CHECK_EQ(state.dpad, GAMEPAD_MASK_UP);
+}
+
+static void testConfigurationOrderIsPriority() {
+    HotkeyOptions options = HotkeyOptions_init_zero;
+    options.hotkey01 = entry(HOTKEY_NONE, GAMEPAD_MASK_S2, GAMEPAD_MASK_UP);
+    options.hotkey02 = entry(HOTKEY_SOCD_UP_PRIORITY, GAMEPAD_MASK_S2, GAMEPAD_MASK_UP);
+    options.hotkey03 = entry(HOTKEY_SOCD_NEUTRAL, GAMEPAD_MASK_S2, GAMEPAD_MASK_UP);
+    options.extraHotkeys_count = 1;
+    options.extraHotkeys[0] = entry(HOTKEY_INVERT_X_AXIS, GAMEPAD_MASK_A1, GAMEPAD_MASK_DOWN);
+
+    GamepadHotkeys hotkeys;
+    hotkeys.compile(options);
+
+    // Unbound slots never match, the first bound one wins
+    const GamepadHotkeyMatch * match = hotkeys.match(held(GAMEPAD_MASK_S2, GAMEPAD_MASK_UP));
+    CHECK(match != nullptr);
+    CHECK_EQ(match->action, HOTKEY_SOCD_UP_PRIORITY);
+
+    match = hotkeys.match(held(GAMEPAD_MASK_A1, GAMEPAD_MASK_DOWN));
+    CHECK(match != nullptr);
+    CHECK_EQ(match->action, HOTKEY_INVERT_X_AXIS);
+}
+
+static void testAuxModifier() {
+    HotkeyOptions options = HotkeyOptions_init_zero;
+    options.hotkey01 = entry(HOTKEY_HOME_BUTTON, 0, GAMEPAD_MASK_RIGHT, AUX_MASK_FUNCTION);
+
+    GamepadHotkeys hotkeys;
+    hotkeys.compile(options);
+
+    CHECK(hotkeys.match(held(0, GAMEPAD_MASK_RIGHT)) == nullptr);
+    const GamepadHotkeyMatch * match = hotkeys.match(held(0, GAMEPAD_MASK_RIGHT, AUX_MASK_FUNCTION));
+    CHECK(match != nullptr);
+    CHECK_EQ(match->action, HOTKEY_HOME_BUTTON);
+}
+
+int main() {
+    RUN_TEST(testMatchesOnlyWithAllInputsHeld);
+    RUN_TEST(testConfigurationOrderIsPriority);
+    RUN_TEST(testAuxModifier);
+    return 0;
+}
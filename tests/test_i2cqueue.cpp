@@ -0,0 +1,394 @@
+#include "testing.h"
+#include "hoststub.h"
+#include "mocki2cbus.h"
+
+#include "pico/time.h"
+
+#include <thread>
+
+#define STRESS_TRANSACTIONS 50000
+#define STRESS_SLOTS 8
+
+#define WII_SPEED 400000
+
+// The two hardware blocks, on mock buses, for the clients that look their queue up by block
+static MockI2CBus blockBus0;
+static MockI2CBus blockBus1;
+static I2CQueue blockQueue0(blockBus0);
+static I2CQueue blockQueue1(blockBus1);
+
+I2CQueue & I2CQueue::get(i2c_inst_t * i2c) {
+    return (i2c == i2c0) ? blockQueue0 : blockQueue1;
+}
+
+static I2CTransaction makeTransaction(uint8_t address, const uint8_t * writeData, uint16_t writeLength, uint8_t * readData, uint16_t readLength) {
+    I2CTransaction transaction = {
+        .address = address,
+        .writeData = writeData,
+        .writeLength = writeLength,
+        .readData = readData,
+        .readLength = readLength,
+        .callback = nullptr,
+        .context = nullptr,
+        .status = I2CTransactionStatus::IDLE,
+        .next = nullptr,
+    };
+    return transaction;
+}
+
+static void testCommands() {
+    HostStub::reset();
+    MockI2CBus bus;
+    I2CQueue queue(bus);
+    CHECK(queue.setup());
+    CHECK(bus.claimed);
+
+    // Register read, the read turns the bus around with a repeated start and the last byte stops it
+    const uint8_t reg[] = { 0x10, 0x20 };
+    uint8_t data[3];
+    I2CTransaction read = makeTransaction(0x40, reg, sizeof(reg), data, sizeof(data));
+    CHECK(queue.submit(read));
+    CHECK_EQ(bus.transfers.size(), 1);
+    const MockI2CBus::Transfer & first = bus.transfers[0];
+    CHECK_EQ(first.address, 0x40);
+    CHECK(first.readData == data);
+    CHECK_EQ(first.readLength, 3);
+    const std::vector<uint16_t> expected = {
+        0x10,
+        0x20,
+        I2C_BUS_COMMAND_READ | I2C_BUS_COMMAND_RESTART,
+        I2C_BUS_COMMAND_READ,
+        I2C_BUS_COMMAND_READ | I2C_BUS_COMMAND_STOP,
+    };
+    CHECK(first.commands == expected);
+    bus.raise(queue, I2C_BUS_INTERRUPT_STOP);
+    CHECK(read.status == I2CTransactionStatus::DONE);
+
+    // Write only, the last written byte stops
+    I2CTransaction write = makeTransaction(0x3C, reg, sizeof(reg), nullptr, 0);
+    CHECK(queue.submit(write));
+    CHECK(bus.transfers[1].commands == std::vector<uint16_t>({ 0x10, 0x20 | I2C_BUS_COMMAND_STOP }));
+    bus.raise(queue, I2C_BUS_INTERRUPT_STOP);
+
+    // Read only, no repeated start in front of the first byte
+    I2CTransaction poll = makeTransaction(0x52, nullptr, 0, data, 2);
+    CHECK(queue.submit(poll));
+    CHECK(bus.transfers[2].commands == std::vector<uint16_t>({ I2C_BUS_COMMAND_READ, I2C_BUS_COMMAND_READ | I2C_BUS_COMMAND_STOP }));
+    bus.raise(queue, I2C_BUS_INTERRUPT_STOP);
+    CHECK(poll.status == I2CTransactionStatus::DONE);
+}
+
+static void testSubmitRejects() {
+    HostStub::reset();
+    MockI2CBus bus;
+    I2CQueue queue(bus);
+    const uint8_t byte = 0;
+    I2CTransaction transaction = makeTransaction(0x40, &byte, 1, nullptr, 0);
+    CHECK(!queue.submit(transaction));
+
+    CHECK(queue.setup());
+    I2CTransaction empty = makeTransaction(0x40, nullptr, 0, nullptr, 0);
+    CHECK(!queue.submit(empty));
+    static uint8_t buffer[I2C_QUEUE_MAX_LENGTH];
+    I2CTransaction tooLong = makeTransaction(0x40, buffer, 1, buffer, I2C_QUEUE_MAX_LENGTH);
+    CHECK(!queue.submit(tooLong));
+
+    CHECK(queue.submit(transaction));
+    CHECK(!queue.submit(transaction));
+    CHECK_EQ(bus.transfers.size(), 1);
+}
+
+struct OrderProbe
+{
+    MockI2CBus * bus;
+    I2CTransaction * next;
+    size_t transfersAtCallback;
+    uint8_t addressAtCallback;
+    bool nextWasPending;
+};
+
+static void probeCallback(I2CTransaction & transaction) {
+    OrderProbe & probe = *static_cast<OrderProbe *>(transaction.context);
+    probe.transfersAtCallback = probe.bus->transfers.size();
+    probe.addressAtCallback = probe.bus->transfers.back().address;
+    probe.nextWasPending = probe.next->status == I2CTransactionStatus::PENDING;
+    CHECK(transaction.status == I2CTransactionStatus::DONE);
+}
+
+// finish() puts the next transaction on the bus before the callback of the finished one runs
+static void testNextStartsBeforeCallback() {
+    HostStub::reset();
+    MockI2CBus bus;
+    I2CQueue queue(bus);
+    CHECK(queue.setup());
+
+    const uint8_t byte = 0x01;
+    I2CTransaction first = makeTransaction(0x40, &byte, 1, nullptr, 0);
+    I2CTransaction second = makeTransaction(0x41, &byte, 1, nullptr, 0);
+    I2CTransaction third = makeTransaction(0x42, &byte, 1, nullptr, 0);
+    OrderProbe probe = { &bus, &second, 0, 0, false };
+    first.callback = probeCallback;
+    first.context = &probe;
+
+    CHECK(queue.submit(first));
+    CHECK(queue.submit(second));
+    CHECK(queue.submit(third));
+    CHECK_EQ(bus.transfers.size(), 1);
+
+    bus.raise(queue, I2C_BUS_INTERRUPT_STOP);
+    CHECK_EQ(probe.transfersAtCallback, 2);
+    CHECK_EQ(probe.addressAtCallback, 0x41);
+    CHECK(probe.nextWasPending);
+
+    bus.raise(queue, I2C_BUS_INTERRUPT_STOP);
+    CHECK(second.status == I2CTransactionStatus::DONE);
+    CHECK_EQ(bus.transfers.back().address, 0x42);
+    bus.raise(queue, I2C_BUS_INTERRUPT_STOP);
+    CHECK(third.status == I2CTransactionStatus::DONE);
+    CHECK_EQ(bus.transfers.size(), 3);
+    CHECK(!bus.inFlight);
+}
+
+struct ChainProbe
+{
+    I2CQueue * queue;
+    uint32_t remaining;
+};
+
+// A callback may submit again, like the ADS1219 channel hop, the lock is free by then
+static void chainCallback(I2CTransaction & transaction) {
+    ChainProbe & probe = *static_cast<ChainProbe *>(transaction.context);
+    if (probe.remaining > 0) {
+        probe.remaining--;
+        CHECK(probe.queue->submit(transaction));
+    }
+}
+
+static void testCallbackSubmits() {
+    HostStub::reset();
+    MockI2CBus bus;
+    I2CQueue queue(bus);
+    CHECK(queue.setup());
+
+    const uint8_t byte = 0x01;
+    I2CTransaction transaction = makeTransaction(0x40, &byte, 1, nullptr, 0);
+    ChainProbe probe = { &queue, 3 };
+    transaction.callback = chainCallback;
+    transaction.context = &probe;
+
+    CHECK(queue.submit(transaction));
+    for (uint32_t i = 0; i < 3; i++) {
+        bus.raise(queue, I2C_BUS_INTERRUPT_STOP);
+        CHECK(transaction.status == I2CTransactionStatus::PENDING);
+    }
+    bus.raise(queue, I2C_BUS_INTERRUPT_STOP);
+    CHECK(transaction.status == I2CTransactionStatus::DONE);
+    CHECK_EQ(bus.transfers.size(), 4);
+}
+
+static void testAbort() {
+    HostStub::reset();
+    MockI2CBus bus;
+    I2CQueue queue(bus);
+    CHECK(queue.setup());
+
+    const uint8_t byte = 0x01;
+    uint8_t data[2];
+    I2CTransaction nacked = makeTransaction(0x40, &byte, 1, data, sizeof(data));
+    I2CTransaction next = makeTransaction(0x41, &byte, 1, nullptr, 0);
+    CHECK(queue.submit(nacked));
+    CHECK(queue.submit(next));
+
+    // The block still sends its stop for a few polls, the stop it raises is cleared with the abort
+    bus.activePolls = 3;
+    bus.raise(queue, I2C_BUS_INTERRUPT_ABORT | I2C_BUS_INTERRUPT_STOP);
+    CHECK(nacked.status == I2CTransactionStatus::FAILED);
+    CHECK_EQ(bus.activePolls, 0);
+    CHECK_EQ(bus.aborts, 1);
+    CHECK_EQ(bus.abortClears, 1);
+    CHECK_EQ(bus.stopClears, 1);
+    CHECK_EQ(bus.flushes, 1);
+    CHECK_EQ(bus.status, 0);
+    CHECK_EQ(bus.transfers.size(), 2);
+    CHECK_EQ(bus.transfers.back().address, 0x41);
+
+    // A bus that never goes idle holds the interrupt for the settle time only
+    HostStub::setTime(0);
+    bus.activePolls = MOCK_I2C_STUCK;
+    bus.raise(queue, I2C_BUS_INTERRUPT_ABORT);
+    CHECK(next.status == I2CTransactionStatus::FAILED);
+    CHECK(time_us_64() >= I2C_QUEUE_SETTLE_MICROS && time_us_64() <= I2C_QUEUE_SETTLE_MICROS + MOCK_I2C_POLL_MICROS);
+    CHECK_EQ(bus.aborts, 2);
+    CHECK_EQ(bus.transfers.size(), 2);
+}
+
+static void testStopDrain() {
+    HostStub::reset();
+    MockI2CBus bus;
+    I2CQueue queue(bus);
+    CHECK(queue.setup());
+
+    const uint8_t reg = 0x10;
+    uint8_t data[4];
+    I2CTransaction read = makeTransaction(0x40, &reg, 1, data, sizeof(data));
+
+    // The last byte lands a few polls after the stop
+    CHECK(queue.submit(read));
+    bus.receivingPolls = 2;
+    bus.raise(queue, I2C_BUS_INTERRUPT_STOP);
+    CHECK(read.status == I2CTransactionStatus::DONE);
+    CHECK_EQ(bus.receivingPolls, 0);
+    CHECK_EQ(bus.aborts, 0);
+    CHECK_EQ(bus.stopClears, 1);
+
+    // Bytes that never arrive fail the transaction and stop the DMA
+    HostStub::setTime(0);
+    CHECK(queue.submit(read));
+    bus.receivingPolls = MOCK_I2C_STUCK;
+    bus.raise(queue, I2C_BUS_INTERRUPT_STOP);
+    CHECK(read.status == I2CTransactionStatus::FAILED);
+    CHECK_EQ(bus.aborts, 1);
+    CHECK(time_us_64() >= I2C_QUEUE_SETTLE_MICROS);
+
+    // A stop without a transaction, the abort path already finished it
+    bus.receivingPolls = 0;
+    bus.status = I2C_BUS_INTERRUPT_STOP;
+    queue.handleIRQ();
+    CHECK_EQ(bus.stopClears, 3);
+    CHECK_EQ(bus.status, 0);
+    CHECK_EQ(bus.transfers.size(), 2);
+}
+
+struct StressProbe
+{
+    uint32_t client;
+    uint32_t sequence;
+    std::atomic<bool> busy;     // Cleared once the callback is done with the slot
+};
+
+static std::atomic<uint32_t> stressCompleted;
+static uint32_t stressLastSequence[2];
+static bool stressInOrder;
+
+static void stressCallback(I2CTransaction & transaction) {
+    const StressProbe & probe = *static_cast<const StressProbe *>(transaction.context);
+    if (probe.sequence != stressLastSequence[probe.client] + 1) {
+        stressInOrder = false;
+    }
+    stressLastSequence[probe.client] = probe.sequence;
+    stressCompleted.fetch_add(1, std::memory_order_release);
+}
+
+static void stressDone(I2CTransaction & transaction) {
+    stressCallback(transaction);
+    static_cast<StressProbe *>(transaction.context)->busy.store(false, std::memory_order_release);
+}
+
+// Two clients submit from their own threads while a third plays the interrupt on the other core
+static void testCrossCoreSubmit() {
+    HostStub::reset();
+    MockI2CBus bus;
+    I2CQueue queue(bus);
+    CHECK(queue.setup());
+    bus.transfers.reserve(2 * STRESS_TRANSACTIONS);
+
+    stressCompleted = 0;
+    stressLastSequence[0] = stressLastSequence[1] = 0;
+    stressInOrder = true;
+
+    auto client = [&](uint32_t id) {
+        const uint8_t byte = static_cast<uint8_t>(id);
+        I2CTransaction transactions[STRESS_SLOTS];
+        StressProbe probes[STRESS_SLOTS];
+        for (uint32_t slot = 0; slot < STRESS_SLOTS; slot++) {
+            transactions[slot] = makeTransaction(0x40 + id, &byte, 1, nullptr, 0);
+            transactions[slot].callback = stressDone;
+            transactions[slot].context = &probes[slot];
+            probes[slot].busy = false;
+        }
+        for (uint32_t sequence = 1; sequence <= STRESS_TRANSACTIONS; sequence++) {
+            const uint32_t slot = sequence % STRESS_SLOTS;
+            while (probes[slot].busy.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            probes[slot].client = id;
+            probes[slot].sequence = sequence;
+            probes[slot].busy = true;
+            CHECK(queue.submit(transactions[slot]));
+        }
+        for (StressProbe & probe : probes) {
+            while (probe.busy.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+        }
+    };
+
+    std::thread interrupt([&]() {
+        while (stressCompleted.load(std::memory_order_acquire) < 2 * STRESS_TRANSACTIONS) {
+            if (bus.started.load(std::memory_order_acquire)) {
+                bus.raise(queue, I2C_BUS_INTERRUPT_STOP);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+    std::thread client0(client, 0);
+    std::thread client1(client, 1);
+    client0.join();
+    client1.join();
+    interrupt.join();
+
+    CHECK(stressInOrder);
+    CHECK_EQ(stressLastSequence[0], STRESS_TRANSACTIONS);
+    CHECK_EQ(stressLastSequence[1], STRESS_TRANSACTIONS);
+    CHECK_EQ(bus.transfers.size(), 2 * STRESS_TRANSACTIONS);
+    CHECK(!bus.inFlight);
+}
+
+// Plays the interrupt for one transfer once the queue has started it
+static void completeNextTransfer(MockI2CBus & bus, I2CQueue & queue) {
+    while (!bus.started.load(std::memory_order_acquire)) {
+        std::this_thread::yield();
+    }
+    bus.raise(queue, I2C_BUS_INTERRUPT_STOP);
+}
+
+// The ADS1219 starts the queue of a block in setup(), the Wii extension initialises the same block
+// later in begin(). Neither order may reset a block whose queue runs, its blocking transfers would
+// never see their STOP_DET
+static void testTwoClientsOnOneBlock() {
+    HostStub::reset();
+    const uint8_t reg = 0x10;
+    uint8_t data[2];
+
+    // Queue first, the Wii init leaves the block alone and goes through the queue
+    CHECK(!i2c_queue_active(i2c0));
+    CHECK(I2CQueue::get(i2c0).setup());
+    CHECK(blockBus0.claimed);
+    i2c_queue_init(i2c0, WII_SPEED);
+    CHECK_EQ(HostStub::getI2CInitCount(0), 0);
+    std::thread interrupt(completeNextTransfer, std::ref(blockBus0), std::ref(blockQueue0));
+    CHECK_EQ(i2c_queue_transfer_blocking(i2c0, 0x52, &reg, 1, data, sizeof(data)), 3);
+    interrupt.join();
+    CHECK_EQ(blockBus0.transfers.back().address, 0x52);
+
+    // Plain init first, then the queue, a second init after that is skipped again
+    i2c_queue_init(i2c1, WII_SPEED);
+    CHECK_EQ(HostStub::getI2CInitCount(1), 1);
+    CHECK(I2CQueue::get(i2c1).setup());
+    i2c_queue_init(i2c1, WII_SPEED);
+    CHECK_EQ(HostStub::getI2CInitCount(1), 1);
+    CHECK_EQ(HostStub::getI2CInitCount(0), 0);
+}
+
+int main() {
+    RUN_TEST(testCommands);
+    RUN_TEST(testSubmitRejects);
+    RUN_TEST(testNextStartsBeforeCallback);
+    RUN_TEST(testCallbackSubmits);
+    RUN_TEST(testAbort);
+    RUN_TEST(testStopDrain);
+    RUN_TEST(testCrossCoreSubmit);
+    RUN_TEST(testTwoClientsOnOneBlock);
+    return 0;
+}
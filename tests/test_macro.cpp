@@ -0,0 +1,180 @@
+#include "testing.h"
+#include "hoststub.h"
+#include "gamepadfixture.h"
+
+#include "addons/macro.h"
+
+#include <vector>
+
+// Drives MacroInput through polls at a chosen interval and checks every output against the step
+// table. Steps change on the poll whose report, half a poll period later, is past the step's end
+
+#define PIN_MACRO 14
+
+#define PIN(name) (1U << PIN_##name)
+
+#define DPAD(mask) ((mask) << MACRO_STEP_DPAD_SHIFT)
+
+static uint32_t step(uint32_t input, uint32_t duration) {
+    return input | (duration << MACRO_STEP_DURATION_SHIFT);
+}
+
+static uint32_t frameStep(uint32_t input, uint32_t frames) {
+    return step(input, frames) | MACRO_STEP_FRAMES;
+}
+
+struct MacroFixture
+{
+    Gamepad gamepad;
+    MacroInput macro;
+
+    Macro & setup(uint32_t triggerMask, int32_t triggerPin, bool repeatWhileHeld, const std::vector<uint32_t> & steps) {
+        HostStub::reset();
+        HostStub::setTime(1000000);
+        Storage & storage = Storage::getInstance();
+        mapBoardPins(storage.getPinMappings());
+        storage.SetGamepad(&gamepad);
+
+        MacroOptions & options = storage.getAddonOptions().macroOptions;
+        options.enabled = true;
+        options.macros_count = 1;
+        Macro & macro = options.macros[0];
+        macro.triggerMask = triggerMask;
+        macro.triggerPin = triggerPin;
+        macro.repeatWhileHeld = repeatWhileHeld;
+        macro.steps_count = steps.size();
+        for (size_t i = 0; i < steps.size(); i++) {
+            macro.steps[i] = steps[i];
+        }
+
+        gamepad.setup();
+        CHECK(this->macro.available());
+        this->macro.setup();
+        return macro;
+    }
+
+    // One poll as GP2040::run() makes it, then the time moves on to the next one
+    uint32_t poll(uint32_t pins, uint32_t intervalMicros) {
+        HostStub::setGpio(~pins);
+        gamepad.read();
+        macro.preprocess();
+        HostStub::advanceTime(intervalMicros);
+        return gamepad.state.buttons | DPAD(gamepad.state.dpad);
+    }
+};
+
+static MacroFixture fixture;
+
+// Input of the step playing at offset micros into the program, 0 once it is over
+static uint32_t expectedInput(const std::vector<uint32_t> & steps, const std::vector<uint64_t> & ends, uint64_t offset) {
+    for (size_t i = 0; i < ends.size(); i++) {
+        if (offset < ends[i]) {
+            return steps[i] & MACRO_STEP_INPUT_MASK;
+        }
+    }
+    return 0;
+}
+
+// Microsecond and frame steps mixed, polled every microsecond so a step change one poll early or
+// late shows. Frame steps end at whole multiples of 1/60 s from the start, not of a rounded frame
+static void testStepTiming() {
+    const std::vector<uint32_t> steps = {
+        step(GAMEPAD_MASK_B1, 500),
+        step(0, 300),
+        frameStep(GAMEPAD_MASK_B2 | DPAD(GAMEPAD_MASK_UP), 1),
+        frameStep(GAMEPAD_MASK_B3, 1),
+        frameStep(GAMEPAD_MASK_B4, 1),
+    };
+    const std::vector<uint64_t> ends = { 5000, 8000, 8000 + 16666, 8000 + 33333, 8000 + 50000 };
+    fixture.setup(GAMEPAD_MASK_S1 | GAMEPAD_MASK_S2, -1, false, steps);
+
+    const uint64_t start = time_us_64();
+    for (uint64_t offset = 0; offset < 70000; offset++) {
+        const uint32_t output = fixture.poll(PIN(BUTTON_S1) | PIN(BUTTON_S2), 1);
+        // The held trigger combination never reaches the output
+        CHECK_EQ(output, expectedInput(steps, ends, offset + GAMEPAD_POLL_MICRO / 2));
+    }
+    CHECK_EQ(time_us_64() - start, 70000);
+
+    // Buttons outside the trigger pass through, and the program does not start again while held
+    CHECK_EQ(fixture.poll(PIN(BUTTON_S1) | PIN(BUTTON_S2) | PIN(BUTTON_L1), 1), GAMEPAD_MASK_L1);
+    CHECK_EQ(fixture.poll(PIN(BUTTON_S1), 1), GAMEPAD_MASK_S1);
+}
+
+// Repeats start at the end of the last step, not at the poll that noticed it, and a release lets
+// the running pass finish
+static void testRepeatWhileHeld() {
+    const std::vector<uint32_t> steps = { step(GAMEPAD_MASK_B1, 200), step(0, 200) };
+    const uint32_t period = 4000;
+    fixture.setup(0, PIN_MACRO, true, steps);
+
+    uint32_t presses = 0;
+    bool last = false;
+    for (uint64_t offset = 0; offset < 21000; offset += GAMEPAD_POLL_MICRO) {
+        const uint32_t output = fixture.poll(PIN(MACRO), GAMEPAD_POLL_MICRO);
+        const bool pressed = (offset + GAMEPAD_POLL_MICRO / 2) % period < period / 2;
+        CHECK_EQ(output, pressed ? GAMEPAD_MASK_B1 : 0);
+        presses += (pressed && !last) ? 1 : 0;
+        last = pressed;
+    }
+    CHECK_EQ(presses, 6);
+
+    // Released during the sixth pass, which started at 20 ms
+    for (uint64_t offset = 21000; offset < 40000; offset += GAMEPAD_POLL_MICRO) {
+        const uint32_t output = fixture.poll(0, GAMEPAD_POLL_MICRO);
+        CHECK_EQ(output, (offset + GAMEPAD_POLL_MICRO / 2 < 22000) ? GAMEPAD_MASK_B1 : 0);
+    }
+
+    // Without repeat one pass plays however long the trigger stays down
+    fixture.setup(0, PIN_MACRO, false, steps);
+    presses = 0;
+    last = false;
+    for (uint32_t i = 0; i < 200; i++) {
+        const bool pressed = fixture.poll(PIN(MACRO), GAMEPAD_POLL_MICRO) != 0;
+        presses += (pressed && !last) ? 1 : 0;
+        last = pressed;
+    }
+    CHECK_EQ(presses, 1);
+    fixture.poll(0, GAMEPAD_POLL_MICRO);
+    CHECK_EQ(fixture.poll(PIN(MACRO), GAMEPAD_POLL_MICRO), GAMEPAD_MASK_B1);
+}
+
+// Steps shorter than a poll are skipped over, several in one poll
+static void testShortStepsSkipAhead() {
+    std::vector<uint32_t> steps;
+    std::vector<uint64_t> ends;
+    for (uint32_t i = 0; i < 16; i++) {
+        steps.push_back(step(1U << i, 1));
+        ends.push_back((i + 1) * MACRO_STEP_UNIT_MICROS);
+    }
+    fixture.setup(0, PIN_MACRO, false, steps);
+
+    for (uint64_t offset = 0; offset < 1000; offset += GAMEPAD_POLL_MICRO) {
+        CHECK_EQ(fixture.poll(PIN(MACRO), GAMEPAD_POLL_MICRO), expectedInput(steps, ends, offset + GAMEPAD_POLL_MICRO / 2));
+    }
+}
+
+// A program that takes no time at all would loop forever while its trigger is held, every step is
+// visited at most once per poll instead
+static void testStepsPerPollAreBounded() {
+    const std::vector<uint32_t> steps = {
+        step(GAMEPAD_MASK_B1, 0), step(GAMEPAD_MASK_B2, 0), step(GAMEPAD_MASK_B3, 0), step(GAMEPAD_MASK_B4, 0),
+    };
+    fixture.setup(0, PIN_MACRO, true, steps);
+
+    for (uint32_t i = 0; i < 100; i++) {
+        // Once through the program and back to the first step, the poll it started in included
+        CHECK_EQ(fixture.poll(PIN(MACRO), GAMEPAD_POLL_MICRO), GAMEPAD_MASK_B1);
+    }
+    // The pass that is playing ends in the poll that sees the release
+    CHECK_EQ(fixture.poll(0, GAMEPAD_POLL_MICRO), 0);
+    CHECK_EQ(fixture.poll(0, GAMEPAD_POLL_MICRO), 0);
+}
+
+int main() {
+    RUN_TEST(testStepTiming);
+    RUN_TEST(testRepeatWhileHeld);
+    RUN_TEST(testShortStepsSkipAhead);
+    RUN_TEST(testStepsPerPollAreBounded);
+    return 0;
+}
@@ -0,0 +1,401 @@
+#include "testing.h"
+#include "hoststub.h"
+#include "gamepadfixture.h"
+#include "inputreplay.h"
+
+#include "addons/analog.h"
+#include "addons/dualdirectional.h"
+
+#include <math.h>
+
+// Replays input recordings through Gamepad and the input add-ons as GP2040::run() does, and checks
+// the SOCD modes and 4-way mode against what they are meant to do
+
+#define DEBOUNCE_MILLIS 5
+// The recordings change an input at most every 8 ms, the output has settled this long after a change
+#define SETTLE_MICROS ((DEBOUNCE_MILLIS + 1) * 1000)
+
+#define PIN_DUAL_UP 0
+#define PIN_DUAL_DOWN 1
+#define PIN_DUAL_LEFT 14
+#define PIN_DUAL_RIGHT 15
+
+static const SOCDMode socdModes[] = {
+    SOCD_MODE_UP_PRIORITY,
+    SOCD_MODE_NEUTRAL,
+    SOCD_MODE_SECOND_INPUT_PRIORITY,
+    SOCD_MODE_FIRST_INPUT_PRIORITY,
+    SOCD_MODE_BYPASS,
+};
+
+static uint8_t dpadFromPins(uint32_t pins, uint8_t up, uint8_t down, uint8_t left, uint8_t right) {
+    return ((pins & (1U << up)) ? GAMEPAD_MASK_UP : 0)
+        | ((pins & (1U << down)) ? GAMEPAD_MASK_DOWN : 0)
+        | ((pins & (1U << left)) ? GAMEPAD_MASK_LEFT : 0)
+        | ((pins & (1U << right)) ? GAMEPAD_MASK_RIGHT : 0);
+}
+
+static uint8_t boardDpad(uint32_t pins) {
+    return dpadFromPins(pins, PIN_DPAD_UP, PIN_DPAD_DOWN, PIN_DPAD_LEFT, PIN_DPAD_RIGHT);
+}
+
+static uint8_t dualDpad(uint32_t pins) {
+    return dpadFromPins(pins, PIN_DUAL_UP, PIN_DUAL_DOWN, PIN_DUAL_LEFT, PIN_DUAL_RIGHT);
+}
+
+static bool isDiagonal(uint8_t dpad) {
+    return (dpad & (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN)) && (dpad & (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT));
+}
+
+static bool hasOpposing(uint8_t dpad) {
+    return (dpad & (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN)) == (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN) ||
+        (dpad & (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT)) == (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT);
+}
+
+static uint8_t bitIndex(uint8_t mask) {
+    return __builtin_ctz(mask);
+}
+
+// The SOCD modes as documented, from the order the directions went down instead of the cleaner's
+// state. 4-way mode keeps whichever direction of a diagonal showed up last
+class SocdReference {
+public:
+    SocdReference(SOCDMode mode, bool fourWay) : mode(mode), fourWay(fourWay) {}
+
+    uint8_t clean(uint8_t dpad) {
+        poll++;
+        track(dpad, lastInput, pressedPoll);
+        lastInput = dpad;
+
+        uint8_t out = dpad;
+        if (mode != SOCD_MODE_BYPASS) {
+            out = axis(dpad, GAMEPAD_MASK_UP, GAMEPAD_MASK_DOWN) | axis(dpad, GAMEPAD_MASK_LEFT, GAMEPAD_MASK_RIGHT);
+        }
+        track(out, lastClean, shownPoll);
+        lastClean = out;
+
+        // Bypass can hand opposing directions to 4-way mode, which of them survives is not defined
+        ambiguous = fourWay && hasOpposing(out);
+        if (fourWay && isDiagonal(out) && !ambiguous) {
+            const uint8_t vertical = out & (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN);
+            const uint8_t horizontal = out & (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT);
+            const uint64_t verticalPoll = shownPoll[bitIndex(vertical)];
+            const uint64_t horizontalPoll = shownPoll[bitIndex(horizontal)];
+            ambiguous = verticalPoll == horizontalPoll;
+            out = (verticalPoll > horizontalPoll) ? vertical : horizontal;
+        }
+        return out;
+    }
+
+    // Set when both directions of a diagonal showed up in the same poll, 4-way mode then keeps
+    // the one it saw last before that, or when opposing directions reach 4-way mode
+    bool ambiguous = false;
+
+private:
+    void track(uint8_t dpad, uint8_t last, uint64_t * polls) {
+        for (uint8_t i = 0; i < 4; i++) {
+            if ((dpad & (1 << i)) && !(last & (1 << i))) {
+                polls[i] = poll;
+            }
+        }
+    }
+
+    uint8_t axis(uint8_t dpad, uint8_t first, uint8_t second) {
+        if ((dpad & (first | second)) != (first | second)) {
+            return dpad & (first | second);
+        }
+        const uint64_t firstPoll = pressedPoll[bitIndex(first)];
+        const uint64_t secondPoll = pressedPoll[bitIndex(second)];
+        switch (mode) {
+            case SOCD_MODE_UP_PRIORITY:
+                return first & GAMEPAD_MASK_UP;
+            case SOCD_MODE_SECOND_INPUT_PRIORITY:
+                return (firstPoll == secondPoll) ? 0 : (firstPoll > secondPoll) ? first : second;
+            case SOCD_MODE_FIRST_INPUT_PRIORITY:
+                return (firstPoll == secondPoll) ? 0 : (firstPoll < secondPoll) ? first : second;
+            default:
+                return 0;
+        }
+    }
+
+    SOCDMode mode;
+    bool fourWay;
+    uint64_t poll = 0;
+    uint8_t lastInput = 0;
+    uint8_t lastClean = 0;
+    uint64_t pressedPoll[4] = { };
+    uint64_t shownPoll[4] = { };
+};
+
+static InputRecords loadTrace(const char * name) {
+    InputRecords records;
+    const std::string path = std::string(INPUT_TRACE_DIR) + "/" + name;
+    if (!loadInputRecording(path.c_str(), records)) {
+        printf("cannot load %s\n", path.c_str());
+        CHECK(false);
+    }
+    return records;
+}
+
+struct ReplayFixture
+{
+    Gamepad gamepad { DEBOUNCE_MILLIS };
+    DualDirectionalInput dualDirectional;
+    AnalogInput analog;
+
+    GamepadOptions & setup() {
+        HostStub::reset();
+        Storage & storage = Storage::getInstance();
+        mapBoardPins(storage.getPinMappings());
+        storage.SetGamepad(&gamepad);
+        return storage.getGamepadOptions();
+    }
+
+    DualDirectionalOptions & setupDualDirectional() {
+        DualDirectionalOptions & options = Storage::getInstance().getAddonOptions().dualDirectionalOptions;
+        options.enabled = true;
+        options.upPin = PIN_DUAL_UP;
+        options.downPin = PIN_DUAL_DOWN;
+        options.leftPin = PIN_DUAL_LEFT;
+        options.rightPin = PIN_DUAL_RIGHT;
+        options.dpadMode = DPAD_MODE_DIGITAL;
+        return options;
+    }
+
+    // Stick 1 on the left stick, EMA filtered so the output depends on the poll timing too
+    void setupAnalog() {
+        AnalogOptions & options = Storage::getInstance().getAddonOptions().analogOptions;
+        options.enabled = true;
+        options.analogAdc1PinX = 26;
+        options.analogAdc1PinY = 27;
+        options.analogAdc2PinX = -1;
+        options.analogAdc2PinY = -1;
+        options.analogAdc1Mode = DPAD_MODE_LEFT_ANALOG;
+        options.analogAdc2Mode = DPAD_MODE_DIGITAL;
+        options.analogAdc1Filter = ANALOG_FILTER_EMA;
+        options.analogFilterEmaAlpha = 25;
+    }
+};
+
+// Replays a recording under one configuration, check() sees the dpad of every poll and is told
+// whether the output has had time to settle since the last change of the input
+typedef std::function<void(const InputRecorder::Record &, uint8_t, bool)> DpadCheck;
+
+static uint32_t replayDpad(ReplayFixture & fixture, const InputRecords & records, std::vector<GPAddon *> addons,
+        const DpadCheck & check) {
+    fixture.gamepad.setup();
+    for (GPAddon * addon : addons) {
+        addon->setup();
+    }
+
+    uint32_t checked = 0;
+    uint64_t changedMicros = 0;
+    uint32_t lastPins = 0;
+    InputReplay replay(fixture.gamepad, addons);
+    replay.run(records, [&](const InputRecorder::Record & record) {
+        const uint64_t now = time_us_64();
+        if (record.pins != lastPins) {
+            lastPins = record.pins;
+            changedMicros = now;
+        }
+        const bool settled = now - changedMicros >= SETTLE_MICROS;
+        check(record, fixture.gamepad.state.dpad, settled);
+        checked += settled ? 1 : 0;
+    });
+    return checked;
+}
+
+static void testLoadRejectsOtherLayouts() {
+    InputRecords records;
+    CHECK(!loadInputRecording(INPUT_TRACE_DIR "/missing.json", records));
+
+    const char * path = "test_replay_layout.json";
+    FILE * file = fopen(path, "w");
+    fputs("{\"valid\":1,\"count\":1,\"recordSize\":20,\"records\":\"QEIPAAAAAAAAgACAAIAAgAAAAAA=\"}", file);
+    fclose(file);
+    CHECK(!loadInputRecording(path, records));
+    remove(path);
+}
+
+// What the recorder keeps is enough to reproduce the output of every poll, analog included
+static void testRecordingReplaysIdentically() {
+    static ReplayFixture device;
+    GamepadOptions & options = device.setup();
+    options.socdMode = SOCD_MODE_SECOND_INPUT_PRIORITY;
+    device.setupAnalog();
+    HostStub::setTime(1000000);
+    device.gamepad.setup();
+    device.analog.setup();
+    InputRecorder::setup(true);
+
+    // Random presses on the dpad and two buttons, the stick circling in steps of a few polls
+    const uint8_t inputs[] = { PIN_DPAD_UP, PIN_DPAD_DOWN, PIN_DPAD_LEFT, PIN_DPAD_RIGHT, PIN_BUTTON_B1, PIN_BUTTON_B2 };
+    InputReplay live(device.gamepad, { &device.analog });
+    std::vector<GamepadState> states;
+    uint32_t seed = 3;
+    InputRecorder::Record input = { };
+    for (uint32_t poll = 0; poll < 800; poll++) {
+        seed = seed * 1664525 + 1013904223;
+        if (poll > 20 && (seed >> 24) < 16) {
+            input.pins ^= 1U << inputs[(seed >> 8) % sizeof(inputs)];
+        }
+        if (poll % 8 == 0) {
+            input.adc[0] = 2048 + static_cast<int>(1800 * cosf(poll / 100.0f));
+            input.adc[1] = 2048 + static_cast<int>(1800 * sinf(poll / 100.0f));
+        }
+        const uint64_t now = 1000000 + poll * INPUT_REPLAY_POLL_MICROS;
+        live.poll(input, now);
+        // Same pins and readings as right after the read, nothing above changes them
+        InputRecorder::record(&device.gamepad, static_cast<uint32_t>(now));
+        states.push_back(device.gamepad.state);
+    }
+
+    const InputRecorder::Recording * recording = InputRecorder::getRecording();
+    CHECK(recording != nullptr);
+    CHECK(recording->count < INPUT_RECORDER_RECORDS);
+    CHECK_EQ(recording->records[0].adc[2], 0);
+    const InputRecords records(recording->records, recording->records + recording->count);
+
+    static ReplayFixture fixture;
+    fixture.setup().socdMode = SOCD_MODE_SECOND_INPUT_PRIORITY;
+    fixture.setupAnalog();
+    HostStub::setTime(1000000);
+    fixture.gamepad.setup();
+    fixture.analog.setup();
+    size_t poll = 0;
+    InputReplay replay(fixture.gamepad, { &fixture.analog });
+    replay.run(records, [&](const InputRecorder::Record &) {
+        CHECK(poll < states.size());
+        CHECK_EQ(fixture.gamepad.state.dpad, states[poll].dpad);
+        CHECK_EQ(fixture.gamepad.state.buttons, states[poll].buttons);
+        CHECK_EQ(fixture.gamepad.state.lx, states[poll].lx);
+        CHECK_EQ(fixture.gamepad.state.ly, states[poll].ly);
+        poll++;
+    });
+    // Up to the poll of the last record, the polls after it did not change anything
+    CHECK_EQ(poll, (records.back().timeMicros - records.front().timeMicros) / INPUT_REPLAY_POLL_MICROS + 1);
+    InputRecorder::setup(false);
+}
+
+static void testSocdModes() {
+    const InputRecords records = loadTrace("socd_dpad.json");
+    for (SOCDMode mode : socdModes) {
+        for (bool fourWay : { false, true }) {
+            static ReplayFixture fixture;
+            GamepadOptions & options = fixture.setup();
+            options.socdMode = mode;
+            options.fourWayMode = fourWay;
+
+            SocdReference reference(mode, fourWay);
+            uint32_t diagonals = 0;
+            const uint32_t checked = replayDpad(fixture, records, { }, [&](const InputRecorder::Record & record, uint8_t dpad, bool settled) {
+                const uint8_t expected = reference.clean(boardDpad(record.pins));
+                if (fourWay) {
+                    CHECK(!isDiagonal(dpad));
+                    diagonals += isDiagonal(boardDpad(record.pins)) ? 1 : 0;
+                }
+                if (settled && !reference.ambiguous) {
+                    CHECK_EQ(dpad, expected);
+                }
+            });
+            printf("mode %d%s: %u polls\n", mode, fourWay ? " 4-way" : "", checked);
+            CHECK(checked > 5000);
+            CHECK(!fourWay || diagonals > 1000);
+        }
+    }
+}
+
+// Up priority and neutral need no history, opposing directions are simply resolved
+static uint8_t cleanWithoutHistory(SOCDMode mode, uint8_t dpad) {
+    if ((dpad & (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN)) == (GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN)) {
+        dpad &= (mode == SOCD_MODE_UP_PRIORITY) ? ~GAMEPAD_MASK_DOWN : ~(GAMEPAD_MASK_UP | GAMEPAD_MASK_DOWN);
+    }
+    if ((dpad & (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT)) == (GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT)) {
+        dpad &= ~(GAMEPAD_MASK_LEFT | GAMEPAD_MASK_RIGHT);
+    }
+    return dpad;
+}
+
+// Mixed mode cleans each set of directions on its own, then the merged result once more
+static void testDualDirectionalMixed() {
+    const InputRecords records = loadTrace("dual_directional.json");
+    for (SOCDMode mode : socdModes) {
+        static ReplayFixture fixture;
+        fixture.setup().socdMode = mode;
+        fixture.setupDualDirectional().combineMode = DUAL_COMBINE_MODE_MIXED;
+
+        uint32_t opposing = 0;
+        replayDpad(fixture, records, { &fixture.dualDirectional }, [&](const InputRecorder::Record & record, uint8_t dpad, bool settled) {
+            const uint8_t board = boardDpad(record.pins);
+            const uint8_t dual = dualDpad(record.pins);
+            const uint8_t held = board | dual;
+            if (mode != SOCD_MODE_BYPASS) {
+                CHECK(!hasOpposing(dpad));
+            }
+            if (!settled) {
+                return;
+            }
+            opposing += hasOpposing(held) ? 1 : 0;
+            if (mode == SOCD_MODE_BYPASS) {
+                CHECK_EQ(dpad, held);
+            } else if (mode == SOCD_MODE_UP_PRIORITY || mode == SOCD_MODE_NEUTRAL) {
+                CHECK_EQ(dpad, cleanWithoutHistory(mode, cleanWithoutHistory(mode, board) | cleanWithoutHistory(mode, dual)));
+            } else {
+                // Last and first input priority run on each set before they merge, the press order
+                // across both sets is not kept
+                CHECK_EQ(dpad & ~held, 0);
+                if (!hasOpposing(held)) {
+                    CHECK_EQ(dpad, held);
+                }
+            }
+        });
+        CHECK(opposing > 1000);
+    }
+}
+
+// Dual mode uses the second set of directions whenever one is held, cleaned like the dpad
+static void testDualDirectionalOverride() {
+    const InputRecords records = loadTrace("dual_directional.json");
+    for (SOCDMode mode : socdModes) {
+        static ReplayFixture fixture;
+        fixture.setup().socdMode = mode;
+        fixture.setupDualDirectional().combineMode = DUAL_COMBINE_MODE_DUAL;
+
+        SocdReference reference(mode, false);
+        replayDpad(fixture, records, { &fixture.dualDirectional }, [&](const InputRecorder::Record & record, uint8_t dpad, bool settled) {
+            const uint8_t dual = dualDpad(record.pins);
+            const uint8_t expected = reference.clean(dual != 0 ? dual : boardDpad(record.pins));
+            if (settled) {
+                CHECK_EQ(dpad, expected);
+            }
+        });
+    }
+}
+
+// The add-on's own 4-way option, gamepad mode hands the held directions of either set to it
+static void testDualDirectionalFourWay() {
+    const InputRecords records = loadTrace("dual_directional.json");
+    static ReplayFixture fixture;
+    fixture.setup().socdMode = SOCD_MODE_NEUTRAL;
+    DualDirectionalOptions & options = fixture.setupDualDirectional();
+    options.combineMode = DUAL_COMBINE_MODE_GAMEPAD;
+    options.fourWayMode = true;
+
+    replayDpad(fixture, records, { &fixture.dualDirectional }, [&](const InputRecorder::Record & record, uint8_t dpad, bool settled) {
+        const uint8_t board = boardDpad(record.pins);
+        CHECK(!isDiagonal(dpad));
+        if (settled) {
+            CHECK_EQ(dpad & ~(board != 0 ? board : dualDpad(record.pins)), 0);
+        }
+    });
+}
+
+int main() {
+    RUN_TEST(testLoadRejectsOtherLayouts);
+    RUN_TEST(testRecordingReplaysIdentically);
+    RUN_TEST(testSocdModes);
+    RUN_TEST(testDualDirectionalMixed);
+    RUN_TEST(testDualDirectionalOverride);
+    RUN_TEST(testDualDirectionalFourWay);
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include "testing.h"
+
+#include "triplebuffer.h"
+
+#include <atomic>
+#include <thread>
+
+// Large enough that a copy takes long compared to a write, so the two overlap all the time
+#define PAYLOAD_WORDS 256
+#define STRESS_WRITES 2000000
+
+struct Payload
+{
+    uint32_t words[PAYLOAD_WORDS];
+};
+
+static void fill(Payload & payload, uint32_t value) {
+    for (uint32_t & word : payload.words) {
+        word = value;
+    }
+}
+
+static void testNothingPublished() {
+    TripleBuffer<Payload> buffer;
+    Payload payload;
+    CHECK_EQ(buffer.read(payload), 0);
+
+    fill(payload, 7);
+    buffer.write(payload);
+    fill(payload, 0);
+    CHECK_EQ(buffer.read(payload), 1);
+    CHECK_EQ(payload.words[0], 7);
+    CHECK_EQ(payload.words[PAYLOAD_WORDS - 1], 7);
+}
+
+static void testLatestWins() {
+    TripleBuffer<Payload> buffer;
+    Payload payload;
+    for (uint32_t i = 1; i <= 5; i++) {
+        fill(payload, i * 10);
+        buffer.write(payload);
+    }
+    CHECK_EQ(buffer.read(payload), 5);
+    CHECK_EQ(payload.words[0], 50);
+}
+
+// One producer and one consumer on their own threads, like core0 and core1. Every payload holds
+// its sequence number in every word, a torn copy shows up as words that disagree
+static void testConcurrentReadsAreNeverTorn() {
+    static TripleBuffer<Payload> buffer;
+    std::atomic<bool> done(false);
+
+    std::thread producer([&]() {
+        Payload payload;
+        for (uint32_t sequence = 1; sequence <= STRESS_WRITES; sequence++) {
+            fill(payload, sequence);
+            buffer.write(payload);
+        }
+        done = true;
+    });
+
+    Payload payload;
+    uint32_t last = 0;
+    uint32_t reads = 0;
+    uint32_t torn = 0;
+    uint32_t backwards = 0;
+    for (;;) {
+        const bool finished = done;
+        const uint32_t sequence = buffer.read(payload);
+        reads++;
+        if (sequence < last) {
+            backwards++;
+        }
+        if (sequence != 0) {
+            for (uint32_t word : payload.words) {
+                if (word != sequence) {
+                    torn++;
+                    break;
+                }
+            }
+        }
+        last = sequence;
+        if (finished) {
+            break;
+        }
+    }
+    producer.join();
+
+    printf("%u reads, last sequence %u\n", reads, last);
+    CHECK_EQ(torn, 0);
+    CHECK_EQ(backwards, 0);
+    CHECK_EQ(last, STRESS_WRITES);
+}
+
+int main() {
+    RUN_TEST(testNothingPublished);
+    RUN_TEST(testLatestWins);
+    RUN_TEST(testConcurrentReadsAreNeverTorn);
+    return 0;
+}
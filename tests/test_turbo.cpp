@@ -0,0 +1,143 @@
+#include "testing.h"
+#include "hoststub.h"
+#include "gamepadfixture.h"
+
+#include "addons/turbo.h"
+
+// Drives TurboInput through whole polls, one millisecond apart, with the TURBO button on a spare pin
+
+#define PIN_TURBO 14
+#define TURBO_SHOT_COUNT 20
+
+#define PIN(name) (1U << PIN_##name)
+
+struct TurboFixture
+{
+    Gamepad gamepad;
+    TurboInput turbo;
+
+    void setup() {
+        HostStub::reset();
+        Storage & storage = Storage::getInstance();
+        mapBoardPins(storage.getPinMappings());
+        storage.SetGamepad(&gamepad);
+
+        TurboOptions & options = storage.getAddonOptions().turboOptions;
+        options.enabled = true;
+        options.buttonPin = PIN_TURBO;
+        options.ledPin = -1;
+        options.shmupDialPin = -1;
+        options.shmupModeEnabled = false;
+        options.shotCount = TURBO_SHOT_COUNT;
+
+        gamepad.setup();
+        turbo.setup();
+    }
+
+    void hold(uint32_t pins, uint32_t millis) {
+        for (uint32_t i = 0; i < millis; i++) {
+            HostStub::setGpio(~pins);
+            HostStub::advanceTime(1000);
+            gamepad.read();
+            turbo.process();
+        }
+    }
+
+    // Holds the button alone for a while, turbo shows as polls where it reads released
+    bool turboEnabled(uint32_t pin, uint16_t mask) {
+        uint32_t released = 0;
+        for (uint32_t i = 0; i < 200; i++) {
+            hold(pin, 1);
+            released += (gamepad.state.buttons & mask) ? 0 : 1;
+        }
+        hold(0, 20);
+        return released > 0;
+    }
+};
+
+static TurboFixture fixture;
+
+static const TurboOptions & turboOptions() {
+    return Storage::getInstance().getAddonOptions().turboOptions;
+}
+
+static void testTapTogglesOnRelease() {
+    fixture.setup();
+    CHECK(!fixture.turboEnabled(PIN(BUTTON_B1), GAMEPAD_MASK_B1));
+
+    fixture.hold(PIN(TURBO), 20);
+    fixture.hold(PIN(TURBO) | PIN(BUTTON_B1), 20);
+    CHECK_EQ(fixture.gamepad.state.buttons & GAMEPAD_MASK_B1, 0);
+    fixture.hold(PIN(TURBO), 20);
+    fixture.hold(0, 20);
+    CHECK(fixture.turboEnabled(PIN(BUTTON_B1), GAMEPAD_MASK_B1));
+    CHECK(!fixture.turboEnabled(PIN(BUTTON_B2), GAMEPAD_MASK_B2));
+
+    // A second button joining the chord toggles on its own
+    fixture.hold(PIN(TURBO), 20);
+    fixture.hold(PIN(TURBO) | PIN(BUTTON_B1), 20);
+    fixture.hold(PIN(TURBO) | PIN(BUTTON_B1) | PIN(BUTTON_B2), 20);
+    fixture.hold(PIN(TURBO), 20);
+    fixture.hold(0, 20);
+    CHECK(!fixture.turboEnabled(PIN(BUTTON_B1), GAMEPAD_MASK_B1));
+    CHECK(fixture.turboEnabled(PIN(BUTTON_B2), GAMEPAD_MASK_B2));
+}
+
+// TURBO released before the button still ends the chord
+static void testTurboReleasedFirst() {
+    fixture.setup();
+    fixture.hold(PIN(TURBO), 20);
+    fixture.hold(PIN(TURBO) | PIN(BUTTON_B3), 20);
+    fixture.hold(PIN(BUTTON_B3), 20);
+    fixture.hold(0, 20);
+    CHECK(fixture.turboEnabled(PIN(BUTTON_B3), GAMEPAD_MASK_B3));
+}
+
+// Changing a button's rate leaves its turbo as it was
+static void testRateChangeKeepsEnable() {
+    fixture.setup();
+    fixture.hold(PIN(TURBO), 20);
+    fixture.hold(PIN(TURBO) | PIN(BUTTON_B1), 20);
+    fixture.hold(PIN(TURBO) | PIN(BUTTON_B1) | PIN(DPAD_UP), 20);
+    fixture.hold(PIN(TURBO) | PIN(BUTTON_B1), 20);
+    fixture.hold(PIN(TURBO) | PIN(BUTTON_B1) | PIN(DPAD_UP), 20);
+    fixture.hold(PIN(TURBO) | PIN(BUTTON_B1), 20);
+    fixture.hold(PIN(TURBO), 20);
+    fixture.hold(0, 20);
+    CHECK_EQ(turboOptions().buttonShotCounts[0], TURBO_SHOT_COUNT + 2);
+    CHECK_EQ(turboOptions().shotCount, TURBO_SHOT_COUNT);
+    CHECK(!fixture.turboEnabled(PIN(BUTTON_B1), GAMEPAD_MASK_B1));
+
+    // Same with turbo already on, and with TURBO let go before the button
+    fixture.hold(PIN(TURBO), 20);
+    fixture.hold(PIN(TURBO) | PIN(BUTTON_B1), 20);
+    fixture.hold(PIN(TURBO), 20);
+    fixture.hold(0, 20);
+    CHECK(fixture.turboEnabled(PIN(BUTTON_B1), GAMEPAD_MASK_B1));
+    fixture.hold(PIN(TURBO), 20);
+    fixture.hold(PIN(TURBO) | PIN(BUTTON_B1), 20);
+    fixture.hold(PIN(TURBO) | PIN(BUTTON_B1) | PIN(DPAD_DOWN), 20);
+    fixture.hold(PIN(BUTTON_B1), 20);
+    fixture.hold(0, 20);
+    CHECK_EQ(turboOptions().buttonShotCounts[0], TURBO_SHOT_COUNT + 1);
+    CHECK(fixture.turboEnabled(PIN(BUTTON_B1), GAMEPAD_MASK_B1));
+}
+
+// Up/down with TURBO alone still moves the shared rate
+static void testSharedRateChange() {
+    fixture.setup();
+    fixture.hold(PIN(TURBO), 20);
+    fixture.hold(PIN(TURBO) | PIN(DPAD_DOWN), 20);
+    fixture.hold(PIN(TURBO), 20);
+    fixture.hold(0, 20);
+    CHECK_EQ(turboOptions().shotCount, TURBO_SHOT_COUNT - 1);
+    CHECK(!fixture.turboEnabled(PIN(BUTTON_B1), GAMEPAD_MASK_B1));
+}
+
+int main() {
+    RUN_TEST(testTapTogglesOnRelease);
+    RUN_TEST(testTurboReleasedFirst);
+    RUN_TEST(testRateChangeKeepsEnable);
+    RUN_TEST(testSharedRateChange);
+    return 0;
+}
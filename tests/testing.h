@@ -0,0 +1,34 @@
+#ifndef TESTING_H_
+#define TESTING_H_
+
+#include <cstdio>
+#include <cstdlib>
+
+// Minimal checks for the host tests, the first failure prints where it happened and exits non-zero
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            exit(1); \
+        } \
+    } while (0)
+
+#define CHECK_EQ(actual, expected) \
+    do { \
+        const long long actualValue = static_cast<long long>(actual); \
+        const long long expectedValue = static_cast<long long>(expected); \
+        if (actualValue != expectedValue) { \
+            fprintf(stderr, "%s:%d: CHECK_EQ(%s, %s) failed: %lld != %lld\n", __FILE__, __LINE__, \
+                #actual, #expected, actualValue, expectedValue); \
+            exit(1); \
+        } \
+    } while (0)
+
+#define RUN_TEST(test) \
+    do { \
+        test(); \
+        printf("%s passed\n", #test); \
+    } while (0)
+
+#endif
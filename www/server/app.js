@@ -91,6 +91,14 @@ app.get("/api/getGamepadOptions", (req, res) => {
 		forcedSetupMode: 0,
 		lockHotkeys: 0,
 		fourWayMode: 0,
+		usbFrameSync: 0,
+		pioSampler: 0,
+		debounceMode: 0,
+		debounceSamples: 4,
+		debounceLockoutMicros: 2000,
+		inputRecording: 0,
+		adcSampler: 0,
+		adcAverageSamples: 1,
 		fnButtonPin: -1,
 		hotkey01: {
 			auxMask: 32768,
@@ -151,7 +159,14 @@ app.get("/api/getGamepadOptions", (req, res) => {
 			auxMask: 0,
 			buttonsMask: 0,
 			action: 0
-		}
+		},
+		extraHotkeys: [
+			{
+				auxMask: 32768,
+				buttonsMask: 65536,
+				action: 13
+			}
+		]
 	});
 });
 
@@ -226,6 +241,20 @@ app.get("/api/getKeyMappings", (req, res) =>
 	res.send(mapValues(DEFAULT_KEYBOARD_MAPPING))
 );
 
+app.get("/api/getMacroOptions", (req, res) => {
+	return res.send({
+		macros: [
+			{
+				triggerMask: 4096,
+				triggerPin: -1,
+				repeatWhileHeld: 0,
+				// B3 for a frame, then B3 + B4 for a frame
+				steps: [0x80100004, 0x8010000c],
+			},
+		],
+	});
+});
+
 app.get("/api/getAddonsOptions", (req, res) => {
 	return res.send({
 		turboPin: -1,
@@ -235,6 +264,14 @@ app.get("/api/getAddonsOptions", (req, res) => {
 		sliderSOCDPinOne: -1,
 		sliderSOCDPinTwo: -1,
 		turboShotCount: 20,
+		turboShotCountB1: 0,
+		turboShotCountB2: 0,
+		turboShotCountB3: 0,
+		turboShotCountB4: 0,
+		turboShotCountL1: 0,
+		turboShotCountR1: 0,
+		turboShotCountL2: 0,
+		turboShotCountR2: 0,
 		reversePin: -1,
 		reversePinLED: -1,
 		reverseActionUp: 1,
@@ -246,6 +283,7 @@ app.get("/api/getAddonsOptions", (req, res) => {
 		i2cAnalog1219Block: 0,
 		i2cAnalog1219Speed: 400000,
 		i2cAnalog1219Address: 0x40,
+		i2cAnalog1219DRDYPin: -1,
 		onBoardLedMode: 0,
 		dualDirUpPin: -1,
 		dualDirDownPin: -1,
@@ -276,6 +314,25 @@ app.get("/api/getAddonsOptions", (req, res) => {
 		forced_circularity: 0,
 		analog_deadzone: 5,
 		auto_calibrate: 0,
+		radial_deadzone: 0,
+		analogAdc1XMin: 180,
+		analogAdc1XCenter: 2040,
+		analogAdc1XMax: 3920,
+		analogAdc1YMin: 160,
+		analogAdc1YCenter: 2056,
+		analogAdc1YMax: 3904,
+		analogAdc2XMin: 0,
+		analogAdc2XCenter: 0,
+		analogAdc2XMax: 0,
+		analogAdc2YMin: 0,
+		analogAdc2YCenter: 0,
+		analogAdc2YMax: 0,
+		analogAdc1Filter: 0,
+		analogAdc2Filter: 0,
+		analogFilterSamples: 4,
+		analogFilterEmaAlpha: 25,
+		analogFilterMinCutoff: 50,
+		analogFilterBeta: 5000,
 		bootselButtonMap: 0,
 		buzzerPin: -1,
 		buzzerVolume: 100,
@@ -317,6 +374,7 @@ app.get("/api/getAddonsOptions", (req, res) => {
 		AnalogInputEnabled: 1,
 		BoardLedAddonEnabled: 1,
 		FocusModeAddonEnabled: 1,
+		MacroInputEnabled: 1,
 		BuzzerSpeakerAddonEnabled: 1,
 		BootselButtonAddonEnabled: 1,
 		DualDirectionalInputEnabled: 1,
@@ -375,6 +433,72 @@ app.get("/api/getMemoryReport", (req, res) => {
 	});
 });
 
+// Made up for working on the UI, not a measurement
+app.get("/api/getFrameJitter", (req, res) => {
+	return res.send({
+		valid: 1,
+		usbFrameSync: 0,
+		frames: 60000,
+		staleFrames: 0,
+		minAge: 18,
+		maxAge: 131,
+		bucketMicros: 8,
+		buckets: [0, 0, 1210, 4873, 4920, 4889, 4951, 4862, 4930, 4875, 4901, 4968, 4890, 4911, 4902, 3918, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0],
+	});
+});
+
+app.get("/api/getLatencyStats", (req, res) => {
+	const stage = (min, avg, p99, max) => ({ min, avg, p99, max });
+	return res.send({
+		valid: 1,
+		polls: 120000,
+		clockHz: 125000000,
+		samples: 256,
+		stages: {
+			read: stage(312, 336, 384, 1208),
+			debounce: stage(1104, 1180, 1280, 2048),
+			hotkey: stage(704, 752, 896, 1424),
+			preprocessAddons: stage(96, 120, 128, 512),
+			process: stage(1608, 1736, 1920, 3256),
+			processAddons: stage(2480, 2952, 3456, 9872),
+			reportBuild: stage(1296, 1352, 1408, 2176),
+			sendReport: stage(808, 2416, 6912, 14768),
+			usbReport: stage(144, 168, 256, 640),
+			tudTask: stage(216, 832, 4224, 21360),
+			total: stage(8936, 10936, 15488, 30648),
+		},
+	});
+});
+
+app.get("/api/getAddonProfiles", (req, res) => {
+	return res.send({
+		valid: 1,
+		addons: [
+			{ name: "BootselButton", core: 0, preprocessCalls: 120000, preprocessAvg: 56, preprocessWorst: 120, processCalls: 120000, processAvg: 488, processWorst: 904, overruns: 0, deadlineMisses: 0 },
+			{ name: "WiiExtensionInput", core: 0, preprocessCalls: 120000, preprocessAvg: 48, preprocessWorst: 96, processCalls: 120000, processAvg: 612000, processWorst: 1834000, overruns: 0, deadlineMisses: 0 },
+			{ name: "I2CDisplay", core: 1, preprocessCalls: 0, preprocessAvg: 0, preprocessWorst: 0, processCalls: 118000, processAvg: 5120, processWorst: 23984000, overruns: 3, deadlineMisses: 1 },
+		],
+	});
+});
+
+app.get("/api/getInputRecording", (req, res) => {
+	return res.send({
+		valid: 1,
+		count: 2,
+		recordSize: 16,
+		records: "QEIPAAAAAAAACAAIAAAAAChGDwAEAAAAAwj+BwAAAAA=",
+	});
+});
+
+app.get("/api/getAnalogRawValues", (req, res) => {
+	return res.send({
+		analogAdc1X: 2048 + Math.round(Math.sin(Date.now() / 500) * 1900),
+		analogAdc1Y: 2048 + Math.round(Math.cos(Date.now() / 500) * 1900),
+		analogAdc2X: -1,
+		analogAdc2Y: -1,
+	});
+});
+
 app.post("/api/*", (req, res) => {
 	console.log(req.body);
 	return res.send(req.body);
@@ -21,11 +21,28 @@ export default {
 	'analog-force-circularity': 'Force Circularity',
 	'analog-deadzone-size': 'Deadzone Size (%)',
 	'analog-auto-calibrate': 'Auto Calibration',
+	'analog-radial-deadzone': 'Radial Deadzone',
+	'analog-adc-1-filter-label': 'Analog Stick 1 Filter',
+	'analog-adc-2-filter-label': 'Analog Stick 2 Filter',
+	'analog-filter-samples-label': 'Oversampling Samples',
+	'analog-filter-ema-alpha-label': 'Moving Average Weight (%)',
+	'analog-filter-min-cutoff-label': 'One-Euro Min Cutoff (0.1 Hz)',
+	'analog-filter-beta-label': 'One-Euro Beta (mHz per throw/s)',
+	'analog-calibration-text': 'Stored calibration (min / center / max). Save the stick pins first, start recording with the sticks at rest, move each stick around its full range, then stop and save. The calibration hotkey does the same while playing. A stored calibration replaces auto calibration.',
+	'analog-calibration-analogAdc1X-label': 'Analog Stick 1 X',
+	'analog-calibration-analogAdc1Y-label': 'Analog Stick 1 Y',
+	'analog-calibration-analogAdc2X-label': 'Analog Stick 2 X',
+	'analog-calibration-analogAdc2Y-label': 'Analog Stick 2 Y',
+	'analog-calibration-not-set': 'Not calibrated',
+	'analog-calibration-start': 'Start Calibration',
+	'analog-calibration-stop': 'Stop Calibration',
+	'analog-calibration-clear': 'Clear Calibration',
 	'turbo-header-text': 'Turbo',
 	'turbo-button-pin-label': 'Turbo Pin',
 	'turbo-led-pin-label': 'Turbo Pin LED',
 	'turbo-shmup-dial-pin-label': 'Turbo Dial (ADC ONLY)',
 	'turbo-shot-count-label': 'Turbo Shot Count',
+	'turbo-button-shot-count-label': '{{button}} Shot Count (0 = shared)',
 	'turbo-shmup-mode-label': 'SHMUP MODE',
 	'turbo-shmup-always-on-1-label': 'Turbo Always On 1',
 	'turbo-shmup-always-on-2-label': 'Turbo Always On 2',
@@ -59,6 +76,7 @@ export default {
 	'i2c-analog-ads1219-block-label': 'I2C Analog ADS1219 Block',
 	'i2c-analog-ads1219-speed-label': 'I2C Analog ADS1219 Speed',
 	'i2c-analog-ads1219-address-label': 'I2C Analog ADS1219 Address',
+	'i2c-analog-ads1219-drdy-pin-label': 'I2C Analog ADS1219 DRDY Pin',
 	'dual-directional-input-header-text': 'Dual Directional Input',
 	'dual-directional-input-up-pin-label': 'Dual Up Pin',
 	'dual-directional-input-down-pin-label': 'Dual Down Pin',
@@ -113,6 +131,8 @@ export default {
 	'snes-extension-data-pin-label': 'Data Pin',
 	'focus-mode-header-text': 'Focus Mode Configuration',
 	'focus-mode-pin-label': 'Focus Mode Pin',
+	'macro-header-text': 'Macro Configuration',
+	'macro-sub-header-text': 'Macro programs cannot be edited on this page yet. They are written by posting them to /api/setMacroOptions or by restoring a backup with the Macros entry of the Backup and Restore page, see Macro in proto/config.proto for the step format. Each step holds its inputs for a duration in 10us units or in frames.',
 	'keyboard-host-header-text': 'Keyboard Host Configuration',
 	'keyboard-host-sub-header-text': 'Following set the data + and - pins. Only the + pin can be configured.',
 	'keyboard-host-d-plus-label': 'D+',
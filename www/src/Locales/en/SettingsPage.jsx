@@ -43,6 +43,7 @@ export default {
 		'invert-y': 'Invert Y Axis',
 		'toggle-4way-joystick-mode': 'Toggle 4-Way Joystick Mode',
 		'toggle-ddi-4way-joystick-mode': 'Toggle DDI 4-Way Joystick Mode',
+		'analog-calibration': 'Start/Stop Analog Calibration',
 	},
 	'forced-setup-mode-label': 'Forced Setup Mode',
 	'forced-setup-mode-options': {
@@ -54,5 +55,18 @@ export default {
 	'forced-setup-mode-modal-title': 'Forced Setup Mode Warning',
 	'forced-setup-mode-modal-body': 'If you reboot to Controller mode after saving, you will no longer have access to the web-config. Please type "<strong>{{warningCheckText}}</strong>" below to unlock the Save button if you fully acknowledge this and intend it. Clicking on Dismiss will revert this setting which then is to be saved.',
 	'4-way-joystick-mode-label': '4-Way Joystick Mode',
+	'debounce-mode-label': 'Debounce Mode',
+	'debounce-mode-options': {
+		'timed': 'Timed (5ms)',
+		'integrator': 'Sample Integrator',
+		'eager': 'Eager (Lockout)'
+	},
+	'debounce-samples-label': 'Consecutive polls before a change is accepted',
+	'debounce-lockout-label': 'Lockout after a change (microseconds)',
+	'usb-frame-sync-label': 'Sync Polling to USB Frames',
+	'pio-sampler-label': 'Timestamp Inputs with PIO',
+	'input-recording-label': 'Record Inputs (download from /api/getInputRecording)',
+	'adc-sampler-label': 'Free-running ADC Sampling',
+	'adc-average-samples-label': 'Newest samples averaged per analog input',
 	'lock-hotkeys-label': 'Lock Hotkeys',
 };
@@ -63,6 +63,13 @@ const INVERT_MODES = [
 	{ label: 'X/Y Axis', value: 3 }
 ];
 
+const ANALOG_FILTERS = [
+	{ label: 'None', value: 0 },
+	{ label: 'Oversampling', value: 1 },
+	{ label: 'Moving Average', value: 2 },
+	{ label: 'One-Euro', value: 3 }
+];
+
 const ANALOG_PINS = [ 26,27,28,29 ];
 
 const BUTTON_MASKS = [
@@ -101,6 +108,8 @@ const TURBO_MASKS = [
 	{ label: 'R3',    value:  (1 << 11)  }
 ]
 
+const TURBO_SHOT_COUNT_BUTTONS = ['B1', 'B2', 'B3', 'B4', 'L1', 'R1', 'L2', 'R2'];
+
 const REVERSE_ACTION = [
 	{ label: 'Disable', value: 0 },
 	{ label: 'Enable', value: 1 },
@@ -237,6 +246,7 @@ const schema = yup.object().shape({
 	i2cAnalog1219Block:          yup.number().label('I2C Analog1219 Block').validateSelectionWhenValue('I2CAnalog1219InputEnabled', I2C_BLOCKS),
 	i2cAnalog1219Speed:          yup.number().label('I2C Analog1219 Speed').validateNumberWhenValue('I2CAnalog1219InputEnabled'),
 	i2cAnalog1219Address:        yup.number().label('I2C Analog1219 Address').validateNumberWhenValue('I2CAnalog1219InputEnabled'),
+	i2cAnalog1219DRDYPin:        yup.number().label('I2C Analog1219 DRDY Pin').validatePinWhenValue('I2CAnalog1219InputEnabled'),
 
 	AnalogInputEnabled:          yup.number().required().label('Analog Input Enabled'),
 	analogAdc1PinX:              yup.number().label('Analog Stick 1 Pin X').validatePinWhenValue('AnalogInputEnabled'),
@@ -251,6 +261,25 @@ const schema = yup.object().shape({
 	forced_circularity:          yup.number().label('Force Circularity').validateRangeWhenValue('AnalogInputEnabled', 0, 1),
 	analog_deadzone:             yup.number().label('Deadzone Size (%)').validateRangeWhenValue('AnalogInputEnabled', 0, 100),
 	auto_calibrate:              yup.number().label('Auto Calibration').validateRangeWhenValue('AnalogInputEnabled', 0, 1),
+	radial_deadzone:             yup.number().label('Radial Deadzone').validateRangeWhenValue('AnalogInputEnabled', 0, 1),
+	analogAdc1XMin:              yup.number().label('Analog Stick 1 X Min').validateRangeWhenValue('AnalogInputEnabled', 0, 4095),
+	analogAdc1XCenter:           yup.number().label('Analog Stick 1 X Center').validateRangeWhenValue('AnalogInputEnabled', 0, 4095),
+	analogAdc1XMax:              yup.number().label('Analog Stick 1 X Max').validateRangeWhenValue('AnalogInputEnabled', 0, 4095),
+	analogAdc1YMin:              yup.number().label('Analog Stick 1 Y Min').validateRangeWhenValue('AnalogInputEnabled', 0, 4095),
+	analogAdc1YCenter:           yup.number().label('Analog Stick 1 Y Center').validateRangeWhenValue('AnalogInputEnabled', 0, 4095),
+	analogAdc1YMax:              yup.number().label('Analog Stick 1 Y Max').validateRangeWhenValue('AnalogInputEnabled', 0, 4095),
+	analogAdc2XMin:              yup.number().label('Analog Stick 2 X Min').validateRangeWhenValue('AnalogInputEnabled', 0, 4095),
+	analogAdc2XCenter:           yup.number().label('Analog Stick 2 X Center').validateRangeWhenValue('AnalogInputEnabled', 0, 4095),
+	analogAdc2XMax:              yup.number().label('Analog Stick 2 X Max').validateRangeWhenValue('AnalogInputEnabled', 0, 4095),
+	analogAdc2YMin:              yup.number().label('Analog Stick 2 Y Min').validateRangeWhenValue('AnalogInputEnabled', 0, 4095),
+	analogAdc2YCenter:           yup.number().label('Analog Stick 2 Y Center').validateRangeWhenValue('AnalogInputEnabled', 0, 4095),
+	analogAdc2YMax:              yup.number().label('Analog Stick 2 Y Max').validateRangeWhenValue('AnalogInputEnabled', 0, 4095),
+	analogAdc1Filter:            yup.number().label('Analog Stick 1 Filter').validateSelectionWhenValue('AnalogInputEnabled', ANALOG_FILTERS),
+	analogAdc2Filter:            yup.number().label('Analog Stick 2 Filter').validateSelectionWhenValue('AnalogInputEnabled', ANALOG_FILTERS),
+	analogFilterSamples:         yup.number().label('Oversampling Samples').validateRangeWhenValue('AnalogInputEnabled', 1, 8),
+	analogFilterEmaAlpha:        yup.number().label('Moving Average Weight (%)').validateRangeWhenValue('AnalogInputEnabled', 1, 100),
+	analogFilterMinCutoff:       yup.number().label('One-Euro Min Cutoff (0.1 Hz)').validateRangeWhenValue('AnalogInputEnabled', 1, 10000),
+	analogFilterBeta:            yup.number().label('One-Euro Beta').validateRangeWhenValue('AnalogInputEnabled', 0, 100000),
 
 	BoardLedAddonEnabled:        yup.number().required().label('Board LED Add-On Enabled'),
 	onBoardLedMode:              yup.number().label('On-Board LED Mode').validateSelectionWhenValue('BoardLedAddonEnabled', ON_BOARD_LED_MODES),
@@ -264,6 +293,7 @@ const schema = yup.object().shape({
 	focusModeOledLockEnabled:    yup.number().label('Focus Mode OLED Lock Enabled').validateRangeWhenValue('FocusModeAddonEnabled', 0, 1),
 	focusModeRgbLockEnabled:     yup.number().label('Focus Mode RGB Lock Enabled').validateRangeWhenValue('FocusModeAddonEnabled', 0, 1),
 	focusModeButtonLockMask:      yup.number().label('Focus Mode Button Lock Map').validateRangeWhenValue('FocusModeAddonEnabled', 0, (1<<20) - 1),
+	MacroInputEnabled:           yup.number().required().label('Macro Input Enabled'),
 
 	BuzzerSpeakerAddonEnabled:   yup.number().required().label('Buzzer Speaker Add-On Enabled'),
 	buzzerPin:                   yup.number().label('Buzzer Pin').validatePinWhenValue('BuzzerSpeakerAddonEnabled'),
@@ -327,6 +357,14 @@ const schema = yup.object().shape({
 	pinShmupBtn4:                yup.number().label('Charge Shot 4 Pin').validatePinWhenValue('TurboInputEnabled'),
 	pinShmupDial:                yup.number().label('Shmup Dial Pin').validatePinWhenValue('TurboInputEnabled'),
 	turboShotCount:              yup.number().label('Turbo Shot Count').validateRangeWhenValue('TurboInputEnabled', 5, 30),
+	turboShotCountB1:            yup.number().label('Turbo Shot Count B1').validateRangeWhenValue('TurboInputEnabled', 0, 30),
+	turboShotCountB2:            yup.number().label('Turbo Shot Count B2').validateRangeWhenValue('TurboInputEnabled', 0, 30),
+	turboShotCountB3:            yup.number().label('Turbo Shot Count B3').validateRangeWhenValue('TurboInputEnabled', 0, 30),
+	turboShotCountB4:            yup.number().label('Turbo Shot Count B4').validateRangeWhenValue('TurboInputEnabled', 0, 30),
+	turboShotCountL1:            yup.number().label('Turbo Shot Count L1').validateRangeWhenValue('TurboInputEnabled', 0, 30),
+	turboShotCountR1:            yup.number().label('Turbo Shot Count R1').validateRangeWhenValue('TurboInputEnabled', 0, 30),
+	turboShotCountL2:            yup.number().label('Turbo Shot Count L2').validateRangeWhenValue('TurboInputEnabled', 0, 30),
+	turboShotCountR2:            yup.number().label('Turbo Shot Count R2').validateRangeWhenValue('TurboInputEnabled', 0, 30),
 	shmupMode:                   yup.number().label('Shmup Mode Enabled').validateRangeWhenValue('TurboInputEnabled', 0, 1),
 	shmupMixMode:                yup.number().label('Shmup Mix Priority').validateSelectionWhenValue('TurboInputEnabled', DUAL_STICK_MODES),
 	shmupAlwaysOn1:              yup.number().label('Turbo-Button 1 (Always On)').validateSelectionWhenValue('TurboInputEnabled', BUTTON_MASKS),
@@ -353,6 +391,14 @@ const defaultValues = {
 	sliderSOCDPinOne: -1,
 	sliderSOCDPinTwo: -1,
 	turboShotCount: 5,
+	turboShotCountB1: 0,
+	turboShotCountB2: 0,
+	turboShotCountB3: 0,
+	turboShotCountB4: 0,
+	turboShotCountL1: 0,
+	turboShotCountR1: 0,
+	turboShotCountL2: 0,
+	turboShotCountR2: 0,
 	reversePin: -1,
 	reversePinLED: -1,
 	i2cAnalog1219SDAPin: -1,
@@ -360,6 +406,7 @@ const defaultValues = {
 	i2cAnalog1219Block: 0,
 	i2cAnalog1219Speed: 400000,
 	i2cAnalog1219Address: 0x40,
+	i2cAnalog1219DRDYPin: -1,
 	onBoardLedMode: 0,
 	dualDirUpPin: -1,
 	dualDirDownPin: -1,
@@ -389,6 +436,25 @@ const defaultValues = {
 	forced_circularity: 0,
 	analog_deadzone: 5,
 	auto_calibrate: 0,
+	radial_deadzone: 0,
+	analogAdc1XMin: 0,
+	analogAdc1XCenter: 0,
+	analogAdc1XMax: 0,
+	analogAdc1YMin: 0,
+	analogAdc1YCenter: 0,
+	analogAdc1YMax: 0,
+	analogAdc2XMin: 0,
+	analogAdc2XCenter: 0,
+	analogAdc2XMax: 0,
+	analogAdc2YMin: 0,
+	analogAdc2YCenter: 0,
+	analogAdc2YMax: 0,
+	analogAdc1Filter: 0,
+	analogAdc2Filter: 0,
+	analogFilterSamples: 4,
+	analogFilterEmaAlpha: 25,
+	analogFilterMinCutoff: 50,
+	analogFilterBeta: 5000,
 	bootselButtonMap: 0,
 	buzzerPin: -1,
 	buzzerVolume: 100,
@@ -425,6 +491,7 @@ const defaultValues = {
 	AnalogInputEnabled: 0,
 	BoardLedAddonEnabled: 0,
 	FocusModeAddonEnabled: 0,
+	MacroInputEnabled: 0,
 	BuzzerSpeakerAddonEnabled: 0,
 	BootselButtonAddonEnabled: 0,
 	DualDirectionalInputEnabled: 0,
@@ -506,6 +573,82 @@ const AvailablePinOptions = ({ pins }) => {
 	);
 };
 
+const ANALOG_CALIBRATION_AXES = ['analogAdc1X', 'analogAdc1Y', 'analogAdc2X', 'analogAdc2Y'];
+
+// Matches ANALOG_CALIBRATION_MIN_SPAN, axes moved less than this keep their stored calibration
+const ANALOG_CALIBRATION_MIN_SPAN = 512;
+
+const AnalogCalibration = ({ values, setFieldValue }) => {
+	const { t } = useTranslation();
+	const [recorded, setRecorded] = useState(null);
+	const recording = recorded !== null;
+
+	useEffect(() => {
+		if (!recording)
+			return;
+
+		const timer = setInterval(async () => {
+			const raw = await WebApi.getAnalogRawValues();
+			if (!raw)
+				return;
+
+			// The first reading of an axis is its center, the stick should rest when recording starts
+			setRecorded((current) => current && ANALOG_CALIBRATION_AXES.reduce((next, axis) => {
+				const value = raw[axis];
+				if (value >= 0) {
+					const seen = current[axis] ?? { min: value, center: value, max: value };
+					next[axis] = { min: Math.min(seen.min, value), center: seen.center, max: Math.max(seen.max, value) };
+				}
+				return next;
+			}, { ...current }));
+		}, 50);
+		return () => clearInterval(timer);
+	}, [recording]);
+
+	const finish = () => {
+		for (const [axis, seen] of Object.entries(recorded)) {
+			if (seen.center - seen.min < ANALOG_CALIBRATION_MIN_SPAN || seen.max - seen.center < ANALOG_CALIBRATION_MIN_SPAN)
+				continue;
+			setFieldValue(`${axis}Min`, seen.min);
+			setFieldValue(`${axis}Center`, seen.center);
+			setFieldValue(`${axis}Max`, seen.max);
+		}
+		setRecorded(null);
+	};
+
+	const clear = () => {
+		for (const axis of ANALOG_CALIBRATION_AXES) {
+			setFieldValue(`${axis}Min`, 0);
+			setFieldValue(`${axis}Center`, 0);
+			setFieldValue(`${axis}Max`, 0);
+		}
+	};
+
+	return (
+		<>
+			<p>{t('AddonsConfig:analog-calibration-text')}</p>
+			{ANALOG_CALIBRATION_AXES.map((axis) => {
+				const seen = recording ? recorded[axis] : { min: values[`${axis}Min`], center: values[`${axis}Center`], max: values[`${axis}Max`] };
+				return (
+					<div key={`analog-calibration-${axis}`}>
+						{t(`AddonsConfig:analog-calibration-${axis}-label`)}: {seen && seen.max > 0
+							? `${seen.min} / ${seen.center} / ${seen.max}`
+							: t('AddonsConfig:analog-calibration-not-set')}
+					</div>
+				);
+			})}
+			<div className="mt-2">
+				{recording
+					? <Button size="sm" onClick={finish}>{t('AddonsConfig:analog-calibration-stop')}</Button>
+					: <Button size="sm" onClick={() => setRecorded({})}>{t('AddonsConfig:analog-calibration-start')}</Button>}
+				<Button size="sm" variant="secondary" className="ms-2" disabled={recording} onClick={clear}>
+					{t('AddonsConfig:analog-calibration-clear')}
+				</Button>
+			</div>
+		</>
+	);
+};
+
 export default function AddonsConfigPage() {
 	const { buttonLabels, updateUsedPins, usedPins } = useContext(AppContext);
 	const [saveMessage, setSaveMessage] = useState('');
@@ -762,6 +905,92 @@ export default function AddonsConfigPage() {
 									checked={Boolean(values.auto_calibrate)}
 									onChange={(e) => {handleCheckbox("auto_calibrate", values); handleChange(e);}}
 								/>
+								<FormCheck
+									label={t('AddonsConfig:analog-radial-deadzone')}
+									type="switch"
+									id="Radial_deadzone"
+									className="col-sm-3 ms-2"
+									isInvalid={false}
+									checked={Boolean(values.radial_deadzone)}
+									onChange={(e) => {handleCheckbox("radial_deadzone", values); handleChange(e);}}
+								/>
+							</Row>
+							<Row className="mb-3">
+								<FormSelect
+									label={t('AddonsConfig:analog-adc-1-filter-label')}
+									name="analogAdc1Filter"
+									className="form-select-sm"
+									groupClassName="col-sm-3 mb-3"
+									value={values.analogAdc1Filter}
+									error={errors.analogAdc1Filter}
+									isInvalid={errors.analogAdc1Filter}
+									onChange={handleChange}
+								>
+									{ANALOG_FILTERS.map((o, i) => <option key={`button-analogAdc1Filter-option-${i}`} value={o.value}>{o.label}</option>)}
+								</FormSelect>
+								<FormSelect
+									label={t('AddonsConfig:analog-adc-2-filter-label')}
+									name="analogAdc2Filter"
+									className="form-select-sm"
+									groupClassName="col-sm-3 mb-3"
+									value={values.analogAdc2Filter}
+									error={errors.analogAdc2Filter}
+									isInvalid={errors.analogAdc2Filter}
+									onChange={handleChange}
+								>
+									{ANALOG_FILTERS.map((o, i) => <option key={`button-analogAdc2Filter-option-${i}`} value={o.value}>{o.label}</option>)}
+								</FormSelect>
+								<FormControl type="number"
+									label={t('AddonsConfig:analog-filter-samples-label')}
+									name="analogFilterSamples"
+									className="form-control-sm"
+									groupClassName="col-sm-3 mb-3"
+									value={values.analogFilterSamples}
+									error={errors.analogFilterSamples}
+									isInvalid={errors.analogFilterSamples}
+									onChange={handleChange}
+									min={1}
+									max={8}
+								/>
+								<FormControl type="number"
+									label={t('AddonsConfig:analog-filter-ema-alpha-label')}
+									name="analogFilterEmaAlpha"
+									className="form-control-sm"
+									groupClassName="col-sm-3 mb-3"
+									value={values.analogFilterEmaAlpha}
+									error={errors.analogFilterEmaAlpha}
+									isInvalid={errors.analogFilterEmaAlpha}
+									onChange={handleChange}
+									min={1}
+									max={100}
+								/>
+								<FormControl type="number"
+									label={t('AddonsConfig:analog-filter-min-cutoff-label')}
+									name="analogFilterMinCutoff"
+									className="form-control-sm"
+									groupClassName="col-sm-3 mb-3"
+									value={values.analogFilterMinCutoff}
+									error={errors.analogFilterMinCutoff}
+									isInvalid={errors.analogFilterMinCutoff}
+									onChange={handleChange}
+									min={1}
+									max={10000}
+								/>
+								<FormControl type="number"
+									label={t('AddonsConfig:analog-filter-beta-label')}
+									name="analogFilterBeta"
+									className="form-control-sm"
+									groupClassName="col-sm-3 mb-3"
+									value={values.analogFilterBeta}
+									error={errors.analogFilterBeta}
+									isInvalid={errors.analogFilterBeta}
+									onChange={handleChange}
+									min={0}
+									max={100000}
+								/>
+							</Row>
+							<Row className="mb-3">
+								<AnalogCalibration values={values} setFieldValue={setFieldValue} />
 							</Row>
 						</div>
 						<FormCheck
@@ -827,6 +1056,21 @@ export default function AddonsConfigPage() {
 								>
 									<AvailablePinOptions pins={ANALOG_PINS}/>
 								</FormSelect>
+								{TURBO_SHOT_COUNT_BUTTONS.map((button) => (
+									<FormControl type="number"
+										key={`turboShotCount${button}`}
+										label={t('AddonsConfig:turbo-button-shot-count-label', { button })}
+										name={`turboShotCount${button}`}
+										className="form-control-sm"
+										groupClassName="col-sm-3 mb-3"
+										value={values[`turboShotCount${button}`]}
+										error={errors[`turboShotCount${button}`]}
+										isInvalid={errors[`turboShotCount${button}`]}
+										onChange={handleChange}
+										min={0}
+										max={30}
+									/>
+								))}
 								<FormCheck
 									label={t('AddonsConfig:turbo-shmup-mode-label')}
 									type="switch"
@@ -1211,6 +1455,18 @@ export default function AddonsConfigPage() {
 									onChange={handleChange}
 									maxLength={4}
 								/>
+								<FormControl type="number"
+									label={t('AddonsConfig:i2c-analog-ads1219-drdy-pin-label')}
+									name="i2cAnalog1219DRDYPin"
+									className="form-control-sm"
+									groupClassName="col-sm-3 mb-3"
+									value={values.i2cAnalog1219DRDYPin}
+									error={errors.i2cAnalog1219DRDYPin}
+									isInvalid={errors.i2cAnalog1219DRDYPin}
+									onChange={handleChange}
+									min={-1}
+									max={29}
+								/>
 							</Row>
 						</div>
 						<FormCheck
@@ -1936,6 +2192,22 @@ export default function AddonsConfigPage() {
 							onChange={(e) => { handleCheckbox("FocusModeAddonEnabled", values); handleChange(e);}}
 						/>
 					</Section>
+					<Section title={t('AddonsConfig:macro-header-text')}>
+						<div
+							id="MacroInputOptions"
+							hidden={!values.MacroInputEnabled}>
+							<p>{t('AddonsConfig:macro-sub-header-text')}</p>
+						</div>
+						<FormCheck
+							label={t('Common:switch-enabled')}
+							type="switch"
+							id="MacroInputButton"
+							reverse
+							isInvalid={false}
+							checked={Boolean(values.MacroInputEnabled)}
+							onChange={(e) => { handleCheckbox("MacroInputEnabled", values); handleChange(e);}}
+						/>
+					</Section>
 				{/*
 					<Section title={t('AddonsConfig:keyboard-host-header-text')}>
 						<div
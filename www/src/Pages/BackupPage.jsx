@@ -16,6 +16,7 @@ const API_BINDING = {
 	"ledTheme":    {label: "Custom LED Theme", get: WebApi.getCustomTheme,    set: WebApi.setCustomTheme},
 	"pinmappings": {label: "Pin Mappings", get: WebApi.getPinMappings,    set: WebApi.setPinMappings},
 	"addons":      {label: "Add-Ons",      get: WebApi.getAddonsOptions,  set: WebApi.setAddonsOptions},
+	"macros":      {label: "Macros",       get: WebApi.getMacroOptions,   set: WebApi.setMacroOptions},
 	// new api, add it here
 	// "example":	{label: "Example",		get: WebApi.getNewAPI,			set: WebApi.setNewAPI},
 };
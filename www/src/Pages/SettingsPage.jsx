@@ -49,6 +49,13 @@ const HOTKEY_ACTIONS = [
 	{ labelKey: 'hotkey-actions.invert-y', value: 10 },
 	{ labelKey: 'hotkey-actions.toggle-4way-joystick-mode', value: 13 },
 	{ labelKey: 'hotkey-actions.toggle-ddi-4way-joystick-mode', value: 14 },
+	{ labelKey: 'hotkey-actions.analog-calibration', value: 15 },
+];
+
+const DEBOUNCE_MODES = [
+	{ labelKey: 'debounce-mode-options.timed', value: 0 },
+	{ labelKey: 'debounce-mode-options.integrator', value: 1 },
+	{ labelKey: 'debounce-mode-options.eager', value: 2 },
 ];
 
 const FORCED_SETUP_MODES = [
@@ -80,6 +87,14 @@ const schema = yup.object().shape({
 	forcedSetupMode : yup.number().required().oneOf(FORCED_SETUP_MODES.map(o => o.value)).label('SOCD Cleaning Mode'),
 	lockHotkeys: yup.number().required().label('Lock Hotkeys'),
 	fourWayMode: yup.number().required().label('4-Way Joystick Mode'),
+	usbFrameSync: yup.number().required().label('USB Frame Sync'),
+	pioSampler: yup.number().required().label('PIO Input Sampler'),
+	debounceMode: yup.number().required().oneOf(DEBOUNCE_MODES.map(o => o.value)).label('Debounce Mode'),
+	debounceSamples: yup.number().required().min(1).max(15).label('Debounce Samples'),
+	debounceLockoutMicros: yup.number().required().min(0).max(20000).label('Debounce Lockout'),
+	inputRecording: yup.number().required().label('Input Recording'),
+	adcSampler: yup.number().required().label('ADC Sampler'),
+	adcAverageSamples: yup.number().required().min(1).max(8).label('ADC Average Samples'),
 });
 
 const FormContext = ({ setButtonLabels }) => {
@@ -110,6 +125,22 @@ const FormContext = ({ setButtonLabels }) => {
 			values.lockHotkeys = parseInt(values.lockHotkeys);
 		if (!!values.fourWayMode)
 			values.fourWayMode = parseInt(values.fourWayMode);
+		if (!!values.usbFrameSync)
+			values.usbFrameSync = parseInt(values.usbFrameSync);
+		if (!!values.pioSampler)
+			values.pioSampler = parseInt(values.pioSampler);
+		if (!!values.debounceMode)
+			values.debounceMode = parseInt(values.debounceMode);
+		if (!!values.debounceSamples)
+			values.debounceSamples = parseInt(values.debounceSamples);
+		if (!!values.debounceLockoutMicros)
+			values.debounceLockoutMicros = parseInt(values.debounceLockoutMicros);
+		if (!!values.inputRecording)
+			values.inputRecording = parseInt(values.inputRecording);
+		if (!!values.adcSampler)
+			values.adcSampler = parseInt(values.adcSampler);
+		if (!!values.adcAverageSamples)
+			values.adcAverageSamples = parseInt(values.adcAverageSamples);
 
 		setButtonLabels({ swapTpShareLabels: (values.switchTpShareForDs4 === 1) && (values.inputMode === 4) });
 
@@ -174,6 +205,7 @@ export default function SettingsPage() {
 	const translatedSocdModes = translateArray(SOCD_MODES);
 	const translatedHotkeyActions = translateArray(HOTKEY_ACTIONS);
 	const translatedForcedSetupModes = translateArray(FORCED_SETUP_MODES);
+	const translatedDebounceModes = translateArray(DEBOUNCE_MODES);
 
 	return (
 		<Formik validationSchema={schema} onSubmit={onSuccess} initialValues={{}}>
@@ -234,6 +266,25 @@ export default function SettingsPage() {
 								<Form.Control.Feedback type="invalid">{errors.forcedSetupMode}</Form.Control.Feedback>
 							</div>
 						</Form.Group>
+						<Form.Group className="row mb-3">
+							<Form.Label>{t('SettingsPage:debounce-mode-label')}</Form.Label>
+							<div className="col-sm-3">
+								<Form.Select name="debounceMode" className="form-select-sm" value={values.debounceMode} onChange={handleChange} isInvalid={errors.debounceMode}>
+									{translatedDebounceModes.map((o, i) => <option key={`button-debounceMode-option-${i}`} value={o.value}>{o.label}</option>)}
+								</Form.Select>
+								<Form.Control.Feedback type="invalid">{errors.debounceMode}</Form.Control.Feedback>
+							</div>
+							{values.debounceMode === 1 && <div className="col-sm-3">
+								<Form.Control type="number" name="debounceSamples" className="form-control-sm" value={values.debounceSamples} onChange={handleChange} isInvalid={errors.debounceSamples} min={1} max={15} />
+								<Form.Control.Feedback type="invalid">{errors.debounceSamples}</Form.Control.Feedback>
+								<Form.Text>{t('SettingsPage:debounce-samples-label')}</Form.Text>
+							</div>}
+							{values.debounceMode === 2 && <div className="col-sm-3">
+								<Form.Control type="number" name="debounceLockoutMicros" className="form-control-sm" value={values.debounceLockoutMicros} onChange={handleChange} isInvalid={errors.debounceLockoutMicros} min={0} max={20000} />
+								<Form.Control.Feedback type="invalid">{errors.debounceLockoutMicros}</Form.Control.Feedback>
+								<Form.Text>{t('SettingsPage:debounce-lockout-label')}</Form.Text>
+							</div>}
+						</Form.Group>
 						<Form.Check
 							label={t('SettingsPage:4-way-joystick-mode-label')}
 							type="switch"
@@ -242,6 +293,47 @@ export default function SettingsPage() {
 							checked={Boolean(values.fourWayMode)}
 							onChange={(e) => { setFieldValue("fourWayMode", e.target.checked ? 1 : 0); }}
 						/>
+						<Form.Check
+							label={t('SettingsPage:usb-frame-sync-label')}
+							type="switch"
+							id="usbFrameSync"
+							isInvalid={false}
+							checked={Boolean(values.usbFrameSync)}
+							onChange={(e) => { setFieldValue("usbFrameSync", e.target.checked ? 1 : 0); }}
+						/>
+						<Form.Check
+							label={t('SettingsPage:pio-sampler-label')}
+							type="switch"
+							id="pioSampler"
+							isInvalid={false}
+							checked={Boolean(values.pioSampler)}
+							onChange={(e) => { setFieldValue("pioSampler", e.target.checked ? 1 : 0); }}
+						/>
+						<Form.Check
+							label={t('SettingsPage:input-recording-label')}
+							type="switch"
+							id="inputRecording"
+							isInvalid={false}
+							checked={Boolean(values.inputRecording)}
+							onChange={(e) => { setFieldValue("inputRecording", e.target.checked ? 1 : 0); }}
+						/>
+						<Form.Group className="row mb-3">
+							<div className="col-sm-3">
+								<Form.Check
+									label={t('SettingsPage:adc-sampler-label')}
+									type="switch"
+									id="adcSampler"
+									isInvalid={false}
+									checked={Boolean(values.adcSampler)}
+									onChange={(e) => { setFieldValue("adcSampler", e.target.checked ? 1 : 0); }}
+								/>
+							</div>
+							{!!values.adcSampler && <div className="col-sm-3">
+								<Form.Control type="number" name="adcAverageSamples" className="form-control-sm" value={values.adcAverageSamples} onChange={handleChange} isInvalid={errors.adcAverageSamples} min={1} max={8} />
+								<Form.Control.Feedback type="invalid">{errors.adcAverageSamples}</Form.Control.Feedback>
+								<Form.Text>{t('SettingsPage:adc-average-samples-label')}</Form.Text>
+							</div>}
+						</Form.Group>
 					</Section>
 					<Section title={t('SettingsPage:hotkey-settings-label')}>
 						<div className="mb-3">
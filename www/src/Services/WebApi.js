@@ -305,6 +305,31 @@ async function setAddonsOptions(options) {
 		});
 }
 
+async function getMacroOptions(setLoading) {
+	setLoading(true);
+
+	try {
+		const response = await axios.get(`${baseUrl}/api/getMacroOptions`)
+		setLoading(false);
+		return response.data;
+	} catch (error) {
+		setLoading(false);
+		console.error(error);
+	}
+}
+
+async function setMacroOptions(options) {
+	return axios.post(`${baseUrl}/api/setMacroOptions`, sanitizeRequest(options))
+		.then((response) => {
+			console.log(response.data);
+			return true;
+		})
+		.catch((err) => {
+			console.error(err);
+			return false;
+		});
+}
+
 async function setPS4Options(options) {
 	return axios.post(`${baseUrl}/api/setPS4Options`, options)
 		.then((response) => {
@@ -344,6 +369,15 @@ async function getMemoryReport(setLoading) {
 }
 
 
+async function getAnalogRawValues() {
+	try {
+		const response = await axios.get(`${baseUrl}/api/getAnalogRawValues`)
+		return response.data;
+	} catch (error) {
+		console.error(error);
+	}
+}
+
 async function getUsedPins(setLoading) {
 	setLoading(true);
 
@@ -389,6 +423,9 @@ const WebApi = {
 	setKeyMappings,
 	getAddonsOptions,
 	setAddonsOptions,
+	getMacroOptions,
+	setMacroOptions,
+	getAnalogRawValues,
 	setPS4Options,
 	getSplashImage,
 	setSplashImage,